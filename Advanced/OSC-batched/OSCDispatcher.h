@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "OSCMessageView.h"
+
+/**
+ * calls handlers by OSC address. addresses are looked up in a hash table, so the cost of
+ * dispatching a message does not grow with the number of handlers ( unlike a chain of
+ * listeners that each compare the address ). several handlers may share an address; a
+ * handler may be restricted to messages with certain type tags.
+ *
+ * incoming addresses that contain OSC pattern characters ( `?`, `*`, `[]`, `{}` ) are matched
+ * against all registered addresses. messages without a handler go to the fallback handler.
+ *
+ * NOTE not thread-safe. add handlers before dispatching.
+ */
+class OSCDispatcher {
+public:
+    using Handler = std::function<void(const OSCMessageView&)>;
+
+    /* `typetags` restricts the handler to messages with exactly these type tags, e.g. `iff`. empty accepts all */
+    void add(const std::string& address, const Handler& handler, const std::string& typetags = "") {
+        const size_t index = fEntries.size();
+        fEntries.push_back({address, typetags, handler});
+        fTable[hash(address)].push_back(index);
+    }
+
+    void set_fallback(const Handler& handler) { fFallback = handler; }
+
+    /* returns the number of handlers that were called */
+    size_t dispatch(const OSCMessageView& message) const {
+        const std::string_view address = message.address();
+        size_t                 called  = 0;
+        if (address.find_first_of("?*[{") == std::string_view::npos) {
+            const auto bucket = fTable.find(hash(address));
+            if (bucket != fTable.end()) {
+                for (const size_t index: bucket->second) {
+                    called += call(fEntries[index], message, fEntries[index].address == address);
+                }
+            }
+        } else {
+            for (const auto& entry: fEntries) {
+                called += call(entry, message, match(address, entry.address));
+            }
+        }
+        if (called == 0 && fFallback) {
+            fFallback(message);
+        }
+        return called;
+    }
+
+    size_t get_number_of_handlers() const { return fEntries.size(); }
+
+    /* matches an OSC address pattern against an address, part by part */
+    static bool match(const std::string_view pattern, const std::string_view address) {
+        size_t p = 0;
+        size_t a = 0;
+        while (p < pattern.size() && a < address.size()) {
+            const char c = pattern[p];
+            if (c == '*') {
+                /* `*` matches any sequence of characters within one part of the address */
+                const std::string_view rest = pattern.substr(p + 1);
+                for (size_t end = a; end <= address.size(); ++end) {
+                    if (match(rest, address.substr(end))) {
+                        return true;
+                    }
+                    if (end < address.size() && address[end] == '/') {
+                        break;
+                    }
+                }
+                return false;
+            }
+            if (c == '?') {
+                if (address[a] == '/') {
+                    return false;
+                }
+            } else if (c == '[') {
+                const size_t close = pattern.find(']', p);
+                if (close == std::string_view::npos || !match_set(pattern.substr(p + 1, close - p - 1), address[a])) {
+                    return false;
+                }
+                p = close;
+            } else if (c == '{') {
+                const size_t close = pattern.find('}', p);
+                if (close == std::string_view::npos) {
+                    return false;
+                }
+                const std::string_view rest         = pattern.substr(close + 1);
+                std::string_view       alternatives = pattern.substr(p + 1, close - p - 1);
+                while (true) {
+                    const size_t           comma       = alternatives.find(',');
+                    const std::string_view alternative = alternatives.substr(0, comma);
+                    if (address.substr(a, alternative.size()) == alternative && match(rest, address.substr(a + alternative.size()))) {
+                        return true;
+                    }
+                    if (comma == std::string_view::npos) {
+                        return false;
+                    }
+                    alternatives.remove_prefix(comma + 1);
+                }
+            } else if (c != address[a]) {
+                return false;
+            }
+            ++p;
+            ++a;
+        }
+        /* a trailing `*` also matches an empty rest */
+        while (p < pattern.size() && pattern[p] == '*') {
+            ++p;
+        }
+        return p == pattern.size() && a == address.size();
+    }
+
+private:
+    struct Entry {
+        std::string address;
+        std::string typetags;
+        Handler     handler;
+    };
+
+    std::vector<Entry>                                fEntries;
+    std::unordered_map<uint64_t, std::vector<size_t>> fTable;
+    Handler                                           fFallback;
+
+    static size_t call(const Entry& entry, const OSCMessageView& message, const bool matches) {
+        if (!matches || (!entry.typetags.empty() && !message.has_typetags(entry.typetags))) {
+            return 0;
+        }
+        entry.handler(message);
+        return 1;
+    }
+
+    /* `[abc]`, `[a-z]` and `[!a-z]` */
+    static bool match_set(std::string_view set, const char c) {
+        const bool negate = !set.empty() && set[0] == '!';
+        if (negate) {
+            set.remove_prefix(1);
+        }
+        bool found = false;
+        for (size_t i = 0; i < set.size(); ++i) {
+            if (i + 2 < set.size() && set[i + 1] == '-') {
+                found |= c >= set[i] && c <= set[i + 2];
+                i += 2;
+            } else {
+                found |= c == set[i];
+            }
+        }
+        return found != negate;
+    }
+
+    /* 64 bit FNV-1a */
+    static uint64_t hash(const std::string_view text) {
+        uint64_t h = 0xcbf29ce484222325ull;
+        for (const char c: text) {
+            h = (h ^ static_cast<uint8_t>(c)) * 0x100000001b3ull;
+        }
+        return h;
+    }
+};
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+/**
+ * read-only view of an OSC message inside a received packet. parsing does not copy or
+ * allocate: the address, the type tags, strings and blobs point into the packet, which
+ * must stay valid while the view is used ( see `OSCReceiver` ). the offsets of the arguments
+ * are computed once while parsing, so accessing an argument is O(1).
+ *
+ * numeric getters convert between `i`, `h`, `f` and `d`. getters return 0 or an empty
+ * string if the argument does not exist or has an incompatible type.
+ */
+class OSCMessageView {
+public:
+    static constexpr size_t   MAX_ARGUMENTS     = 16;
+    static constexpr uint64_t TIMETAG_IMMEDIATE = 1;
+
+    std::string_view address() const { return {fAddress, fAddressLength}; }
+
+    /* type tags without the leading `,` e.g. `ifs` */
+    std::string_view typetags() const { return {fTypetags, fArgumentCount}; }
+
+    size_t size() const { return fArgumentCount; }
+
+    char type(const size_t index) const { return index < fArgumentCount ? fTypetags[index] : '\0'; }
+
+    /* NTP time tag of the enclosing bundle ( 32 bit seconds since 1900 and 32 bit fraction ) or `TIMETAG_IMMEDIATE` */
+    uint64_t timetag() const { return fTimetag; }
+
+    bool has_typetags(const std::string_view typetags) const { return this->typetags() == typetags; }
+
+    int32_t get_int(const size_t index) const {
+        switch (type(index)) {
+            case 'i': return static_cast<int32_t>(read_u32(argument(index)));
+            case 'h': return static_cast<int32_t>(read_u64(argument(index)));
+            case 'f': return static_cast<int32_t>(get_float(index));
+            case 'd': return static_cast<int32_t>(get_double(index));
+            default: return 0;
+        }
+    }
+
+    int64_t get_long(const size_t index) const {
+        return type(index) == 'h' ? static_cast<int64_t>(read_u64(argument(index))) : get_int(index);
+    }
+
+    float get_float(const size_t index) const {
+        switch (type(index)) {
+            case 'f': {
+                const uint32_t bits = read_u32(argument(index));
+                float          value;
+                std::memcpy(&value, &bits, sizeof(value));
+                return value;
+            }
+            case 'd': return static_cast<float>(get_double(index));
+            case 'i':
+            case 'h': return static_cast<float>(get_long(index));
+            default: return 0.0f;
+        }
+    }
+
+    double get_double(const size_t index) const {
+        if (type(index) != 'd') {
+            return get_float(index);
+        }
+        const uint64_t bits = read_u64(argument(index));
+        double         value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    /* `s` and `S` arguments. the view points into the packet */
+    std::string_view get_string(const size_t index) const {
+        const char t = type(index);
+        if (t != 's' && t != 'S') {
+            return {};
+        }
+        return {reinterpret_cast<const char*>(argument(index)), fStringLengths[index]};
+    }
+
+    /* `b` arguments. returns the size and sets `data` to the bytes inside the packet */
+    size_t get_blob(const size_t index, const uint8_t*& data) const {
+        if (type(index) != 'b') {
+            data = nullptr;
+            return 0;
+        }
+        data = argument(index) + 4;
+        return read_u32(argument(index));
+    }
+
+    bool get_bool(const size_t index) const { return type(index) == 'T' || get_int(index) != 0; }
+
+    /**
+     * parses an OSC packet ( a message or a bundle with nested bundles ) and calls
+     * `on_message(const OSCMessageView&)` for every message. returns false if the packet is
+     * malformed, messages before the malformed part have been delivered.
+     */
+    template<typename F>
+    static bool parse(const char* data, const size_t size, F&& on_message) { return parse(data, size, TIMETAG_IMMEDIATE, 0, on_message); }
+
+private:
+    static constexpr int MAX_BUNDLE_DEPTH = 8;
+
+    const char*    fAddress{nullptr};
+    const char*    fTypetags{nullptr};
+    const uint8_t* fArguments{nullptr};
+    uint64_t       fTimetag{TIMETAG_IMMEDIATE};
+    uint32_t       fOffsets[MAX_ARGUMENTS]{};
+    uint32_t       fStringLengths[MAX_ARGUMENTS]{};
+    uint32_t       fAddressLength{0};
+    uint32_t       fArgumentCount{0};
+
+    const uint8_t* argument(const size_t index) const { return fArguments + fOffsets[index]; }
+
+    static uint32_t read_u32(const uint8_t* p) {
+        return static_cast<uint32_t>(p[0]) << 24 | static_cast<uint32_t>(p[1]) << 16 | static_cast<uint32_t>(p[2]) << 8 | static_cast<uint32_t>(p[3]);
+    }
+
+    static uint64_t read_u64(const uint8_t* p) { return static_cast<uint64_t>(read_u32(p)) << 32 | read_u32(p + 4); }
+
+    static size_t padded(const size_t size) { return (size + 3) & ~size_t{3}; }
+
+    /* length of the zero terminated string at `data` or `SIZE_MAX` if it is not terminated within `size` bytes */
+    static size_t string_length(const char* data, const size_t size) {
+        const void* end = std::memchr(data, '\0', size);
+        return end == nullptr ? SIZE_MAX : static_cast<size_t>(static_cast<const char*>(end) - data);
+    }
+
+    template<typename F>
+    static bool parse(const char* data, const size_t size, const uint64_t timetag, const int depth, F& on_message) {
+        if (size >= 16 && std::memcmp(data, "#bundle", 8) == 0) {
+            if (depth >= MAX_BUNDLE_DEPTH) {
+                return false;
+            }
+            const uint64_t bundle_timetag = read_u64(reinterpret_cast<const uint8_t*>(data + 8));
+            size_t         position       = 16;
+            while (position + 4 <= size) {
+                const size_t element_size = read_u32(reinterpret_cast<const uint8_t*>(data + position));
+                position += 4;
+                if (element_size > size - position || !parse(data + position, element_size, bundle_timetag, depth + 1, on_message)) {
+                    return false;
+                }
+                position += element_size;
+            }
+            return position == size;
+        }
+        OSCMessageView message;
+        if (!message.parse_message(data, size, timetag)) {
+            return false;
+        }
+        on_message(static_cast<const OSCMessageView&>(message));
+        return true;
+    }
+
+    bool parse_message(const char* data, const size_t size, const uint64_t timetag) {
+        if (size < 4 || data[0] != '/') {
+            return false;
+        }
+        const size_t address_length = string_length(data, size);
+        if (address_length == SIZE_MAX) {
+            return false;
+        }
+        fAddress       = data;
+        fAddressLength = static_cast<uint32_t>(address_length);
+        fTimetag       = timetag;
+
+        /* messages without type tags are allowed and have no arguments */
+        size_t position = padded(address_length + 1);
+        if (position > size) {
+            return false;
+        }
+        if (position == size) {
+            fTypetags      = "";
+            fArgumentCount = 0;
+            return true;
+        }
+        if (data[position] != ',') {
+            return false;
+        }
+        const size_t typetag_length = string_length(data + position, size - position);
+        if (typetag_length == SIZE_MAX || typetag_length - 1 > MAX_ARGUMENTS) {
+            return false;
+        }
+        fTypetags      = data + position + 1;
+        fArgumentCount = static_cast<uint32_t>(typetag_length - 1);
+        position += padded(typetag_length + 1);
+        if (position > size) {
+            return false;
+        }
+        fArguments = reinterpret_cast<const uint8_t*>(data + position);
+
+        /* every argument including its padding must end within the packet, i.e. `offset <= arguments_size` */
+        const size_t arguments_size = size - position;
+        size_t       offset         = 0;
+        for (uint32_t i = 0; i < fArgumentCount; ++i) {
+            fOffsets[i]      = static_cast<uint32_t>(offset);
+            const uint8_t* p = fArguments + offset;
+            switch (fTypetags[i]) {
+                case 'i':
+                case 'f':
+                case 'c':
+                case 'r':
+                case 'm':
+                    if (offset + 4 > arguments_size) {
+                        return false;
+                    }
+                    offset += 4;
+                    break;
+                case 'h':
+                case 'd':
+                case 't':
+                    if (offset + 8 > arguments_size) {
+                        return false;
+                    }
+                    offset += 8;
+                    break;
+                case 's':
+                case 'S': {
+                    const size_t length = string_length(reinterpret_cast<const char*>(p), arguments_size - offset);
+                    if (length == SIZE_MAX || offset + padded(length + 1) > arguments_size) {
+                        return false;
+                    }
+                    fStringLengths[i] = static_cast<uint32_t>(length);
+                    offset += padded(length + 1);
+                    break;
+                }
+                case 'b': {
+                    if (offset + 4 > arguments_size) {
+                        return false;
+                    }
+                    const size_t blob_size = read_u32(p);
+                    if (blob_size > arguments_size - offset - 4 || offset + 4 + padded(blob_size) > arguments_size) {
+                        return false;
+                    }
+                    offset += 4 + padded(blob_size);
+                    break;
+                }
+                case 'T':
+                case 'F':
+                case 'N':
+                case 'I':
+                    break;
+                default:
+                    return false;
+            }
+        }
+        return true;
+    }
+};
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#include "OSCMessageView.h"
+
+/**
+ * receives OSC packets on a UDP port in a background thread and delivers them in batches.
+ *
+ * the receiver thread reads up to `batch_datagrams` datagrams per system call ( `recvmmsg` on
+ * linux, `recvfrom` elsewhere ), copies them into a preallocated arena and parses them into
+ * `OSCMessageView`s that point into the arena. nothing is allocated while receiving. `poll()`
+ * ( usually called once per frame from `update()` or `draw()` ) swaps the arena with a second
+ * one and calls a function for every message received since the last call. the lock is only
+ * held while a batch of datagrams is appended and while the arenas are swapped, never while
+ * messages are handled.
+ *
+ * if the arena is full ( e.g. because `poll()` is not called often enough ) datagrams are
+ * dropped and counted. messages of a bundle that exceed `max_messages` are counted as
+ * well. bundles are unpacked, their messages carry the time tag of the bundle.
+ *
+ * NOTE the views delivered by `poll()` are only valid during the call.
+ * NOTE receiving is not implemented on windows.
+ */
+class OSCReceiver {
+public:
+    struct Settings {
+        size_t arena_bytes     = 4 * 1024 * 1024;
+        size_t max_messages    = 65536;
+        size_t batch_datagrams = 32;
+        size_t max_datagram    = 8192; // larger datagrams are dropped as malformed
+        int    socket_buffer   = 4 * 1024 * 1024;
+    };
+
+    struct Statistics {
+        uint64_t datagrams{0};
+        uint64_t messages{0};
+        uint64_t receive_calls{0};
+        uint64_t malformed{0};
+        uint64_t dropped{0}; // datagrams and bundled messages that did not fit into the arena
+    };
+
+    explicit OSCReceiver(const uint16_t port) : OSCReceiver(port, Settings{}) {}
+
+    OSCReceiver(const uint16_t port, const Settings& settings) : fPort(port), fSettings(settings) {
+        fSettings.batch_datagrams = std::max<size_t>(fSettings.batch_datagrams, 1);
+        for (auto& arena: fArenas) {
+            arena.bytes.resize(fSettings.arena_bytes);
+            arena.messages.resize(fSettings.max_messages);
+        }
+        fScratch.resize(fSettings.batch_datagrams * fSettings.max_datagram);
+        fSizes.resize(fSettings.batch_datagrams);
+    }
+
+    ~OSCReceiver() { stop(); }
+
+    OSCReceiver(const OSCReceiver&)            = delete;
+    OSCReceiver& operator=(const OSCReceiver&) = delete;
+
+    /* opens the socket and starts the receiver thread. returns false if the port can not be bound */
+    bool start() {
+        stop();
+#if !defined(_WIN32)
+        fSocket = socket(AF_INET, SOCK_DGRAM, 0);
+        if (fSocket < 0) {
+            return false;
+        }
+        setsockopt(fSocket, SOL_SOCKET, SO_RCVBUF, &fSettings.socket_buffer, sizeof(fSettings.socket_buffer));
+        /* wake up regularly so that `stop()` does not wait for the next packet */
+        timeval timeout{0, 100000};
+        setsockopt(fSocket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        sockaddr_in address{};
+        address.sin_family      = AF_INET;
+        address.sin_port        = htons(fPort);
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        if (bind(fSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            close(fSocket);
+            fSocket = -1;
+            return false;
+        }
+        fRunning.store(true);
+        fThread = std::thread(&OSCReceiver::receive_loop, this);
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void stop() {
+        fRunning.store(false);
+        if (fThread.joinable()) {
+            fThread.join();
+        }
+#if !defined(_WIN32)
+        if (fSocket >= 0) {
+            close(fSocket);
+            fSocket = -1;
+        }
+#endif
+    }
+
+    /* calls `on_message(const OSCMessageView&)` for every message received since the last call. returns the number of messages */
+    template<typename F>
+    size_t poll(F&& on_message) {
+        Arena* arena;
+        {
+            std::lock_guard<std::mutex> lock(fMutex);
+            arena       = fWriteArena;
+            fWriteArena = arena == &fArenas[0] ? &fArenas[1] : &fArenas[0];
+        }
+        for (size_t i = 0; i < arena->message_count; ++i) {
+            on_message(static_cast<const OSCMessageView&>(arena->messages[i]));
+        }
+        const size_t count   = arena->message_count;
+        arena->message_count = 0;
+        arena->used          = 0;
+        return count;
+    }
+
+    Statistics get_statistics() const {
+        Statistics statistics;
+        statistics.datagrams     = fDatagrams.load(std::memory_order_relaxed);
+        statistics.messages      = fMessages.load(std::memory_order_relaxed);
+        statistics.receive_calls = fReceiveCalls.load(std::memory_order_relaxed);
+        statistics.malformed     = fMalformed.load(std::memory_order_relaxed);
+        statistics.dropped       = fDropped.load(std::memory_order_relaxed);
+        return statistics;
+    }
+
+    uint16_t get_port() const { return fPort; }
+
+private:
+    struct Arena {
+        std::vector<char>           bytes;
+        std::vector<OSCMessageView> messages;
+        size_t                      used{0};
+        size_t                      message_count{0};
+    };
+
+    const uint16_t        fPort;
+    Settings              fSettings;
+    Arena                 fArenas[2];
+    Arena*                fWriteArena{&fArenas[0]};
+    std::mutex            fMutex;
+    std::thread           fThread;
+    std::atomic<bool>     fRunning{false};
+    std::atomic<uint64_t> fDatagrams{0};
+    std::atomic<uint64_t> fMessages{0};
+    std::atomic<uint64_t> fReceiveCalls{0};
+    std::atomic<uint64_t> fMalformed{0};
+    std::atomic<uint64_t> fDropped{0};
+    int                   fSocket{-1};
+    /* receiver thread only */
+    std::vector<char>     fScratch;
+    std::vector<size_t>   fSizes;
+
+#if !defined(_WIN32)
+    /* receives up to `batch_datagrams` datagrams into the scratch buffer. returns the number of datagrams */
+    size_t receive_batch() {
+#if defined(__linux__)
+        mmsghdr      messages[64];
+        iovec        vectors[64];
+        const size_t batch = std::min<size_t>(fSettings.batch_datagrams, 64);
+        for (size_t i = 0; i < batch; ++i) {
+            vectors[i]                     = {fScratch.data() + i * fSettings.max_datagram, fSettings.max_datagram};
+            messages[i]                    = {};
+            messages[i].msg_hdr.msg_iov    = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        /* blocks for the first datagram ( or the timeout ) and then takes whatever else is queued */
+        const int received = recvmmsg(fSocket, messages, static_cast<unsigned>(batch), MSG_WAITFORONE, nullptr);
+        if (received <= 0) {
+            return 0;
+        }
+        for (int i = 0; i < received; ++i) {
+            fSizes[i] = (messages[i].msg_hdr.msg_flags & MSG_TRUNC) ? SIZE_MAX : messages[i].msg_len;
+        }
+        return static_cast<size_t>(received);
+#else
+        size_t received = 0;
+        while (received < fSettings.batch_datagrams) {
+            /* only the first call blocks */
+            const ssize_t n = recvfrom(fSocket, fScratch.data() + received * fSettings.max_datagram, fSettings.max_datagram,
+                                       received == 0 ? 0 : MSG_DONTWAIT, nullptr, nullptr);
+            if (n < 0) {
+                break;
+            }
+            /* NOTE without `recvmmsg` truncation is not reported, a datagram that fills the whole buffer is treated as truncated */
+            fSizes[received++] = static_cast<size_t>(n) >= fSettings.max_datagram ? SIZE_MAX : static_cast<size_t>(n);
+        }
+        return received;
+#endif
+    }
+
+    void receive_loop() {
+        while (fRunning.load()) {
+            const size_t received = receive_batch();
+            if (received == 0) {
+                continue;
+            }
+            fReceiveCalls.fetch_add(1, std::memory_order_relaxed);
+            fDatagrams.fetch_add(received, std::memory_order_relaxed);
+
+            std::lock_guard<std::mutex> lock(fMutex);
+            Arena&                      arena = *fWriteArena;
+            for (size_t i = 0; i < received; ++i) {
+                const size_t size = fSizes[i];
+                if (size == SIZE_MAX || size > fSettings.max_datagram) {
+                    fMalformed.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+                if (arena.used + size > arena.bytes.size() || arena.message_count == arena.messages.size()) {
+                    fDropped.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+                /* copied from the receive buffer into the arena, the views point into the arena */
+                char* data = arena.bytes.data() + arena.used;
+                std::memcpy(data, fScratch.data() + i * fSettings.max_datagram, size);
+                arena.used += size;
+                const size_t first = arena.message_count;
+                const bool   valid = OSCMessageView::parse(data, size, [&](const OSCMessageView& message) {
+                    if (arena.message_count < arena.messages.size()) {
+                        arena.messages[arena.message_count++] = message;
+                    } else {
+                        fDropped.fetch_add(1, std::memory_order_relaxed);
+                    }
+                });
+                if (!valid) {
+                    fMalformed.fetch_add(1, std::memory_order_relaxed);
+                }
+                fMessages.fetch_add(arena.message_count - first, std::memory_order_relaxed);
+            }
+        }
+    }
+#endif
+};
@@ -0,0 +1,189 @@
+/*
+ * this example shows how to receive large amounts of OSC messages efficiently. an
+ * `OSCReceiver` reads datagrams in batches on a background thread and parses them without
+ * copying or allocating. once per frame `update()` takes all messages received since the last
+ * frame and passes them to an `OSCDispatcher`, which finds the handlers of an address in a
+ * hash table. bundles ( also nested ones ) are unpacked and their time tags are kept.
+ *
+ * send `/sensor/xy ,ff` ( normalized position ) or `/sensor/clear` to port 7001, e.g.
+ * from another application or with `oscsend localhost 7001 /sensor/xy ff 0.5 0.5`. press
+ * `b` to run a throughput benchmark with a sender thread on localhost.
+ */
+
+#if !defined(_WIN32)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "Umfeld.h"
+
+#include "OSCDispatcher.h"
+#include "OSCReceiver.h"
+
+using namespace umfeld;
+
+static constexpr uint16_t PORT            = 7001;
+static constexpr size_t   MAX_POINTS      = 4096;
+static constexpr int      BENCHMARK_COUNT = 200000;
+
+OSCReceiver              receiver(PORT);
+OSCDispatcher            dispatcher;
+std::vector<float>       points; // x, y pairs
+size_t                   messages_last_frame = 0;
+int                      benchmark_received  = 0;
+std::vector<std::string> benchmark_results;
+
+void settings() {
+    size(1024, 768);
+}
+
+void add_point(const OSCMessageView& message) {
+    if (points.size() < MAX_POINTS * 2) {
+        points.push_back(message.get_float(0));
+        points.push_back(message.get_float(1));
+    }
+}
+
+void setup() {
+    dispatcher.add("/sensor/xy", add_point, "ff");
+    dispatcher.add("/sensor/clear", [](const OSCMessageView&) { points.clear(); });
+    dispatcher.add("/benchmark", [](const OSCMessageView&) { benchmark_received++; }, "iff");
+    dispatcher.set_fallback([](const OSCMessageView& message) {
+        console("unhandled OSC message: ", std::string(message.address()), " ,", std::string(message.typetags()));
+    });
+
+    if (!receiver.start()) {
+        error("could not open port " + to_string(PORT));
+    }
+}
+
+void update() {
+    messages_last_frame = receiver.poll([](const OSCMessageView& message) { dispatcher.dispatch(message); });
+}
+
+#if !defined(_WIN32)
+/* writes a `/benchmark ,iff` message into `buffer` and returns its size */
+size_t encode_benchmark_message(char* buffer, const int index) {
+    static constexpr char HEADER[] = "/benchmark\0\0,iff\0\0\0\0"; // address and type tags, padded to 4 bytes
+    const float           x        = static_cast<float>(index % 100) / 100.0f;
+    uint32_t              words[3] = {static_cast<uint32_t>(index), 0, 0};
+    std::memcpy(&words[1], &x, 4);
+    std::memcpy(&words[2], &x, 4);
+    for (uint32_t& word: words) {
+        word = htonl(word);
+    }
+    std::memcpy(buffer, HEADER, 20);
+    std::memcpy(buffer + 20, words, 12);
+    return 32;
+}
+
+void run_benchmark(const int messages_per_bundle) {
+    const int   socket_handle = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in address{};
+    address.sin_family      = AF_INET;
+    address.sin_port        = htons(PORT);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    receiver.poll([](const OSCMessageView& message) { dispatcher.dispatch(message); });
+    benchmark_received = 0;
+    const auto start   = std::chrono::high_resolution_clock::now();
+
+    /* the sender thread sends single messages or bundles of `messages_per_bundle` messages */
+    std::thread sender([&]() {
+        char packet[8192];
+        for (int sent = 0; sent < BENCHMARK_COUNT;) {
+            size_t size = 0;
+            if (messages_per_bundle > 1) {
+                std::memcpy(packet, "#bundle\0\0\0\0\0\0\0\0\1", 16); // time tag `immediately`
+                size = 16;
+                for (int i = 0; i < messages_per_bundle && sent < BENCHMARK_COUNT; ++i, ++sent) {
+                    const uint32_t element_size = htonl(32);
+                    std::memcpy(packet + size, &element_size, 4);
+                    size += 4 + encode_benchmark_message(packet + size + 4, sent);
+                }
+            } else {
+                size = encode_benchmark_message(packet, sent++);
+            }
+            sendto(socket_handle, packet, size, 0, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+            /* give the receiver a chance on single core machines */
+            if (sent % 256 == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    /* receive until all messages arrived or nothing arrived for 500ms */
+    auto last_message = std::chrono::high_resolution_clock::now();
+    while (benchmark_received < BENCHMARK_COUNT) {
+        if (receiver.poll([](const OSCMessageView& message) { dispatcher.dispatch(message); }) > 0) {
+            last_message = std::chrono::high_resolution_clock::now();
+        } else if (std::chrono::high_resolution_clock::now() - last_message > std::chrono::milliseconds(500)) {
+            break;
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+    sender.join();
+    close(socket_handle);
+    const auto  end      = std::chrono::high_resolution_clock::now();
+    const float duration = std::chrono::duration<float>(end - start).count();
+
+    char result[160];
+    snprintf(result, sizeof(result), "BUNDLES OF %d: RECEIVED %d / %d MESSAGES IN %.1fms ( %.0fk MESSAGES/s )",
+             messages_per_bundle, benchmark_received, BENCHMARK_COUNT, duration * 1000.0f, benchmark_received / duration / 1000.0f);
+    benchmark_results.emplace_back(result);
+    console(result);
+}
+#else
+void run_benchmark(const int) {
+    /* NOTE like `OSCReceiver` the benchmark is not implemented on windows */
+    console("the benchmark is not available on windows");
+}
+#endif
+
+void draw() {
+    background(0.85f);
+
+    noFill();
+    stroke(1.0f, 0.25f, 0.35f);
+    strokeWeight(4.0f);
+    for (size_t i = 0; i + 1 < points.size(); i += 2) {
+        point(points[i] * width, points[i + 1] * height);
+    }
+
+    const OSCReceiver::Statistics statistics = receiver.get_statistics();
+    fill(0);
+    char info[160];
+    snprintf(info, sizeof(info), "PORT %u / LAST FRAME: %zu MESSAGES / TOTAL: %llu MESSAGES IN %llu DATAGRAMS ( %llu RECEIVE CALLS )",
+             PORT, messages_last_frame,
+             static_cast<unsigned long long>(statistics.messages),
+             static_cast<unsigned long long>(statistics.datagrams),
+             static_cast<unsigned long long>(statistics.receive_calls));
+    debug_text(info, 10, 10);
+    snprintf(info, sizeof(info), "MALFORMED: %llu / DROPPED: %llu",
+             static_cast<unsigned long long>(statistics.malformed),
+             static_cast<unsigned long long>(statistics.dropped));
+    debug_text(info, 10, 25);
+    for (size_t i = 0; i < benchmark_results.size(); ++i) {
+        debug_text(benchmark_results[i], 10, 55 + i * 15);
+    }
+}
+
+void keyPressed() {
+    if (key == 'b') {
+        run_benchmark(1);
+        run_benchmark(16);
+    }
+}
+
+void shutdown() {
+    receiver.stop();
+}
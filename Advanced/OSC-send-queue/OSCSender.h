@@ -0,0 +1,461 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "SPSCQueue.h"
+
+/**
+ * queues OSC messages and sends them in bundles from a background thread.
+ *
+ * `send()` encodes a message into the currently open bundle. this neither allocates nor
+ * calls into the system. once a bundle has reached `max_datagram` bytes ( by default 1472
+ * bytes i.e. what fits into one ethernet frame without fragmentation ) it is handed to the
+ * sender thread, which sends up to `batch_datagrams` datagrams per system call ( `sendmmsg` on
+ * linux, one `sendto` per datagram elsewhere ). `flush()` hands over all open bundles and is
+ * usually called once per frame.
+ *
+ * `send_at()` puts a message into a bundle with a time tag, so that the receiver can apply it
+ * at exactly that time. the sender thread holds such bundles back until `send_ahead` seconds
+ * before their time tag. bundles with the same time tag are filled together.
+ *
+ * NOTE `send()`, `send_at()` and `flush()` must always be called from the same thread.
+ * NOTE messages are dropped ( and counted ) if all datagrams are in use or if a message does
+ * not fit into a datagram.
+ * NOTE sending is not implemented on windows.
+ */
+class OSCSender {
+public:
+    static constexpr size_t   MAX_DATAGRAM      = 8192;
+    static constexpr uint64_t TIMETAG_IMMEDIATE = 1;
+
+    struct Settings {
+        size_t max_datagram        = 1472; // MTU of 1500 bytes minus IP and UDP headers
+        size_t number_of_datagrams = 256;
+        size_t batch_datagrams     = 32;
+        double send_ahead          = 0.05; // in seconds
+    };
+
+    struct Statistics {
+        uint64_t messages{0};
+        uint64_t bytes{0};
+        uint64_t datagrams{0};
+        uint64_t send_calls{0};
+        uint64_t dropped{0};
+        uint64_t failed{0}; // datagrams the system did not accept
+        float    messages_per_second{0.0f};
+        float    bytes_per_second{0.0f};
+    };
+
+    OSCSender(const std::string& host, const uint16_t port) : OSCSender(host, port, Settings{}) {}
+
+    OSCSender(const std::string& host, const uint16_t port, const Settings& settings) : fHost(host), fPort(port), fSettings(settings) {
+        fSettings.max_datagram        = std::clamp<size_t>(fSettings.max_datagram, 64, MAX_DATAGRAM);
+        fSettings.number_of_datagrams = std::clamp<size_t>(fSettings.number_of_datagrams, 1, DatagramQueue::capacity());
+        fSettings.batch_datagrams     = std::clamp<size_t>(fSettings.batch_datagrams, 1, MAX_BATCH);
+        fDatagrams.resize(fSettings.number_of_datagrams);
+        for (auto& datagram: fDatagrams) {
+            fFree.push(&datagram);
+        }
+        fOpen.reserve(MAX_OPEN_BUNDLES);
+    }
+
+    ~OSCSender() { stop(); }
+
+    OSCSender(const OSCSender&)            = delete;
+    OSCSender& operator=(const OSCSender&) = delete;
+
+    /* resolves the host, opens the socket and starts the sender thread. returns false if this fails */
+    bool start() {
+        stop();
+#if !defined(_WIN32)
+        addrinfo* result = nullptr;
+        addrinfo  hints{};
+        hints.ai_family   = AF_INET;
+        hints.ai_socktype = SOCK_DGRAM;
+        if (getaddrinfo(fHost.c_str(), nullptr, &hints, &result) != 0 || result == nullptr) {
+            return false;
+        }
+        fAddress          = *reinterpret_cast<sockaddr_in*>(result->ai_addr);
+        fAddress.sin_port = htons(fPort);
+        freeaddrinfo(result);
+        fSocket = socket(AF_INET, SOCK_DGRAM, 0);
+        if (fSocket < 0) {
+            return false;
+        }
+        fRunning.store(true);
+        fThread = std::thread(&OSCSender::send_loop, this);
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /* true between a successful `start()` and `stop()` */
+    bool is_running() const { return fRunning.load(); }
+
+    /* sends all queued bundles ( also scheduled ones ) and stops the sender thread */
+    void stop() {
+        flush();
+        fRunning.store(false);
+        if (fThread.joinable()) {
+            fThread.join();
+        }
+#if !defined(_WIN32)
+        if (fSocket >= 0) {
+            close(fSocket);
+            fSocket = -1;
+        }
+#endif
+    }
+
+    /* queues a message that is sent with the next flush. supported arguments are `int32_t`, `int64_t`, `float`, `double`, `bool` and strings */
+    template<typename... Args>
+    bool send(const std::string_view address, const Args&... args) { return send_at(TIMETAG_IMMEDIATE, address, args...); }
+
+    /* queues a message in a bundle with the NTP time tag `timetag` ( see `timetag_now()` ) */
+    template<typename... Args>
+    bool send_at(const uint64_t timetag, const std::string_view address, const Args&... args) {
+        const size_t size   = encoded_size(address, args...);
+        char*        buffer = reserve(timetag, size);
+        if (buffer == nullptr) {
+            fDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        write_message(buffer, address, args...);
+        return true;
+    }
+
+    /* hands all open bundles to the sender thread */
+    void flush() {
+        for (const auto& bundle: fOpen) {
+            close_bundle(bundle);
+        }
+        fOpen.clear();
+    }
+
+    /**
+     * encodes a single message into `buffer` ( without a bundle ) and returns its size or 0 if
+     * it does not fit into `capacity` bytes.
+     */
+    template<typename... Args>
+    static size_t encode(char* buffer, const size_t capacity, const std::string_view address, const Args&... args) {
+        const size_t size = encoded_size(address, args...);
+        if (size > capacity) {
+            return 0;
+        }
+        write_message(buffer, address, args...);
+        return size;
+    }
+
+    /* NTP time tag ( 32 bit seconds since 1900 and 32 bit fraction ) `seconds` from now */
+    static uint64_t timetag_now(const double seconds = 0.0) {
+        static constexpr double SECONDS_FROM_1900_TO_1970 = 2208988800.0;
+
+        const auto   since_1970 = std::chrono::system_clock::now().time_since_epoch();
+        const double time       = std::chrono::duration<double>(since_1970).count() + SECONDS_FROM_1900_TO_1970 + seconds;
+        const auto   whole      = static_cast<uint64_t>(time);
+        const auto   fraction   = static_cast<uint64_t>((time - static_cast<double>(whole)) * 4294967296.0);
+        return whole << 32 | fraction;
+    }
+
+    Statistics get_statistics() const {
+        Statistics statistics;
+        statistics.messages            = fMessages.load(std::memory_order_relaxed);
+        statistics.bytes               = fBytes.load(std::memory_order_relaxed);
+        statistics.datagrams           = fDatagramsSent.load(std::memory_order_relaxed);
+        statistics.send_calls          = fSendCalls.load(std::memory_order_relaxed);
+        statistics.dropped             = fDropped.load(std::memory_order_relaxed);
+        statistics.failed              = fFailed.load(std::memory_order_relaxed);
+        statistics.messages_per_second = fMessagesPerSecond.load(std::memory_order_relaxed);
+        statistics.bytes_per_second    = fBytesPerSecond.load(std::memory_order_relaxed);
+        return statistics;
+    }
+
+    /* approximate number of datagrams that are not queued or in flight */
+    size_t get_free_datagrams() const { return fFree.size(); }
+
+private:
+    static constexpr size_t MAX_BATCH        = 64;
+    static constexpr size_t MAX_OPEN_BUNDLES = 16;
+    static constexpr size_t BUNDLE_HEADER    = 16; // `#bundle` and time tag
+
+    struct Datagram {
+        char     data[MAX_DATAGRAM];
+        size_t   size;
+        uint32_t messages;
+        uint64_t timetag;
+    };
+
+    struct OpenBundle {
+        uint64_t  timetag;
+        Datagram* datagram;
+    };
+
+    using DatagramQueue = SPSCQueue<Datagram*, 1024>;
+
+    const std::string     fHost;
+    const uint16_t        fPort;
+    Settings              fSettings;
+    std::vector<Datagram> fDatagrams;
+    DatagramQueue         fFree;   // sender thread -> caller
+    DatagramQueue         fFilled; // caller -> sender thread
+    std::thread           fThread;
+    std::atomic<bool>     fRunning{false};
+    std::atomic<uint64_t> fMessages{0};
+    std::atomic<uint64_t> fBytes{0};
+    std::atomic<uint64_t> fDatagramsSent{0};
+    std::atomic<uint64_t> fSendCalls{0};
+    std::atomic<uint64_t> fDropped{0};
+    std::atomic<uint64_t> fFailed{0};
+    std::atomic<float>    fMessagesPerSecond{0.0f};
+    std::atomic<float>    fBytesPerSecond{0.0f};
+#if !defined(_WIN32)
+    sockaddr_in fAddress{};
+    int         fSocket{-1};
+#endif
+    /* caller only */
+    std::vector<OpenBundle> fOpen;
+
+    static size_t padded(const size_t size) { return (size + 3) & ~size_t{3}; }
+
+    /* type tags of the supported arguments */
+    static char type_of(const int32_t) { return 'i'; }
+    static char type_of(const int64_t) { return 'h'; }
+    static char type_of(const float) { return 'f'; }
+    static char type_of(const double) { return 'd'; }
+    static char type_of(const bool value) { return value ? 'T' : 'F'; }
+    static char type_of(const char*) { return 's'; }
+    static char type_of(const std::string_view) { return 's'; }
+
+    static size_t size_of(const int32_t) { return 4; }
+    static size_t size_of(const int64_t) { return 8; }
+    static size_t size_of(const float) { return 4; }
+    static size_t size_of(const double) { return 8; }
+    static size_t size_of(const bool) { return 0; }
+    static size_t size_of(const char* value) { return padded(std::strlen(value) + 1); }
+    static size_t size_of(const std::string_view value) { return padded(value.size() + 1); }
+
+    static void write_u32(char*& p, const uint32_t value) {
+        p[0] = static_cast<char>(value >> 24);
+        p[1] = static_cast<char>(value >> 16);
+        p[2] = static_cast<char>(value >> 8);
+        p[3] = static_cast<char>(value);
+        p += 4;
+    }
+
+    static void write_u64(char*& p, const uint64_t value) {
+        write_u32(p, static_cast<uint32_t>(value >> 32));
+        write_u32(p, static_cast<uint32_t>(value));
+    }
+
+    /* writes a zero terminated string padded with zeros to 4 bytes */
+    static void write_string(char*& p, const std::string_view value) {
+        const size_t size = padded(value.size() + 1);
+        std::memcpy(p, value.data(), value.size());
+        std::memset(p + value.size(), 0, size - value.size());
+        p += size;
+    }
+
+    static void write(char*& p, const int32_t value) { write_u32(p, static_cast<uint32_t>(value)); }
+    static void write(char*& p, const int64_t value) { write_u64(p, static_cast<uint64_t>(value)); }
+    static void write(char*&, const bool) {}
+    static void write(char*& p, const char* value) { write_string(p, value); }
+    static void write(char*& p, const std::string_view value) { write_string(p, value); }
+
+    static void write(char*& p, const float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        write_u32(p, bits);
+    }
+
+    static void write(char*& p, const double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        write_u64(p, bits);
+    }
+
+    template<typename... Args>
+    static size_t encoded_size(const std::string_view address, const Args&... args) {
+        return padded(address.size() + 1) + padded(sizeof...(Args) + 2) + (size_t{0} + ... + size_of(args));
+    }
+
+    template<typename... Args>
+    static void write_message(char* p, const std::string_view address, const Args&... args) {
+        const char typetags[sizeof...(Args) + 2] = {',', type_of(args)..., '\0'};
+        write_string(p, address);
+        write_string(p, std::string_view(typetags, sizeof...(Args) + 1));
+        (write(p, args), ...);
+    }
+
+    /* returns a datagram from the pool with an empty bundle or nullptr if all datagrams are in use */
+    Datagram* open_bundle(const uint64_t timetag) {
+        Datagram* datagram;
+        if (!fFree.pop(datagram)) {
+            return nullptr;
+        }
+        char* p = datagram->data;
+        std::memcpy(p, "#bundle", 8);
+        p += 8;
+        write_u64(p, timetag);
+        datagram->size     = BUNDLE_HEADER;
+        datagram->messages = 0;
+        datagram->timetag  = timetag;
+        return datagram;
+    }
+
+    void close_bundle(const OpenBundle& bundle) {
+        Datagram* datagram = bundle.datagram;
+        /* a bundle with a single immediate message is sent as a plain message */
+        if (datagram->messages == 1 && bundle.timetag == TIMETAG_IMMEDIATE) {
+            datagram->size -= BUNDLE_HEADER + 4;
+            std::memmove(datagram->data, datagram->data + BUNDLE_HEADER + 4, datagram->size);
+        }
+        /* the pool is smaller than the queue, so this never fails */
+        fFilled.push(datagram);
+    }
+
+    /* returns space for a message of `size` bytes in a bundle with `timetag` or nullptr */
+    char* reserve(const uint64_t timetag, const size_t size) {
+        if (BUNDLE_HEADER + 4 + size > fSettings.max_datagram) {
+            return nullptr;
+        }
+        auto bundle = std::find_if(fOpen.begin(), fOpen.end(), [timetag](const OpenBundle& b) { return b.timetag == timetag; });
+        if (bundle != fOpen.end() && bundle->datagram->size + 4 + size > fSettings.max_datagram) {
+            close_bundle(*bundle);
+            fOpen.erase(bundle);
+            bundle = fOpen.end();
+        }
+        if (bundle == fOpen.end()) {
+            if (fOpen.size() == MAX_OPEN_BUNDLES) {
+                close_bundle(fOpen.front());
+                fOpen.erase(fOpen.begin());
+            }
+            Datagram* datagram = open_bundle(timetag);
+            if (datagram == nullptr) {
+                return nullptr;
+            }
+            fOpen.push_back({timetag, datagram});
+            bundle = fOpen.end() - 1;
+        }
+        Datagram* datagram = bundle->datagram;
+        char*     p        = datagram->data + datagram->size;
+        write_u32(p, static_cast<uint32_t>(size));
+        datagram->size += 4 + size;
+        datagram->messages++;
+        return p;
+    }
+
+#if !defined(_WIN32)
+    /* sends `count` datagrams with as few system calls as possible */
+    void send_batch(Datagram* const* datagrams, const size_t count) {
+#if defined(__linux__)
+        mmsghdr messages[MAX_BATCH];
+        iovec   vectors[MAX_BATCH];
+        for (size_t i = 0; i < count; ++i) {
+            vectors[i]                      = {datagrams[i]->data, datagrams[i]->size};
+            messages[i]                     = {};
+            messages[i].msg_hdr.msg_name    = &fAddress;
+            messages[i].msg_hdr.msg_namelen = sizeof(fAddress);
+            messages[i].msg_hdr.msg_iov     = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen  = 1;
+        }
+        size_t sent = 0;
+        while (sent < count) {
+            const int result = sendmmsg(fSocket, messages + sent, static_cast<unsigned>(count - sent), 0);
+            fSendCalls.fetch_add(1, std::memory_order_relaxed);
+            if (result <= 0) {
+                /* skip the datagram that failed and try the rest */
+                fFailed.fetch_add(1, std::memory_order_relaxed);
+                datagrams[sent]->messages = 0;
+                datagrams[sent]->size     = 0;
+                ++sent;
+                continue;
+            }
+            sent += static_cast<size_t>(result);
+        }
+#else
+        for (size_t i = 0; i < count; ++i) {
+            fSendCalls.fetch_add(1, std::memory_order_relaxed);
+            if (sendto(fSocket, datagrams[i]->data, datagrams[i]->size, 0, reinterpret_cast<const sockaddr*>(&fAddress), sizeof(fAddress)) < 0) {
+                fFailed.fetch_add(1, std::memory_order_relaxed);
+                datagrams[i]->messages = 0;
+                datagrams[i]->size     = 0;
+            }
+        }
+#endif
+        for (size_t i = 0; i < count; ++i) {
+            if (datagrams[i]->size > 0) {
+                fMessages.fetch_add(datagrams[i]->messages, std::memory_order_relaxed);
+                fBytes.fetch_add(datagrams[i]->size, std::memory_order_relaxed);
+                fDatagramsSent.fetch_add(1, std::memory_order_relaxed);
+            }
+            fFree.push(datagrams[i]);
+        }
+    }
+
+    void send_loop() {
+        std::vector<Datagram*> scheduled;
+        std::vector<Datagram*> due;
+        scheduled.reserve(fDatagrams.size());
+        due.reserve(fDatagrams.size());
+        auto     last_rate_update = std::chrono::steady_clock::now();
+        uint64_t last_messages    = 0;
+        uint64_t last_bytes       = 0;
+
+        while (true) {
+            /* read the flag first: everything queued before `stop()` is visible after it */
+            const bool running = fRunning.load();
+            Datagram*  datagram;
+            while (fFilled.pop(datagram)) {
+                (datagram->timetag == TIMETAG_IMMEDIATE ? due : scheduled).push_back(datagram);
+            }
+            /* scheduled bundles are sent `send_ahead` seconds early ( or right away when stopping ) */
+            const uint64_t horizon = timetag_now(fSettings.send_ahead);
+            const auto     later   = std::stable_partition(scheduled.begin(), scheduled.end(), [&](const Datagram* d) {
+                return !running || d->timetag <= horizon;
+            });
+            due.insert(due.end(), scheduled.begin(), later);
+            scheduled.erase(scheduled.begin(), later);
+
+            for (size_t i = 0; i < due.size(); i += fSettings.batch_datagrams) {
+                send_batch(due.data() + i, std::min(fSettings.batch_datagrams, due.size() - i));
+            }
+
+            const auto now = std::chrono::steady_clock::now();
+            if (now - last_rate_update >= std::chrono::seconds(1)) {
+                const float    elapsed  = std::chrono::duration<float>(now - last_rate_update).count();
+                const uint64_t messages = fMessages.load(std::memory_order_relaxed);
+                const uint64_t bytes    = fBytes.load(std::memory_order_relaxed);
+                fMessagesPerSecond.store(static_cast<float>(messages - last_messages) / elapsed, std::memory_order_relaxed);
+                fBytesPerSecond.store(static_cast<float>(bytes - last_bytes) / elapsed, std::memory_order_relaxed);
+                last_messages    = messages;
+                last_bytes       = bytes;
+                last_rate_update = now;
+            }
+
+            if (!running && scheduled.empty() && fFilled.empty()) {
+                break;
+            }
+            if (due.empty()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            due.clear();
+        }
+    }
+#endif
+};
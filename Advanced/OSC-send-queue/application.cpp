@@ -0,0 +1,171 @@
+/*
+ * this example shows how to send many OSC messages per frame efficiently. an `OSCSender`
+ * collects the messages of a frame in bundles that fill up whole datagrams and sends them from
+ * a background thread with as few system calls as possible. messages can also be scheduled
+ * with a time tag, e.g. to trigger notes on another machine with sample accurate timing.
+ *
+ * the example sends 512 parameters per frame and every half second a scheduled note to port
+ * 7001 on localhost ( run the `OSC-batched` example to receive them ). press `b` to compare
+ * sending 100000 messages one by one ( one datagram and one system call per message ) with
+ * sending them through the queue.
+ */
+
+#if !defined(_WIN32)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "Umfeld.h"
+
+#include "OSCSender.h"
+
+using namespace umfeld;
+
+static constexpr uint16_t PORT                 = 7001;
+static constexpr int      NUMBER_OF_PARAMETERS = 512;
+static constexpr int      BENCHMARK_COUNT      = 100000;
+
+OSCSender                sender("127.0.0.1", PORT);
+std::vector<float>       parameters(NUMBER_OF_PARAMETERS);
+int                      frame_counter = 0;
+std::vector<std::string> benchmark_results;
+
+void settings() {
+    size(1024, 768);
+}
+
+void setup() {
+    if (!sender.start()) {
+        error("could not open socket");
+    }
+}
+
+void update() {
+    for (int i = 0; i < NUMBER_OF_PARAMETERS; ++i) {
+        parameters[i] = 0.5f + 0.5f * std::sin(frame_counter * 0.05f + i * 0.1f);
+        sender.send("/parameter", i, parameters[i]);
+    }
+    /* the receiver plays the note exactly 100ms from now, no matter when the bundle arrives */
+    if (frame_counter % 30 == 0) {
+        sender.send_at(OSCSender::timetag_now(0.1), "/note", 60 + frame_counter / 30 % 12, 0.8f);
+    }
+    sender.flush();
+    frame_counter++;
+}
+
+#if !defined(_WIN32)
+void run_benchmark() {
+    static constexpr auto TIMEOUT = std::chrono::seconds(5);
+
+    char result[160];
+    if (!sender.is_running()) {
+        /* without the sender thread the queue is never emptied */
+        console("benchmark skipped: the sender is not running");
+        return;
+    }
+
+    /* one datagram per message */
+    {
+        const int   socket_handle = socket(AF_INET, SOCK_DGRAM, 0);
+        sockaddr_in address{};
+        address.sin_family      = AF_INET;
+        address.sin_port        = htons(PORT);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        char       packet[64];
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < BENCHMARK_COUNT; ++i) {
+            const size_t size = OSCSender::encode(packet, sizeof(packet), "/benchmark", i, 0.5f);
+            sendto(socket_handle, packet, size, 0, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        }
+        const auto  end      = std::chrono::high_resolution_clock::now();
+        const float duration = std::chrono::duration<float, std::milli>(end - start).count();
+        close(socket_handle);
+        snprintf(result, sizeof(result), "ONE BY ONE: %d MESSAGES IN %.1fms ( %d SYSTEM CALLS )", BENCHMARK_COUNT, duration, BENCHMARK_COUNT);
+        benchmark_results.emplace_back(result);
+        console(result);
+    }
+
+    /* bundled and sent by the sender thread. wait for the thread to send everything */
+    {
+        const OSCSender::Statistics before = sender.get_statistics();
+        const auto                  start  = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < BENCHMARK_COUNT; ++i) {
+            /* flush every 1000 messages ( like a frame ) and give the sender thread time to catch up */
+            if (i % 1000 == 0) {
+                sender.flush();
+                while (sender.get_free_datagrams() < 32 && std::chrono::high_resolution_clock::now() - start < TIMEOUT) {
+                    std::this_thread::yield();
+                }
+            }
+            sender.send("/benchmark", i, 0.5f);
+        }
+        sender.flush();
+        while (sender.get_statistics().messages - before.messages < BENCHMARK_COUNT &&
+               std::chrono::high_resolution_clock::now() - start < TIMEOUT) {
+            std::this_thread::yield();
+        }
+        const auto                  end      = std::chrono::high_resolution_clock::now();
+        const float                 duration = std::chrono::duration<float, std::milli>(end - start).count();
+        const OSCSender::Statistics after    = sender.get_statistics();
+        snprintf(result, sizeof(result), "QUEUE: %llu MESSAGES IN %.1fms ( %llu DATAGRAMS, %llu SYSTEM CALLS )",
+                 static_cast<unsigned long long>(after.messages - before.messages), duration,
+                 static_cast<unsigned long long>(after.datagrams - before.datagrams),
+                 static_cast<unsigned long long>(after.send_calls - before.send_calls));
+        benchmark_results.emplace_back(result);
+        console(result);
+    }
+}
+#else
+void run_benchmark() {
+    /* NOTE like `OSCSender` the benchmark is not implemented on windows */
+    console("the benchmark is not available on windows");
+}
+#endif
+
+void draw() {
+    background(0.85f);
+
+    noStroke();
+    fill(1.0f, 0.25f, 0.35f);
+    const float bar_width = static_cast<float>(width) / NUMBER_OF_PARAMETERS;
+    for (int i = 0; i < NUMBER_OF_PARAMETERS; ++i) {
+        const float bar_height = parameters[i] * (height - 200);
+        rect(i * bar_width, height - bar_height, bar_width, bar_height);
+    }
+
+    const OSCSender::Statistics statistics = sender.get_statistics();
+    fill(0);
+    char info[160];
+    snprintf(info, sizeof(info), "%.0f MESSAGES/s / %.1f KB/s / TOTAL: %llu MESSAGES IN %llu DATAGRAMS ( %llu SYSTEM CALLS )",
+             statistics.messages_per_second, statistics.bytes_per_second / 1024.0f,
+             static_cast<unsigned long long>(statistics.messages),
+             static_cast<unsigned long long>(statistics.datagrams),
+             static_cast<unsigned long long>(statistics.send_calls));
+    debug_text(info, 10, 10);
+    snprintf(info, sizeof(info), "DROPPED: %llu / FAILED: %llu",
+             static_cast<unsigned long long>(statistics.dropped),
+             static_cast<unsigned long long>(statistics.failed));
+    debug_text(info, 10, 25);
+    for (size_t i = 0; i < benchmark_results.size(); ++i) {
+        debug_text(benchmark_results[i], 10, 55 + i * 15);
+    }
+}
+
+void keyPressed() {
+    if (key == 'b') {
+        run_benchmark();
+    }
+}
+
+void shutdown() {
+    sender.stop();
+}
@@ -0,0 +1,324 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "Umfeld.h"
+#include "Geometry.h"
+#include "VertexBuffer.h"
+#include "glm/gtc/matrix_transform.hpp"
+
+/**
+ * collects many small shapes ( `rect()`, `ellipse()`, `line()`, `triangle()`, `box()` ) into a
+ * few large vertex buffers and draws each buffer with a single draw call.
+ *
+ * drawing shapes one by one with `rect()` etc. costs a draw call ( and a state update ) per
+ * shape. the batch instead writes the vertices of each shape into a buffer, with the fill or
+ * stroke color stored per vertex and the transformation of the batch ( `translate()`,
+ * `rotate()` etc. ) applied on the CPU. shapes with different colors and transformations can
+ * therefore share one draw call.
+ *
+ * a batch is drawn ( *flushed* ) when
+ *
+ * - the buffer is full ( `max_vertices` ),
+ * - the depth test is switched with `set_depth_test()`, i.e. a state that can not be stored per
+ *   vertex changes,
+ * - `flush()` is called. call it at the end of `draw()` and before drawing anything with the
+ *   regular drawing functions, otherwise the order of the shapes is not kept.
+ *
+ * 2D strokes are drawn as triangles ( in the same buffer as the fills ), so that fills and
+ * strokes keep their order. the edges of boxes are drawn as lines.
+ */
+class ShapeBatch {
+public:
+    struct Statistics {
+        uint32_t shapes{0};
+        uint32_t vertices{0};
+        uint32_t batches{0};    // flushes that drew something
+        uint32_t draw_calls{0}; // up to two per batch: triangles and lines
+        uint32_t full_flushes{0};
+        uint32_t state_flushes{0};
+    };
+
+    explicit ShapeBatch(const size_t max_vertices = 1 << 17) : fMaxVertices(max_vertices) {
+        fMatrixStack.reserve(32);
+        set_ellipse_detail(32);
+    }
+
+    ~ShapeBatch() {
+        for (const auto* buffer: fBuffers) {
+            delete buffer;
+        }
+    }
+
+    ShapeBatch(const ShapeBatch&)            = delete;
+    ShapeBatch& operator=(const ShapeBatch&) = delete;
+
+    /* resets the transformation and the statistics. call at the start of `draw()` */
+    void begin_frame() {
+        fMatrix = glm::mat4(1.0f);
+        fMatrixStack.clear();
+        fStatistics = {};
+        fNextBuffer = 0;
+    }
+
+    void fill(const float r, const float g, const float b, const float a = 1.0f) {
+        fFill        = {r, g, b, a};
+        fFillEnabled = true;
+    }
+
+    void fill(const float gray, const float a = 1.0f) { fill(gray, gray, gray, a); }
+
+    void no_fill() { fFillEnabled = false; }
+
+    void stroke(const float r, const float g, const float b, const float a = 1.0f) {
+        fStroke        = {r, g, b, a};
+        fStrokeEnabled = true;
+    }
+
+    void stroke(const float gray, const float a = 1.0f) { stroke(gray, gray, gray, a); }
+
+    void no_stroke() { fStrokeEnabled = false; }
+
+    void stroke_weight(const float weight) { fStrokeWeight = weight; }
+
+    /* number of segments of a full ellipse */
+    void set_ellipse_detail(const int segments) {
+        /* the points on the unit circle are computed once */
+        fCircle.resize(std::max(segments, 3) + 1);
+        for (size_t i = 0; i < fCircle.size(); ++i) {
+            const float angle = 2.0f * umfeld::PI * static_cast<float>(i) / static_cast<float>(fCircle.size() - 1);
+            fCircle[i]        = {std::cos(angle), std::sin(angle)};
+        }
+    }
+
+    /* flushes the batch if the state changes */
+    void set_depth_test(const bool enabled) {
+        if (enabled == fDepthTest) {
+            return;
+        }
+        if (!empty()) {
+            fStatistics.state_flushes++;
+        }
+        flush();
+        fDepthTest = enabled;
+        umfeld::hint(enabled ? umfeld::ENABLE_DEPTH_TEST : umfeld::DISABLE_DEPTH_TEST);
+    }
+
+    void push_matrix() { fMatrixStack.push_back(fMatrix); }
+
+    void pop_matrix() {
+        if (!fMatrixStack.empty()) {
+            fMatrix = fMatrixStack.back();
+            fMatrixStack.pop_back();
+        }
+    }
+
+    void translate(const float x, const float y, const float z = 0.0f) { fMatrix = glm::translate(fMatrix, glm::vec3(x, y, z)); }
+    void rotate(const float angle) { rotate_z(angle); }
+    void rotate_x(const float angle) { fMatrix = glm::rotate(fMatrix, angle, glm::vec3(1.0f, 0.0f, 0.0f)); }
+    void rotate_y(const float angle) { fMatrix = glm::rotate(fMatrix, angle, glm::vec3(0.0f, 1.0f, 0.0f)); }
+    void rotate_z(const float angle) { fMatrix = glm::rotate(fMatrix, angle, glm::vec3(0.0f, 0.0f, 1.0f)); }
+    void scale(const float s) { fMatrix = glm::scale(fMatrix, glm::vec3(s)); }
+
+    void rect(const float x, const float y, const float width, const float height) {
+        reserve(6 + 24);
+        if (fFillEnabled) {
+            quad(x, y, x + width, y, x + width, y + height, x, y + height, fFill);
+        }
+        if (fStrokeEnabled) {
+            /* a frame of 4 quads centered on the outline, without overlaps */
+            const float h  = fStrokeWeight * 0.5f;
+            const float x0 = x - h;
+            const float y0 = y - h;
+            const float x1 = x + width + h;
+            const float y1 = y + height + h;
+            quad(x0, y0, x1, y0, x1, y0 + 2 * h, x0, y0 + 2 * h, fStroke);
+            quad(x0, y1 - 2 * h, x1, y1 - 2 * h, x1, y1, x0, y1, fStroke);
+            quad(x0, y0 + 2 * h, x0 + 2 * h, y0 + 2 * h, x0 + 2 * h, y1 - 2 * h, x0, y1 - 2 * h, fStroke);
+            quad(x1 - 2 * h, y0 + 2 * h, x1, y0 + 2 * h, x1, y1 - 2 * h, x1 - 2 * h, y1 - 2 * h, fStroke);
+        }
+        fStatistics.shapes++;
+    }
+
+    /* `x` and `y` are the center */
+    void ellipse(const float x, const float y, const float width, const float height) {
+        const size_t segments = fCircle.size() - 1;
+        reserve(segments * 3 + segments * 6);
+        const float rx = width * 0.5f;
+        const float ry = height * 0.5f;
+        if (fFillEnabled) {
+            for (size_t i = 0; i < segments; ++i) {
+                const glm::vec2& p0 = fCircle[i];
+                const glm::vec2& p1 = fCircle[i + 1];
+                add_triangle(x, y, x + p0.x * rx, y + p0.y * ry, x + p1.x * rx, y + p1.y * ry, fFill);
+            }
+        }
+        if (fStrokeEnabled) {
+            const float h = fStrokeWeight * 0.5f;
+            for (size_t i = 0; i < segments; ++i) {
+                const glm::vec2& p0 = fCircle[i];
+                const glm::vec2& p1 = fCircle[i + 1];
+                quad(x + p0.x * (rx - h), y + p0.y * (ry - h), x + p0.x * (rx + h), y + p0.y * (ry + h),
+                     x + p1.x * (rx + h), y + p1.y * (ry + h), x + p1.x * (rx - h), y + p1.y * (ry - h), fStroke);
+            }
+        }
+        fStatistics.shapes++;
+    }
+
+    void line(const float x1, const float y1, const float x2, const float y2) {
+        if (!fStrokeEnabled) {
+            return;
+        }
+        reserve(6);
+        line_quad(x1, y1, x2, y2);
+        fStatistics.shapes++;
+    }
+
+    void triangle(const float x1, const float y1, const float x2, const float y2, const float x3, const float y3) {
+        reserve(3 + 18);
+        if (fFillEnabled) {
+            add_triangle(x1, y1, x2, y2, x3, y3, fFill);
+        }
+        if (fStrokeEnabled) {
+            line_quad(x1, y1, x2, y2);
+            line_quad(x2, y2, x3, y3);
+            line_quad(x3, y3, x1, y1);
+        }
+        fStatistics.shapes++;
+    }
+
+    void box(const float size) { box(size, size, size); }
+
+    /* centered at the origin of the current transformation */
+    void box(const float width, const float height, const float depth) {
+        reserve(36 + 24);
+        const float x = width * 0.5f;
+        const float y = height * 0.5f;
+        const float z = depth * 0.5f;
+
+        const glm::vec3 corners[8] = {{-x, -y, -z}, {x, -y, -z}, {x, y, -z}, {-x, y, -z},
+                                      {-x, -y, z}, {x, -y, z}, {x, y, z}, {-x, y, z}};
+        if (fFillEnabled) {
+            static constexpr int FACES[6][4] = {{0, 1, 2, 3}, {5, 4, 7, 6}, {4, 0, 3, 7}, {1, 5, 6, 2}, {4, 5, 1, 0}, {3, 2, 6, 7}};
+            for (const auto& face: FACES) {
+                add_vertex(fTriangles, corners[face[0]], fFill);
+                add_vertex(fTriangles, corners[face[1]], fFill);
+                add_vertex(fTriangles, corners[face[2]], fFill);
+                add_vertex(fTriangles, corners[face[0]], fFill);
+                add_vertex(fTriangles, corners[face[2]], fFill);
+                add_vertex(fTriangles, corners[face[3]], fFill);
+            }
+        }
+        if (fStrokeEnabled) {
+            static constexpr int EDGES[12][2] = {{0, 1}, {1, 2}, {2, 3}, {3, 0}, {4, 5}, {5, 6}, {6, 7}, {7, 4}, {0, 4}, {1, 5}, {2, 6}, {3, 7}};
+            for (const auto& edge: EDGES) {
+                add_vertex(fLines, corners[edge[0]], fStroke);
+                add_vertex(fLines, corners[edge[1]], fStroke);
+            }
+        }
+        fStatistics.shapes++;
+    }
+
+    /* draws all collected shapes */
+    void flush() {
+        if (empty()) {
+            return;
+        }
+        fStatistics.batches++;
+        fStatistics.vertices += static_cast<uint32_t>(fTriangles->size() + fLines->size());
+        draw(fTriangleBuffer, umfeld::TRIANGLES);
+        draw(fLineBuffer, umfeld::LINES);
+        fTriangleBuffer = nullptr;
+        fLineBuffer     = nullptr;
+        fTriangles      = nullptr;
+        fLines          = nullptr;
+    }
+
+    /* statistics since `begin_frame()` */
+    const Statistics& get_statistics() const { return fStatistics; }
+
+private:
+    const size_t                       fMaxVertices;
+    std::vector<umfeld::VertexBuffer*> fBuffers; // reused every frame
+    size_t                             fNextBuffer{0};
+    umfeld::VertexBuffer*              fTriangleBuffer{nullptr};
+    umfeld::VertexBuffer*              fLineBuffer{nullptr};
+    std::vector<umfeld::Vertex>*       fTriangles{nullptr};
+    std::vector<umfeld::Vertex>*       fLines{nullptr};
+    glm::mat4                          fMatrix{1.0f};
+    std::vector<glm::mat4>             fMatrixStack;
+    glm::vec4                          fFill{1.0f};
+    glm::vec4                          fStroke{0.0f, 0.0f, 0.0f, 1.0f};
+    float                              fStrokeWeight{1.0f};
+    std::vector<glm::vec2>             fCircle; // unit circle, first point repeated at the end
+    bool                               fFillEnabled{true};
+    bool                               fStrokeEnabled{true};
+    bool                               fDepthTest{false};
+    Statistics                         fStatistics;
+
+    bool empty() const { return fTriangles == nullptr || (fTriangles->empty() && fLines->empty()); }
+
+    umfeld::VertexBuffer* next_buffer() {
+        if (fNextBuffer == fBuffers.size()) {
+            fBuffers.push_back(new umfeld::VertexBuffer());
+        }
+        umfeld::VertexBuffer* buffer = fBuffers[fNextBuffer++];
+        buffer->vertices_data().clear();
+        return buffer;
+    }
+
+    /* makes sure that `vertices` more vertices fit into the current batch */
+    void reserve(const size_t vertices) {
+        if (fTriangles != nullptr && fTriangles->size() + fLines->size() + vertices > fMaxVertices) {
+            fStatistics.full_flushes++;
+            flush();
+        }
+        if (fTriangles == nullptr) {
+            fTriangleBuffer = next_buffer();
+            fLineBuffer     = next_buffer();
+            fTriangles      = &fTriangleBuffer->vertices_data();
+            fLines          = &fLineBuffer->vertices_data();
+        }
+    }
+
+    void draw(umfeld::VertexBuffer* buffer, const int shape) {
+        if (buffer->vertices_data().empty()) {
+            return;
+        }
+        buffer->set_shape(shape);
+        buffer->update();
+        umfeld::mesh(buffer);
+        fStatistics.draw_calls++;
+    }
+
+    void add_vertex(std::vector<umfeld::Vertex>* vertices, const glm::vec3& position, const glm::vec4& color) const {
+        vertices->emplace_back(glm::vec3(fMatrix * glm::vec4(position, 1.0f)), color, glm::vec3(0.0f));
+    }
+
+    void add_triangle(const float x1, const float y1, const float x2, const float y2, const float x3, const float y3, const glm::vec4& color) {
+        add_vertex(fTriangles, {x1, y1, 0.0f}, color);
+        add_vertex(fTriangles, {x2, y2, 0.0f}, color);
+        add_vertex(fTriangles, {x3, y3, 0.0f}, color);
+    }
+
+    void quad(const float x1, const float y1, const float x2, const float y2, const float x3, const float y3, const float x4, const float y4, const glm::vec4& color) {
+        add_triangle(x1, y1, x2, y2, x3, y3, color);
+        add_triangle(x1, y1, x3, y3, x4, y4, color);
+    }
+
+    /* a line as a quad of `fStrokeWeight` width */
+    void line_quad(const float x1, const float y1, const float x2, const float y2) {
+        const float dx     = x2 - x1;
+        const float dy     = y2 - y1;
+        const float length = std::sqrt(dx * dx + dy * dy);
+        if (length <= 0.0f) {
+            return;
+        }
+        const float nx = -dy / length * fStrokeWeight * 0.5f;
+        const float ny = dx / length * fStrokeWeight * 0.5f;
+        quad(x1 + nx, y1 + ny, x2 + nx, y2 + ny, x2 - nx, y2 - ny, x1 - nx, y1 - ny, fStroke);
+    }
+};
@@ -0,0 +1,133 @@
+/*
+ * this example shows how to draw many small shapes with a few draw calls by collecting them
+ * in a `ShapeBatch`. every shape may have its own color and transformation, the batch stores
+ * them per vertex and draws all shapes with one draw call per 2^17 vertices.
+ *
+ * press `1` to draw 100000 rects with `rect()`, `2` to draw them with the batch. press `3` to
+ * draw 500 boxes with `box()` and `4` to draw them with the batch. the time needed to submit
+ * the shapes is shown in the top left corner.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "Umfeld.h"
+
+#include "ShapeBatch.h"
+
+using namespace umfeld;
+
+static constexpr int NUMBER_OF_RECTS = 100000;
+static constexpr int NUMBER_OF_BOXES = 500;
+
+struct Shape {
+    float x, y, z;
+    float size;
+    float r, g, b;
+};
+
+ShapeBatch         batch;
+std::vector<Shape> rects(NUMBER_OF_RECTS);
+std::vector<Shape> boxes(NUMBER_OF_BOXES);
+int                mode           = 2;
+float              submit_time_ms = 0.0f;
+
+void settings() {
+    size(1024, 768);
+}
+
+void setup() {
+    for (auto& s: rects) {
+        s = {random(width), random(height), 0.0f, random(2.0f, 6.0f), random(1.0f), random(0.25f), random(0.35f, 1.0f)};
+    }
+    for (auto& s: boxes) {
+        s = {random(-140, 140), random(-140, 140), random(-140, 140), random(4.0f, 20.0f), random(0.5f, 1.0f), random(0.5f, 1.0f), random(0.5f, 1.0f)};
+    }
+}
+
+void draw_rects(const bool batched) {
+    const float wobble = std::sin(frameCount * 0.05f) * 4.0f;
+    if (batched) {
+        batch.no_stroke();
+        for (const auto& s: rects) {
+            batch.fill(s.r, s.g, s.b);
+            batch.rect(s.x + wobble, s.y, s.size, s.size);
+        }
+        batch.flush();
+    } else {
+        noStroke();
+        for (const auto& s: rects) {
+            fill(s.r, s.g, s.b);
+            rect(s.x + wobble, s.y, s.size, s.size);
+        }
+    }
+}
+
+void draw_boxes(const bool batched) {
+    const float angle = frameCount * 0.005f;
+    if (batched) {
+        batch.set_depth_test(true);
+        batch.stroke(0.0f);
+        batch.translate(width * 0.5f, height * 0.5f, -200.0f);
+        batch.rotate_y(angle);
+        batch.rotate_x(angle);
+        for (const auto& s: boxes) {
+            batch.push_matrix();
+            batch.translate(s.x, s.y, s.z);
+            batch.fill(s.r, s.g, s.b);
+            batch.box(s.size);
+            batch.pop_matrix();
+        }
+        batch.flush();
+        batch.set_depth_test(false);
+    } else {
+        hint(ENABLE_DEPTH_TEST);
+        stroke(0.0f);
+        pushMatrix();
+        translate(width * 0.5f, height * 0.5f, -200.0f);
+        rotateY(angle);
+        rotateX(angle);
+        for (const auto& s: boxes) {
+            pushMatrix();
+            translate(s.x, s.y, s.z);
+            fill(s.r, s.g, s.b);
+            box(s.size);
+            popMatrix();
+        }
+        popMatrix();
+        hint(DISABLE_DEPTH_TEST);
+    }
+}
+
+void draw() {
+    background(0.85f);
+    batch.begin_frame();
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    if (mode == 1 || mode == 2) {
+        draw_rects(mode == 2);
+    } else {
+        draw_boxes(mode == 4);
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+    submit_time_ms = std::chrono::duration<float, std::milli>(end - start).count();
+
+    const ShapeBatch::Statistics& statistics = batch.get_statistics();
+    fill(0);
+    static const char* MODES[] = {"", "100000 RECTS WITH `rect()`", "100000 RECTS BATCHED", "500 BOXES WITH `box()`", "500 BOXES BATCHED"};
+    debug_text(MODES[mode], 10, 10);
+    debug_text("FPS        : " + nf(frameRate, 1), 10, 25);
+    debug_text("SUBMIT TIME: " + nf(submit_time_ms, 2) + "ms", 10, 40);
+    char info[160];
+    snprintf(info, sizeof(info), "BATCH      : %u SHAPES / %u VERTICES / %u BATCHES / %u DRAW CALLS / FLUSHES: %u FULL, %u STATE",
+             statistics.shapes, statistics.vertices, statistics.batches, statistics.draw_calls, statistics.full_flushes, statistics.state_flushes);
+    debug_text(info, 10, 55);
+}
+
+void keyPressed() {
+    if (key >= '1' && key <= '4') {
+        mode = key - '0';
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Umfeld.h"
+#include "Geometry.h"
+
+/**
+ * a mesh that stores every distinct vertex once. triangles refer to their vertices with
+ * three indices each.
+ *
+ * `loadOBJ()` returns three vertices per triangle, so a vertex that is shared by six
+ * triangles ( which is typical for closed meshes ) is stored six times. an indexed mesh stores
+ * it once plus six 4 byte indices, and the GPU can reuse the result of the vertex shader for
+ * vertices that were transformed recently ( see `VertexCacheOptimizer.h` ).
+ */
+struct IndexedMesh {
+    std::vector<umfeld::Vertex> vertices;
+    std::vector<uint32_t>       indices;
+
+    size_t memory_size() const { return vertices.size() * sizeof(umfeld::Vertex) + indices.size() * sizeof(uint32_t); }
+};
+
+/**
+ * creates an indexed mesh from a list of triangles e.g. from `loadOBJ()`. vertices with
+ * identical attributes ( position, normal, color, texture coordinates etc. ) are merged.
+ */
+inline IndexedMesh create_indexed_mesh(const std::vector<umfeld::Vertex>& triangles) {
+    IndexedMesh mesh;
+    mesh.indices.reserve(triangles.size());
+    /* compares the bytes of vertices, the keys point into `triangles` */
+    std::unordered_map<std::string_view, uint32_t> vertex_indices;
+    vertex_indices.reserve(triangles.size());
+    for (const auto& v: triangles) {
+        const std::string_view key(reinterpret_cast<const char*>(&v), sizeof(umfeld::Vertex));
+        const auto [it, inserted] = vertex_indices.try_emplace(key, static_cast<uint32_t>(mesh.vertices.size()));
+        if (inserted) {
+            mesh.vertices.push_back(v);
+        }
+        mesh.indices.push_back(it->second);
+    }
+    return mesh;
+}
+
+/**
+ * reorders the vertices in the order in which the triangles use them, so that the GPU reads
+ * the vertex buffer mostly sequentially. call this after optimizing the triangle order.
+ */
+inline void optimize_vertex_fetch(IndexedMesh& mesh) {
+    constexpr uint32_t          UNUSED = UINT32_MAX;
+    std::vector<uint32_t>       remap(mesh.vertices.size(), UNUSED);
+    std::vector<umfeld::Vertex> vertices;
+    vertices.reserve(mesh.vertices.size());
+    for (uint32_t& index: mesh.indices) {
+        if (remap[index] == UNUSED) {
+            remap[index] = static_cast<uint32_t>(vertices.size());
+            vertices.push_back(mesh.vertices[index]);
+        }
+        index = remap[index];
+    }
+    mesh.vertices = std::move(vertices);
+}
+
+/**
+ * simulates a FIFO vertex cache with `cache_size` entries and returns the number of
+ * transformed vertices per triangle ( average cache miss ratio or ACMR ). the ratio is 3 for
+ * unindexed triangles and approaches 0.5 for large, perfectly ordered meshes.
+ */
+inline float average_cache_miss_ratio(const std::vector<uint32_t>& indices, const size_t vertex_count, const size_t cache_size = 16) {
+    if (indices.size() < 3) {
+        return 0.0f;
+    }
+    std::vector<size_t> cached_at(vertex_count, 0); // time at which a vertex entered the cache, 0 for never
+    size_t              misses = 0;
+    for (const uint32_t index: indices) {
+        if (cached_at[index] == 0 || misses + 1 - cached_at[index] > cache_size) {
+            misses++;
+            cached_at[index] = misses;
+        }
+    }
+    return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Umfeld.h"
+#include "PGraphics.h"
+#include "Geometry.h"
+
+#include "GLProgram.h"
+#include "IndexedMesh.h"
+
+/**
+ * draws an `IndexedMesh` with `glDrawElements`. meshes with up to 65536 vertices use 16bit
+ * indices, larger meshes 32bit indices. for comparison a list of triangles ( e.g. from
+ * `loadOBJ()` ) can be drawn with `glDrawArrays`.
+ *
+ * the buffer only uploads the position and color of each vertex. it is drawn without lights
+ * with the current transformation.
+ *
+ * NOTE requires OpenGL 3.3. all functions must be called with the OpenGL context of the
+ * sketch.
+ */
+class IndexedVertexBuffer {
+public:
+    IndexedVertexBuffer() = default;
+
+    ~IndexedVertexBuffer() {
+        if (fVertexArray != 0) {
+            glDeleteVertexArrays(1, &fVertexArray);
+            glDeleteBuffers(1, &fVertexBuffer);
+            glDeleteBuffers(1, &fIndexBuffer);
+        }
+    }
+
+    IndexedVertexBuffer(const IndexedVertexBuffer&)            = delete;
+    IndexedVertexBuffer& operator=(const IndexedVertexBuffer&) = delete;
+
+    /* uploads an indexed mesh */
+    void set_mesh(const IndexedMesh& mesh) {
+        if (!init()) {
+            return;
+        }
+        upload_vertices(mesh.vertices);
+        if (mesh.vertices.size() <= 65536) {
+            std::vector<uint16_t> indices(mesh.indices.begin(), mesh.indices.end());
+            upload_indices(indices.data(), indices.size() * sizeof(uint16_t));
+            fIndexType = GL_UNSIGNED_SHORT;
+        } else {
+            upload_indices(mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
+            fIndexType = GL_UNSIGNED_INT;
+        }
+        fIndexCount = mesh.indices.size();
+    }
+
+    /* uploads a list of triangles */
+    void set_triangles(const std::vector<umfeld::Vertex>& triangles) {
+        if (!init()) {
+            return;
+        }
+        upload_vertices(triangles);
+        upload_indices(nullptr, 0);
+        fIndexCount = 0;
+    }
+
+    bool is_indexed() const { return fIndexCount > 0; }
+
+    /* bytes of vertices and indices on the GPU */
+    size_t memory_size() const { return fMemorySize; }
+
+    void draw() const {
+        if (fVertexArray == 0 || fVertexCount == 0) {
+            return;
+        }
+        const GLStateGuard state;
+        fProgram.bind();
+        glBindVertexArray(fVertexArray);
+        if (is_indexed()) {
+            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(fIndexCount), fIndexType, nullptr);
+        } else {
+            glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(fVertexCount));
+        }
+    }
+
+private:
+    struct GPUVertex {
+        float position[3];
+        float color[4];
+    };
+
+    static constexpr const char* VERTEX_SHADER = R"(#version 330 core
+layout(location = 0) in vec3 a_position;
+layout(location = 1) in vec4 a_color;
+uniform mat4 u_view_projection;
+out vec4 v_color;
+void main() {
+    gl_Position = u_view_projection * vec4(a_position, 1.0);
+    v_color     = a_color;
+})";
+
+    GLProgram fProgram{"indexed vertex buffer", VERTEX_SHADER};
+    GLuint    fVertexArray{0};
+    GLuint    fVertexBuffer{0};
+    GLuint    fIndexBuffer{0};
+    GLenum    fIndexType{GL_UNSIGNED_INT};
+    size_t    fVertexCount{0};
+    size_t    fIndexCount{0};
+    size_t    fVertexMemorySize{0};
+    size_t    fMemorySize{0};
+
+    void upload_vertices(const std::vector<umfeld::Vertex>& vertices) {
+        std::vector<GPUVertex> gpu_vertices;
+        gpu_vertices.reserve(vertices.size());
+        for (const auto& v: vertices) {
+            gpu_vertices.push_back({{v.position.x, v.position.y, v.position.z}, {v.color.x, v.color.y, v.color.z, v.color.w}});
+        }
+        {
+            const GLStateGuard state;
+            glBindBuffer(GL_ARRAY_BUFFER, fVertexBuffer);
+            glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(gpu_vertices.size() * sizeof(GPUVertex)), gpu_vertices.data(), GL_STATIC_DRAW);
+        }
+        fVertexCount      = gpu_vertices.size();
+        fVertexMemorySize = gpu_vertices.size() * sizeof(GPUVertex);
+        fMemorySize       = fVertexMemorySize;
+    }
+
+    void upload_indices(const void* indices, const size_t bytes) {
+        /* the index buffer binding is part of the vertex array */
+        {
+            const GLStateGuard state;
+            glBindVertexArray(fVertexArray);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(bytes), indices, GL_STATIC_DRAW);
+        }
+        fMemorySize = fVertexMemorySize + bytes;
+    }
+
+    bool init() {
+        if (fVertexArray != 0) {
+            return true;
+        }
+        if (!fProgram.init()) {
+            return false;
+        }
+        const GLStateGuard state;
+        glGenVertexArrays(1, &fVertexArray);
+        glGenBuffers(1, &fVertexBuffer);
+        glGenBuffers(1, &fIndexBuffer);
+        glBindVertexArray(fVertexArray);
+        glBindBuffer(GL_ARRAY_BUFFER, fVertexBuffer);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, fIndexBuffer);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(GPUVertex), reinterpret_cast<void*>(offsetof(GPUVertex, position)));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(GPUVertex), reinterpret_cast<void*>(offsetof(GPUVertex, color)));
+        return true;
+    }
+};
@@ -0,0 +1,211 @@
+/*
+ * this example shows how to turn the triangles returned by `loadOBJ()` into an indexed mesh
+ * and how to draw it with `glDrawElements`.
+ *
+ * `loadOBJ()` returns three vertices per triangle, i.e. vertices that are shared by several
+ * triangles are duplicated. `create_indexed_mesh()` merges identical vertices and stores an
+ * index per triangle corner instead. `VertexCacheOptimizer` then reorders the triangles so
+ * that the GPU can reuse transformed vertices from its vertex cache.
+ *
+ * the example prepares two meshes: the panda from `Panda.obj` and a large generated terrain
+ * with 294912 triangles in random order ( like a large exported scan ). to benchmark your own
+ * files replace `create_terrain()` with `loadOBJ()`. at startup each mesh is drawn for 60
+ * frames in each mode and the results are printed to the console.
+ *
+ * press `m` to switch between the meshes and `1` to draw the mesh as triangles, `2` to draw
+ * it indexed and `3` to draw it indexed with optimized triangle order.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Umfeld.h"
+#include "Geometry.h"
+
+#include "IndexedMesh.h"
+#include "IndexedVertexBuffer.h"
+#include "VertexCacheOptimizer.h"
+
+using namespace umfeld;
+
+static constexpr int NUMBER_OF_MODES    = 3;
+static constexpr int TERRAIN_RESOLUTION = 384;
+static constexpr int BENCHMARK_FRAMES   = 60;
+static constexpr int BENCHMARK_FINISHED = -1;
+static const char*   MODES[]            = {"TRIANGLES", "INDEXED", "INDEXED + OPTIMIZED"};
+
+struct Model {
+    const char*         name;
+    IndexedVertexBuffer buffers[NUMBER_OF_MODES];
+    float               cache_miss_ratio[NUMBER_OF_MODES];
+    size_t              triangles;
+};
+
+Model* models[2];
+int    model             = 0;
+int    mode              = 0;
+float  frame_time_ms     = 0.0f;
+int    benchmark_frame   = 0;
+float  benchmark_time_ms = 0.0f;
+
+float elapsed_ms(const std::chrono::high_resolution_clock::time_point& start) {
+    return std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+Model* create_model(const char* name, const std::vector<Vertex>& triangles) {
+    auto* m      = new Model();
+    m->name      = name;
+    m->triangles = triangles.size() / 3;
+
+    m->buffers[0].set_triangles(triangles);
+    m->cache_miss_ratio[0] = 3.0f;
+
+    auto        start         = std::chrono::high_resolution_clock::now();
+    IndexedMesh mesh          = create_indexed_mesh(triangles);
+    const float index_time_ms = elapsed_ms(start);
+    m->cache_miss_ratio[1]    = average_cache_miss_ratio(mesh.indices, mesh.vertices.size());
+    m->buffers[1].set_mesh(mesh);
+
+    start = std::chrono::high_resolution_clock::now();
+    VertexCacheOptimizer::optimize(mesh.indices, mesh.vertices.size());
+    optimize_vertex_fetch(mesh);
+    const float optimize_time_ms = elapsed_ms(start);
+    m->cache_miss_ratio[2]       = average_cache_miss_ratio(mesh.indices, mesh.vertices.size());
+    m->buffers[2].set_mesh(mesh);
+
+    char info[256];
+    snprintf(info, sizeof(info), "%s: %zu TRIANGLES / %zu VERTICES -> %zu UNIQUE VERTICES ( INDEXED IN %.1fms, OPTIMIZED IN %.1fms )",
+             name, m->triangles, triangles.size(), mesh.vertices.size(), index_time_ms, optimize_time_ms);
+    console(info);
+    snprintf(info, sizeof(info), "%s: CPU MEMORY %.2fMB AS TRIANGLES / %.2fMB INDEXED",
+             name, triangles.size() * sizeof(Vertex) / 1048576.0f, mesh.memory_size() / 1048576.0f);
+    console(info);
+    return m;
+}
+
+/* a terrain with hills, its triangles are shuffled */
+std::vector<Vertex> create_terrain() {
+    const auto vertex = [](const int x, const int z) {
+        const float u      = static_cast<float>(x) / TERRAIN_RESOLUTION;
+        const float w      = static_cast<float>(z) / TERRAIN_RESOLUTION;
+        const float height = std::sin(u * 12.0f) * std::cos(w * 9.0f) * 0.5f + std::sin((u + w) * 31.0f) * 0.1f;
+        return Vertex(glm::vec3((u - 0.5f) * 600.0f, height * 60.0f, (w - 0.5f) * 600.0f),
+                      glm::vec4(0.3f + height * 0.5f, 0.6f, 0.3f - height * 0.3f, 1.0f),
+                      glm::vec3(u, w, 0.0f));
+    };
+    std::vector<int> quads(TERRAIN_RESOLUTION * TERRAIN_RESOLUTION * 2);
+    for (size_t i = 0; i < quads.size(); ++i) {
+        quads[i] = static_cast<int>(i);
+    }
+    std::shuffle(quads.begin(), quads.end(), std::mt19937(42));
+
+    std::vector<Vertex> triangles;
+    triangles.reserve(quads.size() * 3);
+    for (const int q: quads) {
+        const int x = (q / 2) % TERRAIN_RESOLUTION;
+        const int z = (q / 2) / TERRAIN_RESOLUTION;
+        if (q % 2 == 0) {
+            triangles.push_back(vertex(x, z));
+            triangles.push_back(vertex(x + 1, z));
+            triangles.push_back(vertex(x + 1, z + 1));
+        } else {
+            triangles.push_back(vertex(x, z));
+            triangles.push_back(vertex(x + 1, z + 1));
+            triangles.push_back(vertex(x, z + 1));
+        }
+    }
+    return triangles;
+}
+
+void settings() {
+    size(1024, 768);
+}
+
+void setup() {
+    hint(ENABLE_DEPTH_TEST);
+    models[0] = create_model("PANDA", loadOBJ("Panda.obj"));
+    models[1] = create_model("TERRAIN", create_terrain());
+}
+
+void advance_benchmark() {
+    if (benchmark_frame == BENCHMARK_FINISHED) {
+        return;
+    }
+    benchmark_time_ms += frame_time_ms;
+    benchmark_frame++;
+    if (benchmark_frame < BENCHMARK_FRAMES) {
+        return;
+    }
+    const Model* m = models[model];
+    char         info[160];
+    snprintf(info, sizeof(info), "%-8s %-20s: %7.3fms per draw / GPU MEMORY %6.2fMB / %.2f VERTICES PER TRIANGLE",
+             m->name, MODES[mode], benchmark_time_ms / BENCHMARK_FRAMES, m->buffers[mode].memory_size() / 1048576.0f, m->cache_miss_ratio[mode]);
+    console(info);
+    benchmark_frame   = 0;
+    benchmark_time_ms = 0.0f;
+    mode++;
+    if (mode == NUMBER_OF_MODES) {
+        mode = 0;
+        model++;
+    }
+    if (model == 2) {
+        model           = 0;
+        mode            = 2;
+        benchmark_frame = BENCHMARK_FINISHED;
+    }
+}
+
+void draw() {
+    background(0.85f);
+
+    /* wait for the GPU before and after drawing, so that the frame time includes rendering */
+    glFinish();
+    const auto start = std::chrono::high_resolution_clock::now();
+    pushMatrix();
+    if (model == 0) {
+        translate(width * 0.5f, height * 0.75f);
+        rotateX(PI);
+        rotateY(PI + frameCount * 0.01f);
+        scale(75);
+    } else {
+        translate(width * 0.5f, height * 0.5f, -200.0f);
+        rotateX(0.6f);
+        rotateY(frameCount * 0.005f);
+    }
+    models[model]->buffers[mode].draw();
+    popMatrix();
+    glFinish();
+    frame_time_ms = elapsed_ms(start);
+
+    advance_benchmark();
+
+    const Model* m = models[model];
+    fill(0);
+    debug_text(std::string(m->name) + " " + MODES[mode] + (benchmark_frame != BENCHMARK_FINISHED ? " ( BENCHMARK )" : ""), 10, 10);
+    debug_text("FPS       : " + nf(frameRate, 1), 10, 25);
+    debug_text("DRAW TIME : " + nf(frame_time_ms, 2) + "ms", 10, 40);
+    char info[160];
+    snprintf(info, sizeof(info), "TRIANGLES : %zu / GPU MEMORY: %.2fMB / VERTICES PER TRIANGLE: %.2f",
+             m->triangles, m->buffers[mode].memory_size() / 1048576.0f, m->cache_miss_ratio[mode]);
+    debug_text(info, 10, 55);
+}
+
+void keyPressed() {
+    if (key >= '1' && key <= '0' + NUMBER_OF_MODES) {
+        mode            = key - '1';
+        benchmark_frame = BENCHMARK_FINISHED;
+    }
+    if (key == 'm') {
+        model           = 1 - model;
+        benchmark_frame = BENCHMARK_FINISHED;
+    }
+}
+
+void shutdown() {
+    delete models[0];
+    delete models[1];
+}
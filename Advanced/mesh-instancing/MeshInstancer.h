@@ -0,0 +1,247 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Umfeld.h"
+#include "PGraphics.h"
+#include "Geometry.h"
+#include "VertexBuffer.h"
+
+#include "GLProgram.h"
+
+/**
+ * draws many copies ( *instances* ) of a mesh with one draw call. each instance has its own
+ * transformation and color.
+ *
+ * drawing a mesh several times with `pushMatrix()`, `translate()` and `mesh()` costs a draw
+ * call per copy. `mesh_instanced()` instead uploads the transformations and colors of all
+ * instances to a buffer and draws all of them with one `glDrawArraysInstanced`. the mesh
+ * itself is uploaded once ( call `invalidate()` if its vertices change ).
+ *
+ * instancing requires OpenGL 3.3. for other renderers ( e.g. OpenGL 2.0 or OpenGL ES 3.0 )
+ * the instancer falls back to batching: the vertices of all instances are transformed on
+ * the CPU and collected in one vertex buffer, which is then drawn with a single `mesh()`.
+ *
+ * in both cases the current transformation ( `translate()` etc. ) is applied to all instances
+ * and the instance color is multiplied with the vertex colors. only triangles are supported.
+ *
+ * NOTE all functions must be called from `setup()` or `draw()` i.e. with the OpenGL context
+ * of the sketch.
+ */
+class MeshInstancer {
+public:
+    struct Statistics {
+        uint32_t draw_calls{0};
+        uint32_t instances{0};
+        uint64_t uploaded_bytes{0};
+    };
+
+    MeshInstancer() = default;
+
+    ~MeshInstancer() {
+        for (const auto& [mesh, data]: fMeshes) {
+            glDeleteVertexArrays(1, &data.vertex_array);
+            glDeleteBuffers(1, &data.vertex_buffer);
+        }
+        if (fInstanceBuffer != 0) {
+            glDeleteBuffers(1, &fInstanceBuffer);
+        }
+    }
+
+    MeshInstancer(const MeshInstancer&)            = delete;
+    MeshInstancer& operator=(const MeshInstancer&) = delete;
+
+    /* true for desktop OpenGL 3.3 and later */
+    static bool is_instancing_supported() {
+        const auto* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+        if (version == nullptr || std::strstr(version, "OpenGL ES") != nullptr) {
+            return false;
+        }
+        int major = 0;
+        int minor = 0;
+        return std::sscanf(version, "%d.%d", &major, &minor) == 2 && (major > 3 || (major == 3 && minor >= 3));
+    }
+
+    /* use instancing ( if supported ) or the batching fallback */
+    void set_instancing(const bool enabled) { fInstancing = enabled && is_instancing_supported(); }
+
+    bool is_instancing() const { return fInstancing; }
+
+    /**
+     * draws `mesh` once for every transformation in `transforms`. `colors` holds one color
+     * per instance or is empty ( white ).
+     */
+    void mesh_instanced(umfeld::VertexBuffer* mesh, const std::vector<glm::mat4>& transforms, const std::vector<glm::vec4>& colors = {}) {
+        if (mesh == nullptr || transforms.empty() || mesh->vertices_data().empty()) {
+            return;
+        }
+        if (fInstancing && init_program()) {
+            draw_instanced(mesh, transforms, colors);
+        } else {
+            draw_batched(mesh, transforms, colors);
+        }
+        fStatistics.draw_calls++;
+        fStatistics.instances += static_cast<uint32_t>(transforms.size());
+    }
+
+    /* uploads the vertices of `mesh` again with the next draw */
+    void invalidate(umfeld::VertexBuffer* mesh) {
+        const auto it = fMeshes.find(mesh);
+        if (it != fMeshes.end()) {
+            it->second.dirty = true;
+        }
+    }
+
+    void reset_statistics() { fStatistics = {}; }
+
+    const Statistics& get_statistics() const { return fStatistics; }
+
+private:
+    static constexpr GLuint POSITION_LOCATION       = 0;
+    static constexpr GLuint COLOR_LOCATION          = 1;
+    static constexpr GLuint TRANSFORM_LOCATION      = 2; // a `mat4` uses 4 locations
+    static constexpr GLuint INSTANCE_COLOR_LOCATION = 6;
+
+    static constexpr const char* VERTEX_SHADER = R"(#version 330 core
+layout(location = 0) in vec3 a_position;
+layout(location = 1) in vec4 a_color;
+layout(location = 2) in mat4 a_transform;
+layout(location = 6) in vec4 a_instance_color;
+uniform mat4 u_view_projection;
+out vec4 v_color;
+void main() {
+    gl_Position = u_view_projection * a_transform * vec4(a_position, 1.0);
+    v_color     = a_color * a_instance_color;
+})";
+
+    struct MeshVertex {
+        float position[3];
+        float color[4];
+    };
+
+    struct InstanceData {
+        glm::mat4 transform;
+        glm::vec4 color;
+    };
+
+    struct MeshData {
+        GLuint  vertex_array{0};
+        GLuint  vertex_buffer{0};
+        GLsizei vertex_count{0};
+        bool    dirty{true};
+    };
+
+    bool                                                 fInstancing{true};
+    GLProgram                                            fProgram{"instancing", VERTEX_SHADER};
+    GLuint                                               fInstanceBuffer{0};
+    size_t                                               fInstanceBufferSize{0};
+    std::unordered_map<umfeld::VertexBuffer*, MeshData> fMeshes;
+    std::vector<MeshVertex>                              fMeshVertices;
+    std::vector<InstanceData>                            fInstances;
+    umfeld::VertexBuffer                                 fBatch; // fallback
+    Statistics                                           fStatistics;
+
+    /* creates the instance buffer once. returns false ( and falls back to batching ) if the shader can not be compiled */
+    bool init_program() {
+        if (fInstanceBuffer != 0) {
+            return true;
+        }
+        if (!fProgram.init()) {
+            fInstancing = false;
+            return false;
+        }
+        glGenBuffers(1, &fInstanceBuffer);
+        return true;
+    }
+
+    /* creates the vertex array of a mesh and ( re )uploads its vertices if needed */
+    MeshData& prepare_mesh(umfeld::VertexBuffer* mesh) {
+        MeshData& data = fMeshes[mesh];
+        if (data.vertex_array == 0) {
+            glGenVertexArrays(1, &data.vertex_array);
+            glGenBuffers(1, &data.vertex_buffer);
+            glBindVertexArray(data.vertex_array);
+
+            glBindBuffer(GL_ARRAY_BUFFER, data.vertex_buffer);
+            glEnableVertexAttribArray(POSITION_LOCATION);
+            glVertexAttribPointer(POSITION_LOCATION, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), reinterpret_cast<void*>(offsetof(MeshVertex, position)));
+            glEnableVertexAttribArray(COLOR_LOCATION);
+            glVertexAttribPointer(COLOR_LOCATION, 4, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), reinterpret_cast<void*>(offsetof(MeshVertex, color)));
+
+            /* per instance attributes advance once per instance instead of once per vertex */
+            glBindBuffer(GL_ARRAY_BUFFER, fInstanceBuffer);
+            for (GLuint i = 0; i < 4; ++i) {
+                glEnableVertexAttribArray(TRANSFORM_LOCATION + i);
+                glVertexAttribPointer(TRANSFORM_LOCATION + i, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                                      reinterpret_cast<void*>(offsetof(InstanceData, transform) + i * sizeof(glm::vec4)));
+                glVertexAttribDivisor(TRANSFORM_LOCATION + i, 1);
+            }
+            glEnableVertexAttribArray(INSTANCE_COLOR_LOCATION);
+            glVertexAttribPointer(INSTANCE_COLOR_LOCATION, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), reinterpret_cast<void*>(offsetof(InstanceData, color)));
+            glVertexAttribDivisor(INSTANCE_COLOR_LOCATION, 1);
+        }
+        if (data.dirty) {
+            fMeshVertices.clear();
+            for (const auto& v: mesh->vertices_data()) {
+                fMeshVertices.push_back({{v.position.x, v.position.y, v.position.z}, {v.color.x, v.color.y, v.color.z, v.color.w}});
+            }
+            glBindBuffer(GL_ARRAY_BUFFER, data.vertex_buffer);
+            glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(fMeshVertices.size() * sizeof(MeshVertex)), fMeshVertices.data(), GL_STATIC_DRAW);
+            fStatistics.uploaded_bytes += fMeshVertices.size() * sizeof(MeshVertex);
+            data.vertex_count = static_cast<GLsizei>(fMeshVertices.size());
+            data.dirty        = false;
+        }
+        return data;
+    }
+
+    void draw_instanced(umfeld::VertexBuffer* mesh, const std::vector<glm::mat4>& transforms, const std::vector<glm::vec4>& colors) {
+        /* the renderer keeps its own state, restore it afterwards */
+        const GLStateGuard state;
+
+        fInstances.resize(transforms.size());
+        for (size_t i = 0; i < transforms.size(); ++i) {
+            fInstances[i] = {transforms[i], i < colors.size() ? colors[i] : glm::vec4(1.0f)};
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, fInstanceBuffer);
+        const size_t size = fInstances.size() * sizeof(InstanceData);
+        if (size > fInstanceBufferSize) {
+            glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_STREAM_DRAW);
+            fInstanceBufferSize = size;
+        } else {
+            /* orphan the previous contents, so that the upload does not wait for the last draw */
+            glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(fInstanceBufferSize), nullptr, GL_STREAM_DRAW);
+        }
+        glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(size), fInstances.data());
+        fStatistics.uploaded_bytes += size;
+
+        const MeshData& data = prepare_mesh(mesh);
+        fProgram.bind();
+        glBindVertexArray(data.vertex_array);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, data.vertex_count, static_cast<GLsizei>(transforms.size()));
+    }
+
+    void draw_batched(umfeld::VertexBuffer* mesh, const std::vector<glm::mat4>& transforms, const std::vector<glm::vec4>& colors) {
+        const std::vector<umfeld::Vertex>& vertices = mesh->vertices_data();
+        std::vector<umfeld::Vertex>&       batch    = fBatch.vertices_data();
+        batch.clear();
+        batch.reserve(vertices.size() * transforms.size());
+        for (size_t i = 0; i < transforms.size(); ++i) {
+            const glm::mat4& transform = transforms[i];
+            const glm::vec4  color     = i < colors.size() ? colors[i] : glm::vec4(1.0f);
+            for (const auto& v: vertices) {
+                const glm::vec4 position = transform * glm::vec4(v.position.x, v.position.y, v.position.z, 1.0f);
+                batch.emplace_back(glm::vec3(position), v.color * color, glm::vec3(0.0f));
+            }
+        }
+        fBatch.set_shape(umfeld::TRIANGLES);
+        fBatch.update();
+        umfeld::mesh(&fBatch);
+        fStatistics.uploaded_bytes += batch.size() * sizeof(umfeld::Vertex);
+    }
+};
@@ -0,0 +1,191 @@
+/*
+ * this example shows how to draw many copies of the same mesh with `MeshInstancer`. the
+ * mesh ( a cube ) is uploaded once, the transformation and color of each copy is uploaded
+ * every frame and all copies are drawn with one draw call.
+ *
+ * press `1` to draw 10648 cubes with `pushMatrix()`, `translate()` and `mesh()` ( one draw
+ * call per cube ), `2` to draw them instanced and `3` to draw them with the batching
+ * fallback that is used if instancing is not supported.
+ *
+ * at startup the example runs a benchmark that draws 120 frames in each mode and prints the
+ * average frame time to the console ( press `b` to run it again ). each mode first draws an
+ * untimed warm-up frame, which compiles the shader, uploads the mesh or allocates the batch.
+ * this also works without a GPU e.g. with `LIBGL_ALWAYS_SOFTWARE=1` ( Mesa llvmpipe ) in a
+ * virtual display.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "Umfeld.h"
+#include "Geometry.h"
+#include "VertexBuffer.h"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "MeshInstancer.h"
+
+using namespace umfeld;
+
+static constexpr int   GRID_SIZE          = 22; // 22 * 22 * 22 = 10648 cubes
+static constexpr int   NUMBER_OF_CUBES    = GRID_SIZE * GRID_SIZE * GRID_SIZE;
+static constexpr float CUBE_SPACING       = 18.0f;
+static constexpr int   BENCHMARK_FRAMES   = 120;
+static constexpr int   WARM_UP_FRAMES     = 1; // not timed, see `advance_benchmark()`
+static constexpr int   NUMBER_OF_MODES    = 3;
+static constexpr int   BENCHMARK_FINISHED = -1;
+static const char*     MODES[]            = {"", "CUBES WITH `mesh()`", "CUBES INSTANCED", "CUBES BATCHED"};
+
+MeshInstancer*         instancer;
+VertexBuffer           cube;
+std::vector<glm::mat4> transforms(NUMBER_OF_CUBES);
+std::vector<glm::vec4> colors(NUMBER_OF_CUBES);
+int                    mode            = 1;
+float                  frame_time_ms   = 0.0f;
+int                    benchmark_frame = 0;
+float                  benchmark_time_ms[NUMBER_OF_MODES + 1]{};
+
+void add_face(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& d, const float brightness) {
+    const glm::vec4 color(brightness, brightness, brightness, 1.0f);
+    for (const glm::vec3& p: {a, b, c, a, c, d}) {
+        cube.add_vertex(Vertex(p, color, glm::vec3(0.0f)));
+    }
+}
+
+void settings() {
+    size(1024, 768);
+}
+
+void setup() {
+    hint(ENABLE_DEPTH_TEST);
+
+    /* a unit cube with a different shade of gray per face */
+    const float s = 0.5f;
+    cube.set_shape(TRIANGLES);
+    add_face({-s, -s, s}, {s, -s, s}, {s, s, s}, {-s, s, s}, 1.0f);
+    add_face({s, -s, -s}, {-s, -s, -s}, {-s, s, -s}, {s, s, -s}, 0.55f);
+    add_face({s, -s, s}, {s, -s, -s}, {s, s, -s}, {s, s, s}, 0.85f);
+    add_face({-s, -s, -s}, {-s, -s, s}, {-s, s, s}, {-s, s, -s}, 0.7f);
+    add_face({-s, s, s}, {s, s, s}, {s, s, -s}, {-s, s, -s}, 0.95f);
+    add_face({-s, -s, -s}, {s, -s, -s}, {s, -s, s}, {-s, -s, s}, 0.6f);
+    cube.update();
+
+    for (auto& c: colors) {
+        c = glm::vec4(random(0.5f, 1.0f), random(0.25f), random(0.35f, 1.0f), 1.0f);
+    }
+
+    instancer = new MeshInstancer();
+    if (!MeshInstancer::is_instancing_supported()) {
+        console("instancing is not supported by this renderer, `mesh_instanced()` falls back to batching");
+    }
+}
+
+void update_transforms() {
+    const float time   = frameCount * 0.02f;
+    const float center = (GRID_SIZE - 1) * 0.5f;
+    int         i      = 0;
+    for (int x = 0; x < GRID_SIZE; ++x) {
+        for (int y = 0; y < GRID_SIZE; ++y) {
+            for (int z = 0; z < GRID_SIZE; ++z) {
+                const glm::vec3 position = (glm::vec3(x, y, z) - center) * CUBE_SPACING;
+                const float     size     = 6.0f + 4.0f * std::sin(time + (x + y + z) * 0.3f);
+                glm::mat4       m        = glm::translate(glm::mat4(1.0f), position);
+                m                        = glm::rotate(m, time + i * 0.01f, glm::vec3(0.0f, 1.0f, 0.0f));
+                transforms[i]            = glm::scale(m, glm::vec3(size));
+                i++;
+            }
+        }
+    }
+}
+
+void draw_cubes() {
+    if (mode == 1) {
+        /* same transformations, but only the vertex colors */
+        for (int i = 0; i < NUMBER_OF_CUBES; ++i) {
+            pushMatrix();
+            translate(transforms[i][3].x, transforms[i][3].y, transforms[i][3].z);
+            rotateY(frameCount * 0.02f + i * 0.01f);
+            scale(glm::length(glm::vec3(transforms[i][0])));
+            mesh(&cube);
+            popMatrix();
+        }
+    } else {
+        instancer->set_instancing(mode == 2);
+        instancer->mesh_instanced(&cube, transforms, colors);
+    }
+}
+
+void advance_benchmark() {
+    if (benchmark_frame == BENCHMARK_FINISHED) {
+        return;
+    }
+    /* the first frame of a mode includes one-time setup e.g. compiling the instancing shader */
+    if (benchmark_frame >= WARM_UP_FRAMES) {
+        benchmark_time_ms[mode] += frame_time_ms;
+    }
+    benchmark_frame++;
+    if (benchmark_frame < WARM_UP_FRAMES + BENCHMARK_FRAMES) {
+        return;
+    }
+    console(MODES[mode], ": ", nf(benchmark_time_ms[mode] / BENCHMARK_FRAMES, 3), "ms per frame");
+    benchmark_frame = 0;
+    mode++;
+    if (mode == 2 && !MeshInstancer::is_instancing_supported()) {
+        mode++;
+    }
+    if (mode > NUMBER_OF_MODES) {
+        mode            = 2;
+        benchmark_frame = BENCHMARK_FINISHED;
+    }
+}
+
+void draw() {
+    background(0.85f);
+    update_transforms();
+    instancer->reset_statistics();
+
+    /* wait for the GPU before and after drawing, so that the frame time includes rendering */
+    glFinish();
+    const auto start = std::chrono::high_resolution_clock::now();
+    pushMatrix();
+    translate(width * 0.5f, height * 0.5f, -300.0f);
+    rotateX(frameCount * 0.003f);
+    rotateY(frameCount * 0.005f);
+    draw_cubes();
+    popMatrix();
+    glFinish();
+    const auto end = std::chrono::high_resolution_clock::now();
+    frame_time_ms  = std::chrono::duration<float, std::milli>(end - start).count();
+
+    advance_benchmark();
+
+    const MeshInstancer::Statistics& statistics = instancer->get_statistics();
+    fill(0);
+    debug_text(to_string(NUMBER_OF_CUBES) + " " + MODES[mode] + (benchmark_frame != BENCHMARK_FINISHED ? " ( BENCHMARK )" : ""), 10, 10);
+    debug_text("FPS       : " + nf(frameRate, 1), 10, 25);
+    debug_text("FRAME TIME: " + nf(frame_time_ms, 2) + "ms", 10, 40);
+    char info[160];
+    snprintf(info, sizeof(info), "INSTANCER : %u DRAW CALLS / %u INSTANCES / %.1fKB UPLOADED / INSTANCING %s",
+             statistics.draw_calls, statistics.instances, statistics.uploaded_bytes / 1024.0f,
+             MeshInstancer::is_instancing_supported() ? "SUPPORTED" : "NOT SUPPORTED");
+    debug_text(info, 10, 55);
+}
+
+void keyPressed() {
+    if (key >= '1' && key <= '3') {
+        mode            = key - '0';
+        benchmark_frame = BENCHMARK_FINISHED;
+    }
+    if (key == 'b') {
+        for (float& t: benchmark_time_ms) {
+            t = 0.0f;
+        }
+        mode            = 1;
+        benchmark_frame = 0;
+    }
+}
+
+void shutdown() {
+    delete instancer;
+}
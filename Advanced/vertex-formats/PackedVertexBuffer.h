@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Umfeld.h"
+#include "PGraphics.h"
+
+#include "GLProgram.h"
+
+#include "VertexFormats.h"
+
+/**
+ * common interface of all `PackedVertexBuffer`s, so that buffers with different vertex formats
+ * can be stored and drawn in the same way.
+ */
+class PackedVertexBufferBase {
+public:
+    virtual ~PackedVertexBufferBase() = default;
+
+    /* draws all vertices as `GL_POINTS`, `GL_LINES` or `GL_TRIANGLES` with the current transformation */
+    virtual void   draw(GLenum primitive) = 0;
+    virtual void   update()               = 0;
+    virtual size_t size() const           = 0;
+    virtual size_t vertex_size() const    = 0;
+
+    size_t memory_size() const { return size() * vertex_size(); }
+
+    uint64_t get_uploaded_bytes() const { return fUploadedBytes; }
+
+protected:
+    uint64_t fUploadedBytes{0};
+};
+
+/**
+ * a vertex buffer with a compile-time vertex format `V` ( see `VertexFormats.h` ). the GPU
+ * only receives the bytes of the format, e.g. 16 bytes per vertex for a colored point cloud
+ * instead of the 48 bytes of an uncompressed vertex.
+ *
+ * the shader variant is selected by the format: its `SHADER_DEFINES` enable the attributes
+ * that are present and choose how normals are decoded. vertices without color are drawn in
+ * white, vertices with normals are lit by a light from the top left.
+ *
+ * like with a `VertexBuffer` the vertices are uploaded with the next `draw()` after `update()`.
+ *
+ * NOTE requires OpenGL 3.3. `draw()` and the destructor must be called with the OpenGL context
+ * of the sketch.
+ */
+template<typename V>
+class PackedVertexBuffer final : public PackedVertexBufferBase {
+public:
+    PackedVertexBuffer() = default;
+
+    ~PackedVertexBuffer() override {
+        if (fVertexArray != 0) {
+            glDeleteVertexArrays(1, &fVertexArray);
+            glDeleteBuffers(1, &fVertexBuffer);
+        }
+    }
+
+    PackedVertexBuffer(const PackedVertexBuffer&)            = delete;
+    PackedVertexBuffer& operator=(const PackedVertexBuffer&) = delete;
+
+    void add_vertex(const V& vertex) { fVertices.push_back(vertex); }
+
+    void add_vertex(const glm::vec3& position, const glm::vec4& color = glm::vec4(1.0f), const glm::vec3& normal = glm::vec3(0.0f, 0.0f, 1.0f), const glm::vec2& tex_coord = glm::vec2(0.0f, 0.0f)) {
+        fVertices.push_back(V::create(position, color, normal, tex_coord));
+    }
+
+    std::vector<V>& vertices_data() { return fVertices; }
+
+    void clear() { fVertices.clear(); }
+
+    /* uploads the vertices with the next `draw()` */
+    void update() override { fDirty = true; }
+
+    size_t size() const override { return fVertices.size(); }
+
+    size_t vertex_size() const override { return sizeof(V); }
+
+    void draw(const GLenum primitive) override {
+        if (fVertices.empty()) {
+            return;
+        }
+        /* NOTE after a failed compile `init()` returns false without compiling again */
+        const GLStateGuard state;
+        if (init()) {
+            glBindVertexArray(fVertexArray);
+            if (fDirty) {
+                glBindBuffer(GL_ARRAY_BUFFER, fVertexBuffer);
+                glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(memory_size()), fVertices.data(), GL_STATIC_DRAW);
+                fUploadedBytes += memory_size();
+                fDirty = false;
+            }
+            fProgram.bind();
+            glDrawArrays(primitive, 0, static_cast<GLsizei>(fVertices.size()));
+        }
+    }
+
+private:
+    std::vector<V> fVertices;
+    bool           fDirty{true};
+    GLProgram      fProgram{"packed vertex buffer", std::string("#version 330 core\n") + V::SHADER_DEFINES + VERTEX_SHADER};
+    GLuint         fVertexArray{0};
+    GLuint         fVertexBuffer{0};
+
+    /* the `#version` and the `SHADER_DEFINES` of the format are prepended */
+    static constexpr const char* VERTEX_SHADER = R"(
+layout(location = 0) in vec3 a_position;
+layout(location = 1) in vec4 a_color;
+layout(location = 2) in vec3 a_normal;
+layout(location = 3) in vec2 a_tex_coord;
+uniform mat4 u_view_projection;
+out vec4 v_color;
+
+vec3 decode_octahedral(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) {
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
+
+void main() {
+    gl_Position = u_view_projection * vec4(a_position, 1.0);
+    vec4 color  = vec4(1.0);
+#ifdef HAS_COLOR
+    color = a_color;
+#endif
+#if defined(HAS_NORMAL) || defined(HAS_OCTAHEDRAL_NORMAL)
+#ifdef HAS_OCTAHEDRAL_NORMAL
+    vec3 normal = decode_octahedral(a_normal.xy);
+#else
+    vec3 normal = normalize(a_normal);
+#endif
+    color.rgb *= 0.35 + 0.65 * max(dot(normal, normalize(vec3(-0.5, -0.7, 0.5))), 0.0);
+#endif
+#ifdef HAS_TEX_COORD
+    color.rgb *= 0.8 + 0.2 * step(0.5, fract((floor(a_tex_coord.x * 32.0) + floor(a_tex_coord.y * 16.0)) * 0.5));
+#endif
+    v_color = color;
+})";
+
+    /* compiles the shader variant of the format once and sets up the attributes */
+    bool init() {
+        if (fVertexArray != 0) {
+            return true;
+        }
+        if (!fProgram.init()) {
+            return false;
+        }
+        glGenVertexArrays(1, &fVertexArray);
+        glGenBuffers(1, &fVertexBuffer);
+        glBindVertexArray(fVertexArray);
+        glBindBuffer(GL_ARRAY_BUFFER, fVertexBuffer);
+        for (const vertex_format::Attribute& attribute: V::attributes()) {
+            glEnableVertexAttribArray(attribute.location);
+            glVertexAttribPointer(attribute.location, attribute.size, attribute.type, attribute.normalized, sizeof(V), reinterpret_cast<void*>(attribute.offset));
+        }
+        return true;
+    }
+};
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "Umfeld.h"
+#include "PGraphics.h"
+
+/**
+ * compact vertex formats for `PackedVertexBuffer`. each format is a plain struct that only
+ * stores what it needs, in the smallest type that is precise enough:
+ *
+ * | FORMAT                          | POSITION | COLOR | NORMAL           | TEX COORD | BYTES |
+ * |---------------------------------|----------|-------|------------------|-----------|-------|
+ * | `VertexFloat`                   | float    | float | float            | float     | 48    |
+ * | `VertexPosition`                | float    |       |                  |           | 12    |
+ * | `VertexPositionColor`           | float    | RGBA8 |                  |           | 16    |
+ * | `VertexPositionColorHalfNormal` | float    | RGBA8 | half float       |           | 24    |
+ * | `VertexPositionColorNormal`     | float    | RGBA8 | octahedral 16bit |           | 20    |
+ * | `VertexPositionColorNormalUV`   | float    | RGBA8 | octahedral 16bit | 16bit     | 24    |
+ *
+ * every format describes its memory layout with `attributes()` and selects the matching
+ * shader variant with `SHADER_DEFINES`. all formats are created from the same values with
+ * `create()`, so that they can be used interchangeably in templates.
+ */
+
+namespace vertex_format {
+    /* attribute locations used by the shader of `PackedVertexBuffer` */
+    enum Location : GLuint {
+        POSITION  = 0,
+        COLOR     = 1,
+        NORMAL    = 2,
+        TEX_COORD = 3
+    };
+
+    struct Attribute {
+        GLuint    location;
+        GLint     size;
+        GLenum    type;
+        GLboolean normalized;
+        size_t    offset;
+    };
+
+    /* RGBA8: color components in [0,1] as normalized bytes */
+    inline void pack_rgba8(const glm::vec4& color, uint8_t* packed) {
+        packed[0] = static_cast<uint8_t>(std::round(std::clamp(color.x, 0.0f, 1.0f) * 255.0f));
+        packed[1] = static_cast<uint8_t>(std::round(std::clamp(color.y, 0.0f, 1.0f) * 255.0f));
+        packed[2] = static_cast<uint8_t>(std::round(std::clamp(color.z, 0.0f, 1.0f) * 255.0f));
+        packed[3] = static_cast<uint8_t>(std::round(std::clamp(color.w, 0.0f, 1.0f) * 255.0f));
+    }
+
+    /* 16bit IEEE half float ( rounded to nearest, too large values become infinity ) */
+    inline uint16_t pack_half(const float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const auto     sign     = static_cast<uint16_t>((bits >> 16) & 0x8000);
+        const int32_t  exponent = static_cast<int32_t>((bits >> 23) & 0xFF) - 127 + 15;
+        const uint32_t mantissa = bits & 0x7FFFFF;
+        if (((bits >> 23) & 0xFF) == 0xFF) {
+            return sign | 0x7C00 | (mantissa != 0 ? 0x200 : 0); // infinity or NaN
+        }
+        if (exponent >= 31) {
+            return sign | 0x7C00;
+        }
+        if (exponent <= 0) {
+            if (exponent < -10) {
+                return sign; // too small, zero
+            }
+            /* subnormal */
+            const uint32_t m     = mantissa | 0x800000;
+            const int      shift = 14 - exponent;
+            return sign | static_cast<uint16_t>((m + (1u << (shift - 1))) >> shift);
+        }
+        /* the rounding carry may overflow into the exponent, which is the correct result */
+        return sign | static_cast<uint16_t>(((static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13)) + ((mantissa >> 12) & 1));
+    }
+
+    /* 16bit normalized unsigned integer for values in [0,1] */
+    inline uint16_t pack_unorm16(const float value) {
+        return static_cast<uint16_t>(std::round(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+    }
+
+    /* 16bit normalized signed integer for values in [-1,1] */
+    inline int16_t pack_snorm16(const float value) {
+        return static_cast<int16_t>(std::round(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+    }
+
+    /**
+     * maps a unit vector onto the faces of an octahedron which is unfolded into a square. two
+     * 16bit components are more precise than three 8bit components and only use 4 bytes.
+     */
+    inline void pack_octahedral(const glm::vec3& normal, int16_t* packed) {
+        const float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+        float       x      = length > 0.0f ? normal.x / length : 0.0f;
+        float       y      = length > 0.0f ? normal.y / length : 0.0f;
+        if (normal.z < 0.0f) {
+            const float folded_x = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+            const float folded_y = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+            x                    = folded_x;
+            y                    = folded_y;
+        }
+        packed[0] = pack_snorm16(x);
+        packed[1] = pack_snorm16(y);
+    }
+} // namespace vertex_format
+
+/* uncompressed reference format, roughly the size of a `Vertex` from `Geometry.h` */
+struct VertexFloat {
+    glm::vec3 position;
+    glm::vec4 color;
+    glm::vec3 normal;
+    glm::vec2 tex_coord;
+
+    static constexpr const char* SHADER_DEFINES = "#define HAS_COLOR\n#define HAS_NORMAL\n#define HAS_TEX_COORD\n";
+
+    static std::vector<vertex_format::Attribute> attributes() {
+        return {{vertex_format::POSITION, 3, GL_FLOAT, GL_FALSE, offsetof(VertexFloat, position)},
+                {vertex_format::COLOR, 4, GL_FLOAT, GL_FALSE, offsetof(VertexFloat, color)},
+                {vertex_format::NORMAL, 3, GL_FLOAT, GL_FALSE, offsetof(VertexFloat, normal)},
+                {vertex_format::TEX_COORD, 2, GL_FLOAT, GL_FALSE, offsetof(VertexFloat, tex_coord)}};
+    }
+
+    static VertexFloat create(const glm::vec3& position, const glm::vec4& color, const glm::vec3& normal, const glm::vec2& tex_coord) {
+        return {position, color, normal, tex_coord};
+    }
+};
+
+/* e.g. for point clouds with a single color */
+struct VertexPosition {
+    glm::vec3 position;
+
+    static constexpr const char* SHADER_DEFINES = "";
+
+    static std::vector<vertex_format::Attribute> attributes() {
+        return {{vertex_format::POSITION, 3, GL_FLOAT, GL_FALSE, offsetof(VertexPosition, position)}};
+    }
+
+    static VertexPosition create(const glm::vec3& position, const glm::vec4&, const glm::vec3&, const glm::vec2&) {
+        return {position};
+    }
+};
+
+/* e.g. for colored point clouds and lines */
+struct VertexPositionColor {
+    glm::vec3 position;
+    uint8_t   color[4];
+
+    static constexpr const char* SHADER_DEFINES = "#define HAS_COLOR\n";
+
+    static std::vector<vertex_format::Attribute> attributes() {
+        return {{vertex_format::POSITION, 3, GL_FLOAT, GL_FALSE, offsetof(VertexPositionColor, position)},
+                {vertex_format::COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, offsetof(VertexPositionColor, color)}};
+    }
+
+    static VertexPositionColor create(const glm::vec3& position, const glm::vec4& color, const glm::vec3&, const glm::vec2&) {
+        VertexPositionColor v{position, {}};
+        vertex_format::pack_rgba8(color, v.color);
+        return v;
+    }
+};
+
+/* normals as half floats, the fourth component pads the normal to 8 bytes */
+struct VertexPositionColorHalfNormal {
+    glm::vec3 position;
+    uint8_t   color[4];
+    uint16_t  normal[4];
+
+    static constexpr const char* SHADER_DEFINES = "#define HAS_COLOR\n#define HAS_NORMAL\n";
+
+    static std::vector<vertex_format::Attribute> attributes() {
+        return {{vertex_format::POSITION, 3, GL_FLOAT, GL_FALSE, offsetof(VertexPositionColorHalfNormal, position)},
+                {vertex_format::COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, offsetof(VertexPositionColorHalfNormal, color)},
+                {vertex_format::NORMAL, 3, GL_HALF_FLOAT, GL_FALSE, offsetof(VertexPositionColorHalfNormal, normal)}};
+    }
+
+    static VertexPositionColorHalfNormal create(const glm::vec3& position, const glm::vec4& color, const glm::vec3& normal, const glm::vec2&) {
+        VertexPositionColorHalfNormal v{position, {}, {vertex_format::pack_half(normal.x), vertex_format::pack_half(normal.y), vertex_format::pack_half(normal.z), 0}};
+        vertex_format::pack_rgba8(color, v.color);
+        return v;
+    }
+};
+
+/* e.g. for lit scans */
+struct VertexPositionColorNormal {
+    glm::vec3 position;
+    uint8_t   color[4];
+    int16_t   normal[2];
+
+    static constexpr const char* SHADER_DEFINES = "#define HAS_COLOR\n#define HAS_OCTAHEDRAL_NORMAL\n";
+
+    static std::vector<vertex_format::Attribute> attributes() {
+        return {{vertex_format::POSITION, 3, GL_FLOAT, GL_FALSE, offsetof(VertexPositionColorNormal, position)},
+                {vertex_format::COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, offsetof(VertexPositionColorNormal, color)},
+                {vertex_format::NORMAL, 2, GL_SHORT, GL_TRUE, offsetof(VertexPositionColorNormal, normal)}};
+    }
+
+    static VertexPositionColorNormal create(const glm::vec3& position, const glm::vec4& color, const glm::vec3& normal, const glm::vec2&) {
+        VertexPositionColorNormal v{position, {}, {}};
+        vertex_format::pack_rgba8(color, v.color);
+        vertex_format::pack_octahedral(normal, v.normal);
+        return v;
+    }
+};
+
+/* e.g. for textured meshes, texture coordinates must be in [0,1] */
+struct VertexPositionColorNormalUV {
+    glm::vec3 position;
+    uint8_t   color[4];
+    int16_t   normal[2];
+    uint16_t  tex_coord[2];
+
+    static constexpr const char* SHADER_DEFINES = "#define HAS_COLOR\n#define HAS_OCTAHEDRAL_NORMAL\n#define HAS_TEX_COORD\n";
+
+    static std::vector<vertex_format::Attribute> attributes() {
+        return {{vertex_format::POSITION, 3, GL_FLOAT, GL_FALSE, offsetof(VertexPositionColorNormalUV, position)},
+                {vertex_format::COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, offsetof(VertexPositionColorNormalUV, color)},
+                {vertex_format::NORMAL, 2, GL_SHORT, GL_TRUE, offsetof(VertexPositionColorNormalUV, normal)},
+                {vertex_format::TEX_COORD, 2, GL_UNSIGNED_SHORT, GL_TRUE, offsetof(VertexPositionColorNormalUV, tex_coord)}};
+    }
+
+    static VertexPositionColorNormalUV create(const glm::vec3& position, const glm::vec4& color, const glm::vec3& normal, const glm::vec2& tex_coord) {
+        VertexPositionColorNormalUV v{position, {}, {}, {vertex_format::pack_unorm16(tex_coord.x), vertex_format::pack_unorm16(tex_coord.y)}};
+        vertex_format::pack_rgba8(color, v.color);
+        vertex_format::pack_octahedral(normal, v.normal);
+        return v;
+    }
+};
+
+static_assert(sizeof(VertexFloat) == 48, "unexpected vertex size");
+static_assert(sizeof(VertexPosition) == 12, "unexpected vertex size");
+static_assert(sizeof(VertexPositionColor) == 16, "unexpected vertex size");
+static_assert(sizeof(VertexPositionColorHalfNormal) == 24, "unexpected vertex size");
+static_assert(sizeof(VertexPositionColorNormal) == 20, "unexpected vertex size");
+static_assert(sizeof(VertexPositionColorNormalUV) == 24, "unexpected vertex size");
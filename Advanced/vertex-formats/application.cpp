@@ -0,0 +1,168 @@
+/*
+ * this example shows how compact vertex formats reduce the memory and upload bandwidth of
+ * large meshes. a scan-like point cloud with 1048576 points is stored in a `PackedVertexBuffer`
+ * with one of six vertex formats ( see `VertexFormats.h` ), from 48 bytes per vertex
+ * ( everything as float ) down to 12 bytes ( position only ).
+ *
+ * press `1` to `6` to select the vertex format and `u` to upload the vertices every frame
+ * ( like a scan that is still being recorded ). at startup the example runs a benchmark
+ * that uploads and draws each format for 60 frames ( after one untimed warm-up frame ) and
+ * prints the results to the console.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "Umfeld.h"
+
+#include "PackedVertexBuffer.h"
+#include "VertexFormats.h"
+
+using namespace umfeld;
+
+static constexpr int NUMBER_OF_POINTS   = 1 << 20;
+static constexpr int NUMBER_OF_FORMATS  = 6;
+static constexpr int BENCHMARK_FRAMES   = 60;
+static constexpr int WARMUP_FRAMES      = 1; // the first draw of a format compiles its shader and creates the vertex array
+static constexpr int BENCHMARK_FINISHED = -1;
+static const char*   FORMATS[]          = {"",
+                                           "FLOAT ( POSITION, COLOR, NORMAL, TEX COORD )",
+                                           "POSITION",
+                                           "POSITION + RGBA8",
+                                           "POSITION + RGBA8 + HALF FLOAT NORMAL",
+                                           "POSITION + RGBA8 + OCTAHEDRAL NORMAL",
+                                           "POSITION + RGBA8 + OCTAHEDRAL NORMAL + 16BIT UV"};
+
+std::vector<VertexFloat> scan(NUMBER_OF_POINTS);
+PackedVertexBufferBase*  points             = nullptr;
+int                      format             = 0;
+bool                     upload_every_frame = false;
+float                    frame_time_ms      = 0.0f;
+float                    convert_time_ms    = 0.0f;
+int                      benchmark_frame    = 0;
+float                    benchmark_time_ms  = 0.0f;
+
+/* a sphere with bumps, colored by height */
+void create_scan() {
+    for (auto& v: scan) {
+        const float     u         = random(1.0f);
+        const float     w         = random(1.0f);
+        const float     theta     = u * TWO_PI;
+        const float     phi       = std::acos(1.0f - 2.0f * w);
+        const glm::vec3 direction = glm::vec3(std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta));
+        const float     bump      = 0.08f * std::sin(theta * 7.0f) * std::sin(phi * 9.0f);
+        v.position                = direction * (250.0f * (1.0f + bump));
+        v.normal                  = direction;
+        v.color                   = glm::vec4(0.5f + bump * 5.0f, 0.55f, 0.9f - bump * 5.0f, 1.0f);
+        v.tex_coord               = glm::vec2(u, w);
+    }
+}
+
+template<typename V>
+PackedVertexBufferBase* create_points() {
+    auto* buffer = new PackedVertexBuffer<V>();
+    buffer->vertices_data().reserve(scan.size());
+    for (const auto& v: scan) {
+        buffer->add_vertex(v.position, v.color, v.normal, v.tex_coord);
+    }
+    buffer->update();
+    return buffer;
+}
+
+void select_format(const int selected_format) {
+    delete points;
+    const auto start = std::chrono::high_resolution_clock::now();
+    switch (selected_format) {
+        case 1: points = create_points<VertexFloat>(); break;
+        case 2: points = create_points<VertexPosition>(); break;
+        case 3: points = create_points<VertexPositionColor>(); break;
+        case 4: points = create_points<VertexPositionColorHalfNormal>(); break;
+        case 5: points = create_points<VertexPositionColorNormal>(); break;
+        default: points = create_points<VertexPositionColorNormalUV>(); break;
+    }
+    const auto end  = std::chrono::high_resolution_clock::now();
+    convert_time_ms = std::chrono::duration<float, std::milli>(end - start).count();
+    format          = selected_format;
+}
+
+void settings() {
+    size(1024, 768);
+}
+
+void setup() {
+    hint(ENABLE_DEPTH_TEST);
+    create_scan();
+    select_format(1);
+}
+
+void advance_benchmark() {
+    if (benchmark_frame == BENCHMARK_FINISHED) {
+        return;
+    }
+    benchmark_frame++;
+    if (benchmark_frame <= WARMUP_FRAMES) {
+        return;
+    }
+    benchmark_time_ms += frame_time_ms;
+    if (benchmark_frame < WARMUP_FRAMES + BENCHMARK_FRAMES) {
+        return;
+    }
+    char info[160];
+    snprintf(info, sizeof(info), "%2zu BYTES / %6.1fMB: %7.3fms per upload and draw ( %s )",
+             points->vertex_size(), points->memory_size() / 1048576.0f, benchmark_time_ms / BENCHMARK_FRAMES, FORMATS[format]);
+    console(info);
+    benchmark_frame   = 0;
+    benchmark_time_ms = 0.0f;
+    if (format < NUMBER_OF_FORMATS) {
+        select_format(format + 1);
+    } else {
+        benchmark_frame = BENCHMARK_FINISHED;
+    }
+}
+
+void draw() {
+    background(0.1f);
+    if (upload_every_frame || benchmark_frame != BENCHMARK_FINISHED) {
+        points->update();
+    }
+
+    /* wait for the GPU before and after drawing, so that the frame time includes the upload and rendering */
+    glFinish();
+    const auto start = std::chrono::high_resolution_clock::now();
+    pushMatrix();
+    translate(width * 0.5f, height * 0.5f, -100.0f);
+    rotateX(0.3f);
+    rotateY(frameCount * 0.01f);
+    points->draw(GL_POINTS);
+    popMatrix();
+    glFinish();
+    const auto end = std::chrono::high_resolution_clock::now();
+    frame_time_ms  = std::chrono::duration<float, std::milli>(end - start).count();
+
+    advance_benchmark();
+
+    fill(1);
+    debug_text(FORMATS[format] + std::string(benchmark_frame != BENCHMARK_FINISHED ? " ( BENCHMARK )" : ""), 10, 10);
+    debug_text("FPS       : " + nf(frameRate, 1), 10, 25);
+    debug_text("FRAME TIME: " + nf(frame_time_ms, 2) + "ms" + (upload_every_frame ? " ( UPLOADING EVERY FRAME )" : ""), 10, 40);
+    char info[160];
+    snprintf(info, sizeof(info), "MEMORY    : %zu POINTS * %zu BYTES = %.1fMB ( CONVERTED IN %.1fms )",
+             points->size(), points->vertex_size(), points->memory_size() / 1048576.0f, convert_time_ms);
+    debug_text(info, 10, 55);
+}
+
+void keyPressed() {
+    if (key >= '1' && key <= '0' + NUMBER_OF_FORMATS) {
+        benchmark_frame = BENCHMARK_FINISHED;
+        select_format(key - '0');
+    }
+    if (key == 'u') {
+        upload_every_frame = !upload_every_frame;
+    }
+}
+
+void shutdown() {
+    delete points;
+}
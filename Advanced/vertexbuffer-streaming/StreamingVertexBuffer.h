@@ -0,0 +1,337 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Umfeld.h"
+#include "PGraphics.h"
+
+#include "GLProgram.h"
+
+/**
+ * a vertex buffer for triangles that change every frame. instead of uploading all vertices
+ * whenever something changed, it only uploads the vertices that were changed.
+ *
+ * - changes are tracked as dirty ranges. `add_vertex()` and `set_vertex()` mark their range
+ *   automatically, after changing `vertices_data()` directly call `mark_dirty()`.
+ * - the storage on the GPU grows geometrically ( it doubles ). when it grows, the vertices
+ *   that are already on the GPU are copied on the GPU, not uploaded again.
+ * - changed vertices are written to a ring of 3 staging segments and copied from there
+ *   into the storage. a fence per segment tells when the GPU has finished reading it, so the
+ *   CPU writes to one segment while the GPU still reads from the other two and never waits
+ *   for a buffer in flight ( `Statistics::ring_waits` counts the times it had to wait ).
+ *
+ * for comparison `set_streaming(false)` uploads all vertices with every draw, i.e. the way a
+ * `VertexBuffer` does it.
+ *
+ * NOTE requires OpenGL 3.3. all functions that access the GPU ( `draw()` and the destructor )
+ * must be called with the OpenGL context of the sketch.
+ */
+class StreamingVertexBuffer {
+public:
+    struct Vertex {
+        glm::vec3 position;
+        glm::vec4 color;
+    };
+
+    struct Statistics {
+        uint64_t uploaded_bytes{0};
+        uint32_t uploaded_ranges{0};
+        uint32_t storage_reallocations{0}; // the storage on the GPU grew
+        uint32_t ring_reallocations{0};    // the staging ring grew
+        uint32_t ring_waits{0};
+    };
+
+    static constexpr int    RING_SEGMENTS = 3;
+    static constexpr size_t MAX_RANGES    = 64; // more ranges are merged into one
+    static constexpr size_t MERGE_GAP     = 16; // ranges closer than this are merged
+
+    StreamingVertexBuffer() = default;
+
+    ~StreamingVertexBuffer() {
+        for (GLsync& fence: fFences) {
+            delete_fence(fence);
+        }
+        if (fVertexArray != 0) {
+            glDeleteVertexArrays(1, &fVertexArray);
+        }
+        if (fStorageBuffer != 0) {
+            glDeleteBuffers(1, &fStorageBuffer);
+        }
+        if (fRingBuffer != 0) {
+            glDeleteBuffers(1, &fRingBuffer);
+        }
+    }
+
+    StreamingVertexBuffer(const StreamingVertexBuffer&)            = delete;
+    StreamingVertexBuffer& operator=(const StreamingVertexBuffer&) = delete;
+
+    void add_vertex(const Vertex& vertex) {
+        fVertices.push_back(vertex);
+        mark_dirty(fVertices.size() - 1, fVertices.size());
+    }
+
+    void set_vertex(const size_t index, const Vertex& vertex) {
+        fVertices[index] = vertex;
+        mark_dirty(index, index + 1);
+    }
+
+    /* vertices changed here must be marked with `mark_dirty()` */
+    std::vector<Vertex>& vertices_data() { return fVertices; }
+
+    size_t size() const { return fVertices.size(); }
+
+    /* vertex capacity of the storage on the GPU */
+    size_t capacity() const { return fCapacity; }
+
+    /* marks the vertices from `begin` up to ( but not including ) `end` for upload */
+    void mark_dirty(const size_t begin, const size_t end) {
+        if (begin >= end) {
+            return;
+        }
+        if (!fDirtyRanges.empty()) {
+            Range& last = fDirtyRanges.back();
+            if (begin <= last.end + MERGE_GAP && end + MERGE_GAP >= last.begin) {
+                last.begin = std::min(last.begin, begin);
+                last.end   = std::max(last.end, end);
+                return;
+            }
+        }
+        fDirtyRanges.push_back({begin, end});
+        if (fDirtyRanges.size() > MAX_RANGES) {
+            merge_dirty_ranges();
+        }
+    }
+
+    void clear() {
+        fVertices.clear();
+        fDirtyRanges.clear();
+        fUploadedVertices = 0;
+    }
+
+    void set_streaming(const bool streaming) {
+        fStreaming = streaming;
+        fDirtyRanges.clear();
+        mark_dirty(0, fVertices.size());
+    }
+
+    bool is_streaming() const { return fStreaming; }
+
+    /* uploads the changed vertices and draws all vertices as triangles with the current transformation */
+    void draw() {
+        if (fVertices.empty() || !init()) {
+            return;
+        }
+        const GLStateGuard state;
+        if (fStreaming) {
+            upload_dirty_ranges();
+        } else {
+            upload_all();
+        }
+
+        fProgram.bind();
+        glBindVertexArray(fVertexArray);
+        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(fVertices.size() - fVertices.size() % 3));
+    }
+
+    void reset_statistics() { fStatistics = {}; }
+
+    const Statistics& get_statistics() const { return fStatistics; }
+
+private:
+    static constexpr size_t MIN_CAPACITY     = 1024;
+    static constexpr size_t MIN_SEGMENT_SIZE = 64 * 1024;
+
+    static constexpr const char* VERTEX_SHADER = R"(#version 330 core
+layout(location = 0) in vec3 a_position;
+layout(location = 1) in vec4 a_color;
+uniform mat4 u_view_projection;
+out vec4 v_color;
+void main() {
+    gl_Position = u_view_projection * vec4(a_position, 1.0);
+    v_color     = a_color;
+})";
+
+    struct Range {
+        size_t begin;
+        size_t end;
+    };
+
+    std::vector<Vertex> fVertices;
+    std::vector<Range>  fDirtyRanges;
+    bool                fStreaming{true};
+    GLProgram           fProgram{"streaming vertex buffer", VERTEX_SHADER};
+    GLuint              fVertexArray{0};
+    GLuint              fStorageBuffer{0};
+    size_t              fCapacity{0};
+    size_t              fUploadedVertices{0}; // vertices that are valid in the storage
+    GLuint              fRingBuffer{0};
+    size_t              fSegmentSize{0};
+    int                 fSegment{0};
+    GLsync              fFences[RING_SEGMENTS]{};
+    Statistics          fStatistics;
+
+    static void delete_fence(GLsync& fence) {
+        if (fence != nullptr) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+
+    /* sorts the ranges and merges the ones that overlap or are close. if there are still too many, merges all of them */
+    void merge_dirty_ranges() {
+        std::sort(fDirtyRanges.begin(), fDirtyRanges.end(), [](const Range& a, const Range& b) { return a.begin < b.begin; });
+        size_t merged = 0;
+        for (size_t i = 1; i < fDirtyRanges.size(); ++i) {
+            if (fDirtyRanges[i].begin <= fDirtyRanges[merged].end + MERGE_GAP) {
+                fDirtyRanges[merged].end = std::max(fDirtyRanges[merged].end, fDirtyRanges[i].end);
+            } else {
+                fDirtyRanges[++merged] = fDirtyRanges[i];
+            }
+        }
+        fDirtyRanges.resize(merged + 1);
+        if (fDirtyRanges.size() > MAX_RANGES / 2) {
+            fDirtyRanges = {{fDirtyRanges.front().begin, fDirtyRanges.back().end}};
+        }
+    }
+
+    bool init() {
+        if (fVertexArray != 0) {
+            return true;
+        }
+        if (!fProgram.init()) {
+            return false;
+        }
+        glGenVertexArrays(1, &fVertexArray);
+        glGenBuffers(1, &fStorageBuffer);
+        glGenBuffers(1, &fRingBuffer);
+        return true;
+    }
+
+    void bind_vertex_array() const {
+        glBindVertexArray(fVertexArray);
+        glBindBuffer(GL_ARRAY_BUFFER, fStorageBuffer);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, position)));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, color)));
+    }
+
+    /* doubles the storage until it holds all vertices and copies the vertices that are already uploaded */
+    void reserve_storage() {
+        if (fVertices.size() <= fCapacity) {
+            return;
+        }
+        size_t capacity = std::max(fCapacity, MIN_CAPACITY);
+        while (capacity < fVertices.size()) {
+            capacity *= 2;
+        }
+        GLuint storage;
+        glGenBuffers(1, &storage);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, storage);
+        glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(capacity * sizeof(Vertex)), nullptr, GL_DYNAMIC_DRAW);
+        if (fUploadedVertices > 0) {
+            glBindBuffer(GL_COPY_READ_BUFFER, fStorageBuffer);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, static_cast<GLsizeiptr>(fUploadedVertices * sizeof(Vertex)));
+        }
+        glDeleteBuffers(1, &fStorageBuffer);
+        fStorageBuffer = storage;
+        fCapacity      = capacity;
+        fStatistics.storage_reallocations++;
+        bind_vertex_array();
+    }
+
+    /* returns the segment of the ring that is written next. waits only if the GPU still reads from it */
+    size_t acquire_segment(const size_t bytes) {
+        fSegment = (fSegment + 1) % RING_SEGMENTS;
+        glBindBuffer(GL_COPY_READ_BUFFER, fRingBuffer);
+        if (bytes > fSegmentSize) {
+            /* a new ring ( the old one is orphaned and released by the driver once the GPU is done with it ) */
+            fSegmentSize = std::max(MIN_SEGMENT_SIZE, fSegmentSize);
+            while (fSegmentSize < bytes) {
+                fSegmentSize *= 2;
+            }
+            glBufferData(GL_COPY_READ_BUFFER, static_cast<GLsizeiptr>(fSegmentSize * RING_SEGMENTS), nullptr, GL_STREAM_DRAW);
+            for (GLsync& fence: fFences) {
+                delete_fence(fence);
+            }
+            fStatistics.ring_reallocations++;
+        }
+        GLsync& fence = fFences[fSegment];
+        if (fence != nullptr) {
+            if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+                fStatistics.ring_waits++;
+                glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+            }
+            delete_fence(fence);
+        }
+        return fSegment * fSegmentSize;
+    }
+
+    void upload_dirty_ranges() {
+        if (fDirtyRanges.empty()) {
+            return;
+        }
+        merge_dirty_ranges();
+        for (Range& range: fDirtyRanges) {
+            range.end = std::min(range.end, fVertices.size());
+        }
+        size_t bytes = 0;
+        for (const Range& range: fDirtyRanges) {
+            bytes += range.begin < range.end ? (range.end - range.begin) * sizeof(Vertex) : 0;
+        }
+        reserve_storage();
+        if (bytes > 0) {
+            /* no synchronization needed, the fence of the segment guarantees that the GPU is done with it */
+            const size_t     offset = acquire_segment(bytes);
+            const GLbitfield flags  = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+            auto*            data   = static_cast<uint8_t*>(glMapBufferRange(GL_COPY_READ_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(bytes), flags));
+            if (data != nullptr) {
+                size_t position = 0;
+                for (const Range& range: fDirtyRanges) {
+                    if (range.begin < range.end) {
+                        std::memcpy(data + position, &fVertices[range.begin], (range.end - range.begin) * sizeof(Vertex));
+                        position += (range.end - range.begin) * sizeof(Vertex);
+                    }
+                }
+                glUnmapBuffer(GL_COPY_READ_BUFFER);
+
+                glBindBuffer(GL_COPY_WRITE_BUFFER, fStorageBuffer);
+                position = 0;
+                for (const Range& range: fDirtyRanges) {
+                    if (range.begin < range.end) {
+                        const size_t range_bytes = (range.end - range.begin) * sizeof(Vertex);
+                        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(offset + position),
+                                            static_cast<GLintptr>(range.begin * sizeof(Vertex)), static_cast<GLsizeiptr>(range_bytes));
+                        position += range_bytes;
+                        fStatistics.uploaded_ranges++;
+                    }
+                }
+                fFences[fSegment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+                fStatistics.uploaded_bytes += bytes;
+            } else {
+                umfeld::error("could not map streaming vertex buffer");
+            }
+        }
+        fUploadedVertices = fVertices.size();
+        fDirtyRanges.clear();
+    }
+
+    void upload_all() {
+        glBindBuffer(GL_ARRAY_BUFFER, fStorageBuffer);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(fVertices.size() * sizeof(Vertex)), fVertices.data(), GL_DYNAMIC_DRAW);
+        if (fCapacity != fVertices.size()) {
+            fCapacity = fVertices.size();
+            fStatistics.storage_reallocations++;
+            bind_vertex_array();
+        }
+        fStatistics.uploaded_bytes += fVertices.size() * sizeof(Vertex);
+        fStatistics.uploaded_ranges++;
+        fUploadedVertices = fVertices.size();
+        fDirtyRanges.clear();
+    }
+};
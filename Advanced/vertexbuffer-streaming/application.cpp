@@ -0,0 +1,103 @@
+/*
+ * this example shows how to stream vertices that change every frame to the GPU with a
+ * `StreamingVertexBuffer`. like in the `vertexbuffer` example 256 vertices are added every
+ * frame, but only the newest 4096 vertices keep moving, the older ones stay in place.
+ *
+ * a `VertexBuffer` uploads all vertices whenever something changed, i.e. the upload grows
+ * with every frame. the streaming vertex buffer only uploads the vertices that were added or
+ * moved ( about 120KB per frame ), no matter how many vertices there are. its storage on the
+ * GPU grows by doubling, so it is rarely reallocated.
+ *
+ * press `s` to switch between streaming and uploading all vertices, `+` to switch between
+ * 256 and 4096 new vertices per frame and `SPACE` to clear the buffer. the statistics show
+ * the uploaded bytes and the time needed to upload and draw the vertices.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#include "Umfeld.h"
+
+#include "StreamingVertexBuffer.h"
+
+using namespace umfeld;
+
+static constexpr size_t MOVING_VERTICES = 4096;
+
+StreamingVertexBuffer* mesh_shape;
+int                    vertices_per_frame = 256;
+float                  draw_time_ms       = 0.0f;
+
+void add_vertices(const float x, const float y, const int count) {
+    for (int i = 0; i < count; ++i) {
+        mesh_shape->add_vertex({glm::vec3(x + random(-10, 10), y + random(-10, 10), random(-10, 10)),
+                                glm::vec4(random(1.0f), random(1.0f), random(1.0f), 1.0f)});
+    }
+}
+
+void settings() {
+    size(1024, 768);
+}
+
+void setup() {
+    mesh_shape = new StreamingVertexBuffer();
+    add_vertices(width / 2, height / 2, 2048);
+}
+
+void draw() {
+    background(0.85f);
+    mesh_shape->reset_statistics();
+
+    if (!isMousePressed) {
+        /* move the newest vertices and mark them as changed */
+        std::vector<StreamingVertexBuffer::Vertex>& vertices = mesh_shape->vertices_data();
+        const size_t                                first    = vertices.size() > MOVING_VERTICES ? vertices.size() - MOVING_VERTICES : 0;
+        for (size_t i = first; i < vertices.size(); ++i) {
+            vertices[i].position += glm::vec3(random(-1, 1), random(-1, 1), random(-1, 1));
+        }
+        mesh_shape->mark_dirty(first, vertices.size());
+        add_vertices(mouseX, mouseY, vertices_per_frame);
+    }
+
+    pushMatrix();
+    translate(width * 0.5f, height * 0.5f);
+    rotateX(sin(frameCount * 0.07f) * 0.07f);
+    rotateY(sin(frameCount * 0.1f) * 0.1f);
+    rotateZ(sin(frameCount * 0.083f) * 0.083f);
+    translate(-width * 0.5f, -height * 0.5f);
+    const auto start = std::chrono::high_resolution_clock::now();
+    mesh_shape->draw();
+    const auto end = std::chrono::high_resolution_clock::now();
+    draw_time_ms   = std::chrono::duration<float, std::milli>(end - start).count();
+    popMatrix();
+
+    const StreamingVertexBuffer::Statistics& statistics = mesh_shape->get_statistics();
+    fill(0);
+    debug_text(mesh_shape->is_streaming() ? "STREAMING CHANGED VERTICES" : "UPLOADING ALL VERTICES", 10, 10);
+    debug_text("FPS      : " + nf(frameRate, 1), 10, 25);
+    debug_text("DRAW TIME: " + nf(draw_time_ms, 2) + "ms", 10, 40);
+    char info[160];
+    snprintf(info, sizeof(info), "VERTICES : %zu ( CAPACITY %zu )", mesh_shape->size(), mesh_shape->capacity());
+    debug_text(info, 10, 55);
+    snprintf(info, sizeof(info), "UPLOADED : %.1fKB IN %u RANGES / REALLOCATIONS: %u STORAGE, %u RING / RING WAITS: %u",
+             statistics.uploaded_bytes / 1024.0f, statistics.uploaded_ranges, statistics.storage_reallocations,
+             statistics.ring_reallocations, statistics.ring_waits);
+    debug_text(info, 10, 70);
+}
+
+void keyPressed() {
+    if (key == 's') {
+        mesh_shape->set_streaming(!mesh_shape->is_streaming());
+    }
+    if (key == '+') {
+        vertices_per_frame = vertices_per_frame == 256 ? 4096 : 256;
+    }
+    if (key == ' ') {
+        mesh_shape->clear();
+    }
+}
+
+void shutdown() {
+    delete mesh_shape;
+}
@@ -0,0 +1,394 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#if defined(__APPLE__) || defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/**
+ * base class for nodes in an `AudioGraph`. a node reads the output buffers of its inputs and
+ * writes one mono block into `output`. nodes must not allocate or block in `process()`.
+ */
+class AudioNode {
+public:
+    virtual ~AudioNode() = default;
+
+    /* `inputs` holds `number_of_inputs` buffers of `frames` samples each, in the order they were connected */
+    virtual void process(const float* const* inputs, size_t number_of_inputs, float* output, size_t frames) = 0;
+};
+
+/**
+ * directed acyclic graph of `AudioNode`s that is processed block by block. independent
+ * branches ( e.g. voices ) are processed in parallel on a fixed pool of worker threads. the
+ * thread that calls `process()` ( i.e the audio thread ) takes part in the work.
+ *
+ * scheduling is dependency-aware: every node has a counter of unfinished inputs. nodes without
+ * inputs are pushed to the caller's work queue, and every finished node pushes those successors
+ * whose counter drops to zero onto the queue of the thread that finished it. idle threads
+ * steal from the other queues ( chase-lev work stealing deques ). no locks are taken and no
+ * memory is allocated while processing.
+ *
+ * workers spin while looking for work to keep wake-up latency low and back off to short sleeps
+ * after `IDLE_SPIN_TIME` without work. workers try to run with real-time priority ( SCHED_FIFO ),
+ * which may require privileges; see `has_realtime_workers()`.
+ *
+ * usage: add nodes with `add()`, connect them with `connect()`, call `compile()` once and then
+ * `process()` for every block. the graph must not be modified after `compile()`.
+ */
+class AudioGraph {
+public:
+    static constexpr size_t   MAX_BLOCK_SIZE = 2048;
+    static constexpr auto     IDLE_SPIN_TIME = std::chrono::milliseconds(2);
+    static constexpr uint32_t MAX_SPINS      = 256;
+    static constexpr size_t   NO_OUTPUT      = SIZE_MAX;
+
+    struct Statistics {
+        uint64_t blocks;
+        uint64_t deadline_misses;
+        float    last_block_time_us;
+        float    max_block_time_us;
+        float    budget_us;
+    };
+
+    explicit AudioGraph(const float sample_rate) : fSampleRate(sample_rate) {}
+
+    ~AudioGraph() { stop_workers(); }
+
+    AudioGraph(const AudioGraph&)            = delete;
+    AudioGraph& operator=(const AudioGraph&) = delete;
+
+    /* takes ownership of `node` and returns its id */
+    size_t add(AudioNode* node) {
+        fNodes.emplace_back();
+        fNodes.back().node.reset(node);
+        return fNodes.size() - 1;
+    }
+
+    /* feeds the output of node `from` into node `to`. returns false if one of the ids is invalid */
+    bool connect(const size_t from, const size_t to) {
+        if (from >= fNodes.size() || to >= fNodes.size() || from == to) {
+            return false;
+        }
+        fNodes[to].inputs.push_back(from);
+        fNodes[from].successors.push_back(to);
+        return true;
+    }
+
+    /* node whose output is returned by `get_output()`. returns false if the id is invalid */
+    bool set_output(const size_t node) {
+        if (node >= fNodes.size()) {
+            return false;
+        }
+        fOutputNode = node;
+        return true;
+    }
+
+    /**
+     * prepares the graph for processing and starts `number_of_workers` worker threads ( in
+     * addition to the calling thread ). the number of workers is limited to the number of cores
+     * minus one. returns false if no valid output node is set or if the graph contains a cycle.
+     */
+    bool compile(const size_t number_of_workers) {
+        stop_workers();
+
+        const size_t n = fNodes.size();
+        if (fOutputNode >= n) {
+            return false;
+        }
+        std::vector<size_t> in_degree(n);
+        for (size_t i = 0; i < n; ++i) {
+            in_degree[i] = fNodes[i].inputs.size();
+        }
+        /* kahn's algorithm to detect cycles */
+        std::vector<size_t> ready;
+        for (size_t i = 0; i < n; ++i) {
+            if (in_degree[i] == 0) {
+                ready.push_back(i);
+            }
+        }
+        size_t visited = 0;
+        while (!ready.empty()) {
+            const size_t i = ready.back();
+            ready.pop_back();
+            ++visited;
+            for (const size_t s: fNodes[i].successors) {
+                if (--in_degree[s] == 0) {
+                    ready.push_back(s);
+                }
+            }
+        }
+        if (visited != n) {
+            return false;
+        }
+
+        fPending = std::make_unique<std::atomic<uint32_t>[]>(n);
+        fRoots.clear();
+        for (size_t i = 0; i < n; ++i) {
+            Node& node = fNodes[i];
+            node.buffer.assign(MAX_BLOCK_SIZE, 0.0f);
+            if (node.inputs.empty()) {
+                fRoots.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        for (auto& node: fNodes) {
+            node.input_buffers.clear();
+            for (const size_t input: node.inputs) {
+                node.input_buffers.push_back(fNodes[input].buffer.data());
+            }
+        }
+
+        /* spinning workers must not compete with the audio thread for a core */
+        const size_t cores   = std::max(1u, std::thread::hardware_concurrency());
+        const size_t workers = std::min(number_of_workers, cores - 1);
+
+        size_t capacity = 2;
+        while (capacity < n) {
+            capacity <<= 1;
+        }
+        fQueues.clear();
+        for (size_t i = 0; i < workers + 1; ++i) {
+            fQueues.push_back(std::make_unique<WorkQueue>(capacity));
+        }
+
+        fRealtimeWorkers = workers > 0;
+        fRunning.store(true);
+        for (size_t i = 0; i < workers; ++i) {
+            fWorkers.emplace_back(&AudioGraph::worker_loop, this, i + 1);
+            fRealtimeWorkers &= set_realtime_priority(fWorkers.back());
+        }
+        fCompiled = true;
+        return true;
+    }
+
+    /* audio thread. processes one block of `frames` samples ( at most `MAX_BLOCK_SIZE` ) */
+    void process(const size_t frames) {
+        if (!fCompiled || fNodes.empty()) {
+            return;
+        }
+        const auto start = std::chrono::steady_clock::now();
+
+        fFrames = std::min(frames, MAX_BLOCK_SIZE);
+        for (size_t i = 0; i < fNodes.size(); ++i) {
+            fPending[i].store(static_cast<uint32_t>(fNodes[i].inputs.size()), std::memory_order_relaxed);
+        }
+        fCompleted.store(0, std::memory_order_relaxed);
+        /* NOTE pushing releases the counters above to any thread that steals a root */
+        for (const uint32_t root: fRoots) {
+            fQueues[0]->push(root);
+        }
+
+        run_until_complete(0);
+
+        const float elapsed_us = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count();
+        const float budget_us  = static_cast<float>(frames) * 1000000.0f / fSampleRate;
+        fLastBlockTimeUs.store(elapsed_us, std::memory_order_relaxed);
+        if (elapsed_us > fMaxBlockTimeUs.load(std::memory_order_relaxed)) {
+            fMaxBlockTimeUs.store(elapsed_us, std::memory_order_relaxed);
+        }
+        fBudgetUs.store(budget_us, std::memory_order_relaxed);
+        if (elapsed_us > budget_us) {
+            fDeadlineMisses.fetch_add(1, std::memory_order_relaxed);
+        }
+        fBlocks.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /* output of the node set with `set_output()`. valid after `process()`, null if the graph is not compiled */
+    float* get_output() { return fCompiled ? fNodes[fOutputNode].buffer.data() : nullptr; }
+
+    /* stops the worker threads. `process()` does nothing until the graph is compiled again */
+    void stop() { stop_workers(); }
+
+    /* any thread */
+    Statistics get_statistics() const {
+        return {fBlocks.load(std::memory_order_relaxed),
+                fDeadlineMisses.load(std::memory_order_relaxed),
+                fLastBlockTimeUs.load(std::memory_order_relaxed),
+                fMaxBlockTimeUs.load(std::memory_order_relaxed),
+                fBudgetUs.load(std::memory_order_relaxed)};
+    }
+
+    void reset_statistics() {
+        fBlocks.store(0);
+        fDeadlineMisses.store(0);
+        fMaxBlockTimeUs.store(0.0f);
+    }
+
+    size_t get_number_of_nodes() const { return fNodes.size(); }
+
+    size_t get_number_of_workers() const { return fWorkers.size(); }
+
+    bool has_realtime_workers() const { return fRealtimeWorkers; }
+
+private:
+    struct Node {
+        std::unique_ptr<AudioNode> node;
+        std::vector<size_t>        inputs;
+        std::vector<size_t>        successors;
+        std::vector<const float*>  input_buffers;
+        std::vector<float>         buffer;
+    };
+
+    /* fixed capacity chase-lev deque. the owner pushes and pops at the bottom, thieves steal from the top */
+    class WorkQueue {
+    public:
+        explicit WorkQueue(const size_t capacity) : fMask(capacity - 1), fItems(new std::atomic<uint32_t>[capacity]) {}
+
+        void push(const uint32_t item) {
+            const int64_t b = fBottom.load(std::memory_order_relaxed);
+            fItems[b & fMask].store(item, std::memory_order_relaxed);
+            fBottom.store(b + 1, std::memory_order_release);
+        }
+
+        bool pop(uint32_t& item) {
+            const int64_t b = fBottom.load(std::memory_order_relaxed) - 1;
+            fBottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = fTop.load(std::memory_order_relaxed);
+            if (t > b) {
+                fBottom.store(b + 1, std::memory_order_relaxed);
+                return false;
+            }
+            item = fItems[b & fMask].load(std::memory_order_relaxed);
+            if (t == b) {
+                /* last item, race against thieves */
+                const bool won = fTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                fBottom.store(b + 1, std::memory_order_relaxed);
+                return won;
+            }
+            return true;
+        }
+
+        bool steal(uint32_t& item) {
+            int64_t t = fTop.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t b = fBottom.load(std::memory_order_acquire);
+            if (t >= b) {
+                return false;
+            }
+            item = fItems[t & fMask].load(std::memory_order_relaxed);
+            return fTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        }
+
+    private:
+        const int64_t                            fMask;
+        std::unique_ptr<std::atomic<uint32_t>[]> fItems;
+        alignas(64) std::atomic<int64_t> fTop{0};
+        alignas(64) std::atomic<int64_t> fBottom{0};
+    };
+
+    const float                               fSampleRate;
+    std::vector<Node>                         fNodes;
+    std::vector<uint32_t>                     fRoots;
+    std::unique_ptr<std::atomic<uint32_t>[]>  fPending;
+    std::vector<std::unique_ptr<WorkQueue>>   fQueues;
+    std::vector<std::thread>                  fWorkers;
+    size_t                                    fOutputNode{NO_OUTPUT};
+    size_t                                    fFrames{0};
+    bool                                      fCompiled{false};
+    bool                                      fRealtimeWorkers{false};
+    std::atomic<bool>                         fRunning{false};
+    alignas(64) std::atomic<size_t>           fCompleted{0};
+    std::atomic<uint64_t>                     fBlocks{0};
+    std::atomic<uint64_t>                     fDeadlineMisses{0};
+    std::atomic<float>                        fLastBlockTimeUs{0.0f};
+    std::atomic<float>                        fMaxBlockTimeUs{0.0f};
+    std::atomic<float>                        fBudgetUs{0.0f};
+
+    static void cpu_relax() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+    static bool set_realtime_priority(std::thread& thread) {
+#if defined(__APPLE__) || defined(__linux__)
+        sched_param param{};
+        param.sched_priority = sched_get_priority_max(SCHED_FIFO) - 1;
+        return pthread_setschedparam(thread.native_handle(), SCHED_FIFO, &param) == 0;
+#else
+        (void) thread;
+        return false;
+#endif
+    }
+
+    void execute(const uint32_t index, WorkQueue& queue) {
+        Node& node = fNodes[index];
+        node.node->process(node.input_buffers.data(), node.input_buffers.size(), node.buffer.data(), fFrames);
+        for (const size_t s: node.successors) {
+            /* acq_rel: the thread that readies a successor sees all of its inputs */
+            if (fPending[s].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                queue.push(static_cast<uint32_t>(s));
+            }
+        }
+        fCompleted.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    /* returns true if a node was executed */
+    bool run_one(const size_t queue_index) {
+        uint32_t   item;
+        WorkQueue& own = *fQueues[queue_index];
+        if (own.pop(item)) {
+            execute(item, own);
+            return true;
+        }
+        for (size_t i = 1; i < fQueues.size(); ++i) {
+            WorkQueue& victim = *fQueues[(queue_index + i) % fQueues.size()];
+            if (victim.steal(item)) {
+                execute(item, own);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /* spins while other threads finish their nodes. yields after a while in case there are more threads than cores */
+    void run_until_complete(const size_t queue_index) {
+        const size_t n     = fNodes.size();
+        uint32_t     spins = 0;
+        while (fCompleted.load(std::memory_order_acquire) < n && fRunning.load(std::memory_order_relaxed)) {
+            if (run_one(queue_index)) {
+                spins = 0;
+            } else if (++spins < MAX_SPINS) {
+                cpu_relax();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void worker_loop(const size_t queue_index) {
+        auto last_work = std::chrono::steady_clock::now();
+        while (fRunning.load(std::memory_order_relaxed)) {
+            if (run_one(queue_index)) {
+                last_work = std::chrono::steady_clock::now();
+            } else if (std::chrono::steady_clock::now() - last_work < IDLE_SPIN_TIME) {
+                cpu_relax();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+    }
+
+    void stop_workers() {
+        fRunning.store(false);
+        for (auto& worker: fWorkers) {
+            worker.join();
+        }
+        fWorkers.clear();
+        fCompiled = false;
+    }
+};
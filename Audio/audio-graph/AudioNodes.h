@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+
+#include "Umfeld.h"
+#include "audio/Sampler.h"
+#include "audio/LowPassFilter.h"
+#include "audio/ADSR.h"
+#include "audio/Reverb.h"
+#include "audio/Wavetable.h"
+
+#include "AudioGraph.h"
+
+/* sums all inputs into `output`. writes silence if there are no inputs */
+inline void mix_inputs(const float* const* inputs, const size_t number_of_inputs, float* output, const size_t frames) {
+    if (number_of_inputs == 0) {
+        std::fill(output, output + frames, 0.0f);
+        return;
+    }
+    std::copy(inputs[0], inputs[0] + frames, output);
+    for (size_t j = 1; j < number_of_inputs; ++j) {
+        const float* input = inputs[j];
+        for (size_t i = 0; i < frames; ++i) {
+            output[i] += input[i];
+        }
+    }
+}
+
+/*
+ * nodes that wrap the DSP classes from `audio/`. every node takes ownership of the object
+ * passed to its constructor. nodes with inputs process the sum of all inputs.
+ */
+
+class SamplerNode final : public AudioNode {
+public:
+    explicit SamplerNode(umfeld::Sampler* sampler) : fSampler(sampler) {}
+    ~SamplerNode() override { delete fSampler; }
+
+    umfeld::Sampler* get() { return fSampler; }
+
+    void process(const float* const*, size_t, float* output, const size_t frames) override {
+        for (size_t i = 0; i < frames; ++i) {
+            output[i] = fSampler->process();
+        }
+    }
+
+private:
+    umfeld::Sampler* fSampler;
+};
+
+class WavetableNode final : public AudioNode {
+public:
+    explicit WavetableNode(umfeld::Wavetable* wavetable) : fWavetable(wavetable) {}
+    ~WavetableNode() override { delete fWavetable; }
+
+    umfeld::Wavetable* get() { return fWavetable; }
+
+    void process(const float* const*, size_t, float* output, const size_t frames) override {
+        for (size_t i = 0; i < frames; ++i) {
+            output[i] = fWavetable->process();
+        }
+    }
+
+private:
+    umfeld::Wavetable* fWavetable;
+};
+
+class ADSRNode final : public AudioNode {
+public:
+    explicit ADSRNode(umfeld::ADSR* adsr) : fADSR(adsr) {}
+    ~ADSRNode() override { delete fADSR; }
+
+    umfeld::ADSR* get() { return fADSR; }
+
+    void process(const float* const* inputs, const size_t number_of_inputs, float* output, const size_t frames) override {
+        mix_inputs(inputs, number_of_inputs, output, frames);
+        for (size_t i = 0; i < frames; ++i) {
+            output[i] = fADSR->process(output[i]);
+        }
+    }
+
+private:
+    umfeld::ADSR* fADSR;
+};
+
+class LowPassFilterNode final : public AudioNode {
+public:
+    explicit LowPassFilterNode(umfeld::LowPassFilter* filter) : fFilter(filter) {}
+    ~LowPassFilterNode() override { delete fFilter; }
+
+    umfeld::LowPassFilter* get() { return fFilter; }
+
+    void process(const float* const* inputs, const size_t number_of_inputs, float* output, const size_t frames) override {
+        mix_inputs(inputs, number_of_inputs, output, frames);
+        for (size_t i = 0; i < frames; ++i) {
+            output[i] = fFilter->process(output[i]);
+        }
+    }
+
+private:
+    umfeld::LowPassFilter* fFilter;
+};
+
+class ReverbNode final : public AudioNode {
+public:
+    explicit ReverbNode(umfeld::Reverb* reverb) : fReverb(reverb) {}
+    ~ReverbNode() override { delete fReverb; }
+
+    umfeld::Reverb* get() { return fReverb; }
+
+    void process(const float* const* inputs, const size_t number_of_inputs, float* output, const size_t frames) override {
+        mix_inputs(inputs, number_of_inputs, output, frames);
+        for (size_t i = 0; i < frames; ++i) {
+            output[i] = fReverb->process(output[i]);
+        }
+    }
+
+private:
+    umfeld::Reverb* fReverb;
+};
+
+class MixerNode final : public AudioNode {
+public:
+    explicit MixerNode(const float gain = 1.0f) : fGain(gain) {}
+
+    void process(const float* const* inputs, const size_t number_of_inputs, float* output, const size_t frames) override {
+        mix_inputs(inputs, number_of_inputs, output, frames);
+        const float gain = fGain;
+        for (size_t i = 0; i < frames; ++i) {
+            output[i] *= gain;
+        }
+    }
+
+private:
+    float fGain;
+};
@@ -0,0 +1,225 @@
+/*
+ * this example demonstrates how to build an audio processing graph from the DSP classes and
+ * process independent branches in parallel on multiple cores. the graph consists of a sampler
+ * and 32 oscillator voices ( wavetable → ADSR → low-pass filter ) that are mixed and fed into a
+ * reverb. press and hold `1` to play the voices. press `b` to run a benchmark with graphs of 1
+ * to 500 voices on one core and on all cores. the graph is stopped and the output is muted
+ * while the benchmark runs, so that its workers do not compete with the benchmark.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+
+#include "Umfeld.h"
+#include "audio/AudioUtilities.h"
+
+#include "AudioGraph.h"
+#include "AudioNodes.h"
+
+using namespace umfeld;
+
+static constexpr int NUMBER_OF_VOICES = 32;
+
+AudioGraph*              graph;
+std::atomic<bool>        graph_running{false};
+std::vector<ADSR*>       envelopes;
+std::vector<std::string> benchmark_results;
+
+void settings() {
+    size(1024, 768);
+    audio();
+}
+
+struct Voice {
+    ADSR*  adsr;
+    size_t output_id;
+};
+
+/* adds a voice ( wavetable → ADSR → low-pass filter ) to `g` */
+Voice add_voice(AudioGraph& g, const float frequency, const float amplitude) {
+    auto* wavetable = new Wavetable(1024, get_audio_sample_rate());
+    wavetable->set_waveform(WAVEFORM_SAWTOOTH_HARMONICS, 8);
+    wavetable->set_frequency(frequency);
+    wavetable->set_amplitude(amplitude);
+    auto* adsr   = new ADSR(get_audio_sample_rate());
+    auto* filter = new LowPassFilter(get_audio_sample_rate());
+    filter->set_frequency(frequency * 4.0f);
+    filter->set_resonance(0.3f);
+
+    const size_t oscillator_id = g.add(new WavetableNode(wavetable));
+    const size_t adsr_id       = g.add(new ADSRNode(adsr));
+    const size_t filter_id     = g.add(new LowPassFilterNode(filter));
+    g.connect(oscillator_id, adsr_id);
+    g.connect(adsr_id, filter_id);
+    return {adsr, filter_id};
+}
+
+size_t number_of_workers() {
+    return std::max(1u, std::thread::hardware_concurrency()) - 1;
+}
+
+/* compiles the graph and starts processing it in `audioEvent()` */
+bool start_graph() {
+    if (!graph->compile(number_of_workers())) {
+        return false;
+    }
+    graph_running = true;
+    return true;
+}
+
+/* mutes the output and stops the workers of the graph */
+void stop_graph() {
+    graph_running = false;
+    graph->stop();
+}
+
+void run_benchmark() {
+    static constexpr int    VOICES[]   = {1, 10, 50, 100, 250, 500};
+    static constexpr size_t BLOCK_SIZE = 256;
+    static constexpr size_t BLOCKS     = 200;
+
+    const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+
+    /* NOTE the benchmark runs on an idle machine, i.e. without the workers of the playing graph */
+    const bool was_running = graph_running;
+    if (was_running) {
+        stop_graph();
+    }
+
+    benchmark_results.clear();
+    for (const int voices: VOICES) {
+        float time_us[2];
+        for (int run = 0; run < 2; ++run) {
+            AudioGraph   g(get_audio_sample_rate());
+            const size_t mixer_id = g.add(new MixerNode(1.0f / voices));
+            for (int i = 0; i < voices; ++i) {
+                const Voice voice = add_voice(g, 55.0f * (1 + i % 16), 0.5f);
+                voice.adsr->start();
+                g.connect(voice.output_id, mixer_id);
+            }
+            const size_t reverb_id = g.add(new ReverbNode(new Reverb()));
+            g.connect(mixer_id, reverb_id);
+            g.set_output(reverb_id);
+            g.compile(run == 0 ? 0 : cores - 1);
+
+            const auto start = std::chrono::high_resolution_clock::now();
+            for (size_t b = 0; b < BLOCKS; ++b) {
+                g.process(BLOCK_SIZE);
+            }
+            time_us[run] = std::chrono::duration<float, std::micro>(std::chrono::high_resolution_clock::now() - start).count() / BLOCKS;
+        }
+        char result[160];
+        snprintf(result, sizeof(result), "VOICES %3d : 1 CORE %9.2fus / %zu CORES %9.2fus per %zu frames ( x%.2f, budget %.0fus )",
+                 voices, time_us[0], cores, time_us[1], BLOCK_SIZE, time_us[0] / time_us[1],
+                 BLOCK_SIZE * 1000000.0f / get_audio_sample_rate());
+        benchmark_results.emplace_back(result);
+        console(benchmark_results.back());
+    }
+
+    if (was_running) {
+        start_graph();
+    }
+}
+
+void setup() {
+    if (get_audio_output_channels() != 2) {
+        error("this example requires a stereo output");
+        exit(1);
+    }
+
+    graph = new AudioGraph(get_audio_sample_rate());
+
+    const size_t mixer_id = graph->add(new MixerNode(0.5f));
+
+    Sampler* sampler = loadSample("teilchen.wav");
+    sampler->set_looping();
+    sampler->play();
+    auto* sampler_filter = new LowPassFilter(get_audio_sample_rate());
+    sampler_filter->set_frequency(2000.0f);
+    const size_t sampler_id        = graph->add(new SamplerNode(sampler));
+    const size_t sampler_filter_id = graph->add(new LowPassFilterNode(sampler_filter));
+    graph->connect(sampler_id, sampler_filter_id);
+    graph->connect(sampler_filter_id, mixer_id);
+
+    static constexpr float SCALE[] = {1.0f, 1.25f, 1.5f, 2.0f};
+    for (int i = 0; i < NUMBER_OF_VOICES; ++i) {
+        const float frequency = 110.0f * SCALE[i % 4] * (1 + i / 8) * random(0.995f, 1.005f);
+        const Voice voice     = add_voice(*graph, frequency, 0.5f / NUMBER_OF_VOICES);
+        graph->connect(voice.output_id, mixer_id);
+        envelopes.push_back(voice.adsr);
+    }
+
+    const size_t reverb_id = graph->add(new ReverbNode(new Reverb()));
+    graph->connect(mixer_id, reverb_id);
+    graph->set_output(reverb_id);
+
+    run_benchmark();
+
+    if (!start_graph()) {
+        error("audio graph contains a cycle or has no output");
+        exit(1);
+    }
+}
+
+void draw() {
+    background(0.85f);
+
+    const AudioGraph::Statistics stats = graph->get_statistics();
+    noFill();
+    stroke(1.0f, 0.25f, 0.35f);
+    strokeWeight(16.0f);
+    const float load = stats.budget_us > 0.0f ? stats.last_block_time_us / stats.budget_us : 0.0f;
+    arc(width / 2.0f, height / 2.0f, height / 2.0f, height / 2.0f, -HALF_PI, TWO_PI * std::min(load, 1.0f) - HALF_PI);
+
+    fill(0);
+    debug_text("NODES          : " + to_string(graph->get_number_of_nodes()), 10, 10);
+    debug_text("WORKERS        : " + to_string(graph->get_number_of_workers()) + (graph->has_realtime_workers() ? " ( real-time )" : ""), 10, 25);
+    debug_text("BLOCK TIME     : " + nf(stats.last_block_time_us, 1) + "us / " + nf(stats.budget_us, 1) + "us", 10, 40);
+    debug_text("MAX BLOCK TIME : " + nf(stats.max_block_time_us, 1) + "us", 10, 55);
+    debug_text("DEADLINE MISSES: " + to_string(stats.deadline_misses) + " / " + to_string(stats.blocks), 10, 70);
+    for (size_t i = 0; i < benchmark_results.size(); ++i) {
+        debug_text(benchmark_results[i], 10, 100 + i * 15);
+    }
+}
+
+void keyPressed() {
+    if (key == '1') {
+        for (auto* adsr: envelopes) {
+            adsr->start();
+        }
+    }
+    if (key == 'b') {
+        run_benchmark();
+    }
+}
+
+void keyReleased() {
+    if (key == '1') {
+        for (auto* adsr: envelopes) {
+            adsr->stop();
+        }
+    }
+}
+
+void audioEvent(const PAudio& audio) {
+    /* the node buffers hold at most `MAX_BLOCK_SIZE` samples, process larger blocks in slices */
+    const auto frames = static_cast<size_t>(audio.buffer_size);
+    if (!graph_running) {
+        std::fill(audio.output_buffer, audio.output_buffer + frames * audio.output_channels, 0.0f);
+        return;
+    }
+    for (size_t offset = 0; offset < frames; offset += AudioGraph::MAX_BLOCK_SIZE) {
+        const size_t slice = std::min(frames - offset, AudioGraph::MAX_BLOCK_SIZE);
+        graph->process(slice);
+        float* output = graph->get_output();
+        if (audio.output_channels == 2) {
+            merge_interleaved_stereo(output, output, audio.output_buffer + offset * 2, static_cast<int>(slice));
+        }
+    }
+}
+
+void shutdown() {
+    delete graph;
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(TRACY_ENABLE)
+#include "tracy/Tracy.hpp"
+#endif
+
+/**
+ * measures how close the audio callback comes to its deadline. call `begin()` at the start
+ * and `end()` at the end of `audioEvent()` ( or use `AudioLoadMonitor::Scope` ). the
+ * monitor measures the wall time of every callback and compares it with the budget, i.e.
+ * the duration of the block in real time ( `frames / sample_rate` ).
+ *
+ * - load: callback duration / budget. a load above 1.0 means the callback took longer than
+ *   the audio it produced and is counted as an *overrun*.
+ * - xrun: the interval between the start of two callbacks is longer than two budgets, i.e.
+ *   the device most likely ran out of samples ( underrun ) in between. NOTE this is only
+ *   meaningful if the callback runs on its own audio thread ( `run_audio_in_thread = true` ).
+ *   if `audioEvent()` is called from the main loop the interval follows the frame rate and
+ *   xrun detection should be disabled with `set_xrun_detection(false)`.
+ * - histogram: `HISTOGRAM_BINS` bins of the load from 0% to `HISTOGRAM_MAX_LOAD`. the last
+ *   bin also counts all higher values.
+ *
+ * the audio thread is the only writer. all values are atomics that can be read from any
+ * thread ( e.g. `draw()` ) without locks. `reset()` only sets a flag, the audio thread
+ * clears the statistics at the start of the next callback.
+ *
+ * if tracing with Tracy is enabled ( `TRACY_ENABLE` ) every callback is marked as a
+ * discontinuous frame named `audio` and the load is plotted, so that the audio callbacks
+ * line up with the render frames marked by `TRACE_FRAME`.
+ */
+class AudioLoadMonitor {
+public:
+    static constexpr size_t HISTOGRAM_BINS     = 40;
+    static constexpr float  HISTOGRAM_MAX_LOAD = 2.0f;
+
+    /* measures the callback for the lifetime of the scope */
+    class Scope {
+    public:
+        Scope(AudioLoadMonitor& monitor, const size_t frames) : fMonitor(monitor), fFrames(frames) { fMonitor.begin(); }
+        ~Scope() { fMonitor.end(fFrames); }
+
+        Scope(const Scope&)            = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        AudioLoadMonitor& fMonitor;
+        const size_t      fFrames;
+    };
+
+    explicit AudioLoadMonitor(const float sample_rate) : fSampleRate(sample_rate) {
+        for (auto& bin: fHistogram) {
+            bin.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /* audio thread. call at the start of the callback */
+    void begin() {
+        if (fResetRequested.exchange(false, std::memory_order_acquire)) {
+            clear();
+        }
+        const auto now = std::chrono::steady_clock::now();
+        if (fHasPreviousStart) {
+            fIntervalUs = std::chrono::duration<float, std::micro>(now - fPreviousStart).count();
+        }
+        fPreviousStart    = now;
+        fStart            = now;
+        fHasPreviousStart = true;
+#if defined(TRACY_ENABLE)
+        FrameMarkStart(TRACE_NAME);
+#endif
+    }
+
+    /* audio thread. call at the end of the callback with the number of frames processed */
+    void end(const size_t frames) {
+        const float duration_us = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - fStart).count();
+        const float budget_us   = static_cast<float>(frames) * 1000000.0f / fSampleRate;
+        const float load        = budget_us > 0.0f ? duration_us / budget_us : 0.0f;
+
+        fDurationUs.store(duration_us, std::memory_order_relaxed);
+        fBudgetUs.store(budget_us, std::memory_order_relaxed);
+        fLoad.store(load, std::memory_order_relaxed);
+        const float average = fAverageLoad.load(std::memory_order_relaxed);
+        fAverageLoad.store(fCallbacks.load(std::memory_order_relaxed) == 0 ? load : average + SMOOTHING * (load - average), std::memory_order_relaxed);
+        if (load > fPeakLoad.load(std::memory_order_relaxed)) {
+            fPeakLoad.store(load, std::memory_order_relaxed);
+        }
+        if (load > 1.0f) {
+            fOverruns.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (fXrunDetection.load(std::memory_order_relaxed) && fIntervalUs > 2.0f * budget_us) {
+            fXruns.fetch_add(1, std::memory_order_relaxed);
+        }
+        fIntervalUs = 0.0f;
+
+        const auto bin = static_cast<size_t>(load / HISTOGRAM_MAX_LOAD * HISTOGRAM_BINS);
+        fHistogram[std::min(bin, HISTOGRAM_BINS - 1)].fetch_add(1, std::memory_order_relaxed);
+        fFrames.fetch_add(frames, std::memory_order_relaxed);
+        fCallbacks.fetch_add(1, std::memory_order_release);
+#if defined(TRACY_ENABLE)
+        TracyPlot(TRACE_PLOT_NAME, load * 100.0f);
+        FrameMarkEnd(TRACE_NAME);
+#endif
+    }
+
+    /* any thread. statistics are cleared by the audio thread at the start of the next callback */
+    void reset() { fResetRequested.store(true, std::memory_order_release); }
+
+    /* any thread. enables or disables counting xruns ( see above ), enabled by default */
+    void set_xrun_detection(const bool enabled) { fXrunDetection.store(enabled, std::memory_order_relaxed); }
+    bool is_xrun_detection_enabled() const { return fXrunDetection.load(std::memory_order_relaxed); }
+
+    float    get_sample_rate() const { return fSampleRate; }
+    float    get_duration_us() const { return fDurationUs.load(std::memory_order_relaxed); }
+    float    get_budget_us() const { return fBudgetUs.load(std::memory_order_relaxed); }
+    float    get_load() const { return fLoad.load(std::memory_order_relaxed); }
+    float    get_average_load() const { return fAverageLoad.load(std::memory_order_relaxed); }
+    float    get_peak_load() const { return fPeakLoad.load(std::memory_order_relaxed); }
+    uint64_t get_callbacks() const { return fCallbacks.load(std::memory_order_acquire); }
+    uint64_t get_frames() const { return fFrames.load(std::memory_order_relaxed); }
+    uint64_t get_overruns() const { return fOverruns.load(std::memory_order_relaxed); }
+    uint64_t get_xruns() const { return fXruns.load(std::memory_order_relaxed); }
+
+    uint32_t get_histogram_bin(const size_t bin) const { return fHistogram[std::min(bin, HISTOGRAM_BINS - 1)].load(std::memory_order_relaxed); }
+
+    /* lower edge of `bin` as load ( e.g. 0.5 for 50% ) */
+    static float get_histogram_bin_load(const size_t bin) { return static_cast<float>(bin) * HISTOGRAM_MAX_LOAD / HISTOGRAM_BINS; }
+
+    /* load below which `percentile` percent of all callbacks lie, estimated from the histogram ( upper bin edge ) */
+    float get_load_percentile(const float percentile) const {
+        uint32_t counts[HISTOGRAM_BINS];
+        uint64_t total = 0;
+        for (size_t i = 0; i < HISTOGRAM_BINS; ++i) {
+            counts[i] = get_histogram_bin(i);
+            total += counts[i];
+        }
+        if (total == 0) {
+            return 0.0f;
+        }
+        const auto threshold = static_cast<uint64_t>(percentile / 100.0f * static_cast<float>(total));
+        uint64_t   sum       = 0;
+        for (size_t i = 0; i < HISTOGRAM_BINS; ++i) {
+            sum += counts[i];
+            if (sum > threshold) {
+                return get_histogram_bin_load(i + 1);
+            }
+        }
+        return HISTOGRAM_MAX_LOAD;
+    }
+
+private:
+    static constexpr float SMOOTHING = 0.05f;
+#if defined(TRACY_ENABLE)
+    static constexpr const char* TRACE_NAME      = "audio";
+    static constexpr const char* TRACE_PLOT_NAME = "audio load ( % )";
+#endif
+
+    const float                           fSampleRate;
+    std::chrono::steady_clock::time_point fStart;
+    std::chrono::steady_clock::time_point fPreviousStart;
+    bool                                  fHasPreviousStart{false};
+    float                                 fIntervalUs{0.0f};
+    std::atomic<bool>                     fResetRequested{false};
+    std::atomic<bool>                     fXrunDetection{true};
+    std::atomic<float>                    fDurationUs{0.0f};
+    std::atomic<float>                    fBudgetUs{0.0f};
+    std::atomic<float>                    fLoad{0.0f};
+    std::atomic<float>                    fAverageLoad{0.0f};
+    std::atomic<float>                    fPeakLoad{0.0f};
+    std::atomic<uint64_t>                 fCallbacks{0};
+    std::atomic<uint64_t>                 fFrames{0};
+    std::atomic<uint64_t>                 fOverruns{0};
+    std::atomic<uint64_t>                 fXruns{0};
+    std::atomic<uint32_t>                 fHistogram[HISTOGRAM_BINS];
+
+    void clear() {
+        fPeakLoad.store(0.0f, std::memory_order_relaxed);
+        fAverageLoad.store(0.0f, std::memory_order_relaxed);
+        fCallbacks.store(0, std::memory_order_relaxed);
+        fFrames.store(0, std::memory_order_relaxed);
+        fOverruns.store(0, std::memory_order_relaxed);
+        fXruns.store(0, std::memory_order_relaxed);
+        for (auto& bin: fHistogram) {
+            bin.store(0, std::memory_order_relaxed);
+        }
+        /* do not count the gap before the reset as an xrun */
+        fHasPreviousStart = false;
+        fIntervalUs       = 0.0f;
+    }
+};
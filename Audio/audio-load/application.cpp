@@ -0,0 +1,133 @@
+/*
+ * this example demonstrates how to monitor the CPU load of the audio callback. an
+ * `AudioLoadMonitor` measures every call to `audioEvent()` and compares it with the time
+ * budget of the block. the load, overruns, xruns and a histogram of the load are displayed
+ * with `debug_text`. if tracing is enabled the audio callbacks appear as frames named `audio`
+ * next to the render frames marked with `TRACE_FRAME`.
+ *
+ * the audio callback runs on its own thread ( `run_audio_in_thread` ), otherwise the interval
+ * between callbacks would follow the frame rate and xruns could not be detected.
+ *
+ * move the mouse horizontally to change the number of oscillators ( i.e. the load ). press
+ * `s` to inject a spike of 1.5 budgets into the next callback, press `r` to reset the
+ * statistics.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "Umfeld.h"
+#include "audio/AudioUtilities.h"
+#include "audio/Wavetable.h"
+
+#include "AudioLoadMonitor.h"
+
+using namespace umfeld;
+
+static constexpr int MAX_OSCILLATORS = 2048;
+
+AudioLoadMonitor*       monitor;
+std::vector<Wavetable*> oscillators;
+std::atomic<int>        active_oscillators{0};
+std::atomic<bool>       inject_spike{false};
+
+void settings() {
+    size(1024, 768);
+    audio();
+    run_audio_in_thread = true;
+}
+
+void setup() {
+    monitor = new AudioLoadMonitor(get_audio_sample_rate());
+    for (int i = 0; i < MAX_OSCILLATORS; ++i) {
+        auto* oscillator = new Wavetable(1024, get_audio_sample_rate());
+        oscillator->set_waveform(WAVEFORM_SINE);
+        oscillator->set_frequency(110.0f + i * 0.37f);
+        oscillator->set_amplitude(0.1f / MAX_OSCILLATORS);
+        oscillators.push_back(oscillator);
+    }
+}
+
+void draw() {
+    TRACE_FRAME;
+
+    background(0.85f);
+
+    active_oscillators = static_cast<int>(static_cast<float>(mouseX) / width * MAX_OSCILLATORS);
+
+    /* histogram of the load. the red line marks 100% */
+    const float bin_width = static_cast<float>(width) / AudioLoadMonitor::HISTOGRAM_BINS;
+    const float baseline  = height - 20.0f;
+    uint32_t    max_count = 1;
+    for (size_t i = 0; i < AudioLoadMonitor::HISTOGRAM_BINS; ++i) {
+        max_count = std::max(max_count, monitor->get_histogram_bin(i));
+    }
+    noStroke();
+    fill(0.0f, 0.5f, 1.0f);
+    for (size_t i = 0; i < AudioLoadMonitor::HISTOGRAM_BINS; ++i) {
+        const float h = static_cast<float>(monitor->get_histogram_bin(i)) / max_count * height * 0.5f;
+        rect(i * bin_width, baseline - h, bin_width - 1.0f, h);
+    }
+    stroke(1.0f, 0.25f, 0.35f);
+    const float limit_x = 1.0f / AudioLoadMonitor::HISTOGRAM_MAX_LOAD * width;
+    line(limit_x, baseline - height * 0.5f, limit_x, baseline);
+
+    char info[128];
+    fill(0);
+    debug_text("OSCILLATORS  : " + to_string(active_oscillators.load()), 10, 10);
+    snprintf(info, sizeof(info), "CALLBACK     : %.1fus / budget %.1fus", monitor->get_duration_us(), monitor->get_budget_us());
+    debug_text(info, 10, 25);
+    snprintf(info, sizeof(info), "LOAD         : %5.1f%% ( average %5.1f%% / peak %5.1f%% / p99 < %5.1f%% )",
+             monitor->get_load() * 100.0f, monitor->get_average_load() * 100.0f,
+             monitor->get_peak_load() * 100.0f, monitor->get_load_percentile(99.0f) * 100.0f);
+    debug_text(info, 10, 40);
+    snprintf(info, sizeof(info), "CALLBACKS    : %llu ( overruns %llu / xruns %llu )",
+             static_cast<unsigned long long>(monitor->get_callbacks()),
+             static_cast<unsigned long long>(monitor->get_overruns()),
+             static_cast<unsigned long long>(monitor->get_xruns()));
+    debug_text(info, 10, 55);
+}
+
+void keyPressed() {
+    if (key == 's') {
+        inject_spike = true;
+    }
+    if (key == 'r') {
+        monitor->reset();
+    }
+}
+
+void audioEvent(const PAudio& audio) {
+    AudioLoadMonitor::Scope scope(*monitor, audio.buffer_size);
+
+    const int count = active_oscillators;
+    float     sample_buffer[audio.buffer_size];
+    for (int i = 0; i < audio.buffer_size; i++) {
+        float sample = 0.0f;
+        for (int j = 0; j < count; j++) {
+            sample += oscillators[j]->process();
+        }
+        sample_buffer[i] = sample;
+    }
+
+    if (inject_spike.exchange(false)) {
+        /* NOTE busy wait to simulate an expensive block */
+        const auto spike = std::chrono::duration<float, std::micro>(monitor->get_budget_us() * 1.5f);
+        const auto start = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - start < spike) {}
+    }
+
+    if (audio.output_channels == 2) {
+        merge_interleaved_stereo(sample_buffer, sample_buffer, audio.output_buffer, audio.buffer_size);
+    }
+}
+
+void shutdown() {
+    delete monitor;
+    for (const auto* oscillator: oscillators) {
+        delete oscillator;
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+/**
+ * linear ADSR envelope with a block based `process`. instead of checking the envelope
+ * stage for every sample the block is split into runs that stay in one stage. each run is a
+ * plain multiply-add loop that the compiler can vectorize.
+ */
+class BlockADSR {
+public:
+    explicit BlockADSR(const float sample_rate) : fSampleRate(sample_rate) {}
+
+    void set_attack(const float seconds) { fAttack = std::max(seconds, 0.0f); }
+    void set_decay(const float seconds) { fDecay = std::max(seconds, 0.0f); }
+    void set_sustain(const float level) { fSustain = std::clamp(level, 0.0f, 1.0f); }
+    void set_release(const float seconds) { fRelease = std::max(seconds, 0.0f); }
+
+    void start() {
+        enter(ATTACK, 1.0f, fAttack);
+    }
+
+    void stop() {
+        if (fState != IDLE) {
+            enter(RELEASE, 0.0f, fRelease);
+        }
+    }
+
+    bool is_idle() const { return fState == IDLE; }
+
+    float get_level() const { return fLevel; }
+
+    /* multiplies `frames` samples of `buffer` with the envelope in place */
+    void process(float* buffer, size_t frames) {
+        while (frames > 0) {
+            if (fState == IDLE) {
+                std::fill(buffer, buffer + frames, 0.0f);
+                return;
+            }
+            if (fState == SUSTAIN) {
+                const float level = fLevel;
+                for (size_t i = 0; i < frames; ++i) {
+                    buffer[i] *= level;
+                }
+                return;
+            }
+            const size_t run       = std::min(frames, fRemaining);
+            const float  increment = fIncrement;
+            float        level     = fLevel;
+            for (size_t i = 0; i < run; ++i) {
+                buffer[i] *= level;
+                level += increment;
+            }
+            fLevel = level;
+            fRemaining -= run;
+            buffer += run;
+            frames -= run;
+            if (fRemaining == 0) {
+                advance();
+            }
+        }
+    }
+
+    float process(float sample) {
+        process(&sample, 1);
+        return sample;
+    }
+
+private:
+    enum State {
+        IDLE,
+        ATTACK,
+        DECAY,
+        SUSTAIN,
+        RELEASE
+    };
+
+    const float fSampleRate;
+    float       fAttack{0.01f};
+    float       fDecay{0.05f};
+    float       fSustain{0.5f};
+    float       fRelease{0.25f};
+    State       fState{IDLE};
+    float       fLevel{0.0f};
+    float       fIncrement{0.0f};
+    size_t      fRemaining{0};
+
+    /* move towards `target` within `seconds` ( at least one sample ) */
+    void enter(const State state, const float target, const float seconds) {
+        fState     = state;
+        fRemaining = std::max<size_t>(1, static_cast<size_t>(seconds * fSampleRate));
+        fIncrement = (target - fLevel) / static_cast<float>(fRemaining);
+    }
+
+    void advance() {
+        switch (fState) {
+            case ATTACK:
+                fLevel = 1.0f;
+                enter(DECAY, fSustain, fDecay);
+                break;
+            case DECAY:
+                fLevel = fSustain;
+                fState = SUSTAIN;
+                break;
+            case RELEASE:
+                fLevel = 0.0f;
+                fState = IDLE;
+                break;
+            default:
+                break;
+        }
+    }
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+/**
+ * resonant two-pole low-pass filter with a block based `process`. the two filter states and
+ * the coefficients are loaded into locals before the loop and written back afterwards.
+ */
+class BlockLowPassFilter {
+public:
+    explicit BlockLowPassFilter(const float sample_rate) : fSampleRate(sample_rate) {
+        update_coefficients();
+    }
+
+    void set_frequency(const float frequency) {
+        fFrequency = frequency;
+        update_coefficients();
+    }
+
+    float get_frequency() const { return fFrequency; }
+
+    void set_resonance(const float resonance) {
+        fResonance = std::clamp(resonance, 0.0f, 0.99f);
+        update_coefficients();
+    }
+
+    float get_resonance() const { return fResonance; }
+
+    void reset() {
+        fBuffer0 = 0.0f;
+        fBuffer1 = 0.0f;
+    }
+
+    /* filters `frames` samples of `buffer` in place */
+    void process(float* buffer, const size_t frames) {
+        const float cutoff   = fCutoff;
+        const float feedback = fFeedback;
+        float       b0       = fBuffer0;
+        float       b1       = fBuffer1;
+        for (size_t i = 0; i < frames; ++i) {
+            b0 += cutoff * (buffer[i] - b0 + feedback * (b0 - b1));
+            b1 += cutoff * (b0 - b1);
+            buffer[i] = b1;
+        }
+        fBuffer0 = b0;
+        fBuffer1 = b1;
+    }
+
+    /* filters `frames` samples from `input` into `output` ( which may be the same buffer ) */
+    void process(const float* input, float* output, const size_t frames) {
+        if (input != output) {
+            std::copy(input, input + frames, output);
+        }
+        process(output, frames);
+    }
+
+    float process(float sample) {
+        process(&sample, 1);
+        return sample;
+    }
+
+private:
+    const float fSampleRate;
+    float       fFrequency{1000.0f};
+    float       fResonance{0.5f};
+    float       fCutoff{0.0f};
+    float       fFeedback{0.0f};
+    float       fBuffer0{0.0f};
+    float       fBuffer1{0.0f};
+
+    void update_coefficients() {
+        fCutoff   = std::clamp(2.0f * std::sin(static_cast<float>(M_PI) * fFrequency / fSampleRate), 0.0f, 0.99f);
+        fFeedback = fResonance + fResonance / (1.0f - fCutoff);
+    }
+};
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/**
+ * mono schroeder/freeverb style reverb ( 8 parallel comb filters into 4 serial allpass
+ * filters ) with a block based `process`. the block is run through one filter at a time so
+ * that every filter keeps its read index and damping state in registers for the whole
+ * block instead of touching 12 delay lines per sample.
+ */
+class BlockReverb {
+public:
+    explicit BlockReverb(const float sample_rate = 48000.0f) {
+        static constexpr size_t COMB_TUNING[NUM_COMBS]       = {1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617};
+        static constexpr size_t ALLPASS_TUNING[NUM_ALLPASSES] = {556, 441, 341, 225};
+        const float             scale                        = sample_rate / 44100.0f;
+        for (size_t i = 0; i < NUM_COMBS; ++i) {
+            fCombs[i].buffer.assign(std::max<size_t>(1, static_cast<size_t>(COMB_TUNING[i] * scale)), 0.0f);
+        }
+        for (size_t i = 0; i < NUM_ALLPASSES; ++i) {
+            fAllpasses[i].buffer.assign(std::max<size_t>(1, static_cast<size_t>(ALLPASS_TUNING[i] * scale)), 0.0f);
+        }
+    }
+
+    void set_roomsize(const float roomsize) { fFeedback = std::clamp(roomsize, 0.0f, 1.0f) * 0.28f + 0.7f; }
+    void set_damping(const float damping) { fDamping = std::clamp(damping, 0.0f, 1.0f) * 0.4f; }
+    void set_wet(const float wet) { fWet = wet * WET_SCALE; }
+    void set_dry(const float dry) { fDry = dry; }
+
+    /* processes `frames` samples of `buffer` in place. `frames` is limited to `MAX_BLOCK_SIZE` per pass */
+    void process(float* buffer, size_t frames) {
+        while (frames > 0) {
+            const size_t block = std::min(frames, MAX_BLOCK_SIZE);
+            process_block(buffer, block);
+            buffer += block;
+            frames -= block;
+        }
+    }
+
+    float process(float sample) {
+        process(&sample, 1);
+        return sample;
+    }
+
+    static constexpr size_t MAX_BLOCK_SIZE = 1024;
+
+private:
+    static constexpr size_t NUM_COMBS     = 8;
+    static constexpr size_t NUM_ALLPASSES = 4;
+    static constexpr float  INPUT_GAIN    = 0.015f;
+    static constexpr float  WET_SCALE     = 3.0f;
+
+    struct Comb {
+        std::vector<float> buffer;
+        size_t             index{0};
+        float              store{0.0f};
+    };
+
+    struct Allpass {
+        std::vector<float> buffer;
+        size_t             index{0};
+    };
+
+    Comb    fCombs[NUM_COMBS];
+    Allpass fAllpasses[NUM_ALLPASSES];
+    float   fFeedback{0.84f};
+    float   fDamping{0.2f};
+    float   fWet{0.3f * WET_SCALE};
+    float   fDry{0.7f};
+    float   fInput[MAX_BLOCK_SIZE]{};
+    float   fOutput[MAX_BLOCK_SIZE]{};
+
+    void process_block(float* buffer, const size_t frames) {
+        for (size_t i = 0; i < frames; ++i) {
+            fInput[i] = buffer[i] * INPUT_GAIN;
+        }
+        std::fill(fOutput, fOutput + frames, 0.0f);
+
+        const float feedback = fFeedback;
+        const float damp1    = fDamping;
+        const float damp2    = 1.0f - fDamping;
+        for (auto& comb: fCombs) {
+            float*       delay  = comb.buffer.data();
+            const size_t length = comb.buffer.size();
+            size_t       index  = comb.index;
+            float        store  = comb.store;
+            for (size_t i = 0; i < frames; ++i) {
+                const float y = delay[index];
+                store         = y * damp2 + store * damp1;
+                delay[index]  = fInput[i] + store * feedback;
+                fOutput[i] += y;
+                if (++index == length) {
+                    index = 0;
+                }
+            }
+            comb.index = index;
+            comb.store = store;
+        }
+
+        for (auto& allpass: fAllpasses) {
+            float*       delay  = allpass.buffer.data();
+            const size_t length = allpass.buffer.size();
+            size_t       index  = allpass.index;
+            for (size_t i = 0; i < frames; ++i) {
+                const float y = delay[index];
+                delay[index]  = fOutput[i] + y * 0.5f;
+                fOutput[i]    = y - fOutput[i];
+                if (++index == length) {
+                    index = 0;
+                }
+            }
+            allpass.index = index;
+        }
+
+        const float wet = fWet;
+        const float dry = fDry;
+        for (size_t i = 0; i < frames; ++i) {
+            buffer[i] = fOutput[i] * wet + buffer[i] * dry;
+        }
+    }
+};
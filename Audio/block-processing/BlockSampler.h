@@ -0,0 +1,72 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+/**
+ * plays back a sample buffer at its original speed with a block based `process`. a block is
+ * copied in at most a few contiguous runs ( split only at the loop point ), so playback
+ * becomes a `memcpy` instead of a per sample state machine.
+ *
+ * NOTE the sampler does not own the buffer. it must stay valid while the sampler is used.
+ */
+class BlockSampler {
+public:
+    BlockSampler(const float* buffer, const size_t length) : fBuffer(buffer), fLength(length) {}
+
+    void play() { fPlaying = true; }
+    void stop() { fPlaying = false; }
+    void rewind() { fPosition = 0; }
+    void set_looping(const bool looping = true) { fLooping = looping; }
+    void set_amplitude(const float amplitude) { fAmplitude = amplitude; }
+
+    bool is_playing() const { return fPlaying; }
+
+    size_t get_position() const { return fPosition; }
+
+    void set_position(const size_t position) { fPosition = std::min(position, fLength); }
+
+    float get_position_normalized() const {
+        return fLength > 0 ? static_cast<float>(fPosition) / static_cast<float>(fLength) : 0.0f;
+    }
+
+    /* writes `frames` samples into `output`. frames after the end of a non-looping sample are silent */
+    void process(float* output, size_t frames) {
+        const float amplitude = fAmplitude;
+        while (frames > 0) {
+            if (!fPlaying || fLength == 0 || fPosition >= fLength) {
+                std::fill(output, output + frames, 0.0f);
+                return;
+            }
+            const size_t run    = std::min(frames, fLength - fPosition);
+            const float* source = fBuffer + fPosition;
+            for (size_t i = 0; i < run; ++i) {
+                output[i] = source[i] * amplitude;
+            }
+            fPosition += run;
+            output += run;
+            frames -= run;
+            if (fPosition >= fLength) {
+                if (fLooping) {
+                    fPosition = 0;
+                } else {
+                    fPlaying = false;
+                }
+            }
+        }
+    }
+
+    float process() {
+        float sample;
+        process(&sample, 1);
+        return sample;
+    }
+
+private:
+    const float* fBuffer;
+    const size_t fLength;
+    size_t       fPosition{0};
+    float        fAmplitude{1.0f};
+    bool         fPlaying{false};
+    bool         fLooping{false};
+};
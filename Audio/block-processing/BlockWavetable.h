@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/**
+ * wavetable oscillator that renders a whole block per call. phase, phase increment and
+ * amplitude are copied into locals for the duration of the block so that the inner loop
+ * has no member access and no branch except for the phase wrap.
+ */
+class BlockWavetable {
+public:
+    enum Waveform {
+        SINE,
+        TRIANGLE,
+        SAWTOOTH,
+        SQUARE
+    };
+
+    BlockWavetable(const size_t table_size, const float sample_rate)
+        : fTable(table_size + 1, 0.0f),
+          fTableSize(table_size),
+          fSampleRate(sample_rate) {
+        set_waveform(SINE);
+        set_frequency(220.0f);
+    }
+
+    void set_waveform(const Waveform waveform) {
+        for (size_t i = 0; i < fTableSize; ++i) {
+            const float r = static_cast<float>(i) / static_cast<float>(fTableSize);
+            switch (waveform) {
+                case SINE:
+                    fTable[i] = std::sin(r * 2.0f * static_cast<float>(M_PI));
+                    break;
+                case TRIANGLE:
+                    fTable[i] = r < 0.25f ? r * 4.0f : (r < 0.75f ? 2.0f - r * 4.0f : r * 4.0f - 4.0f);
+                    break;
+                case SAWTOOTH:
+                    fTable[i] = r * 2.0f - 1.0f;
+                    break;
+                case SQUARE:
+                    fTable[i] = r < 0.5f ? 1.0f : -1.0f;
+                    break;
+            }
+        }
+        /* guard point so that interpolation never has to wrap */
+        fTable[fTableSize] = fTable[0];
+    }
+
+    void set_frequency(const float frequency) {
+        fFrequency      = frequency;
+        fPhaseIncrement = frequency * static_cast<float>(fTableSize) / fSampleRate;
+    }
+
+    float get_frequency() const { return fFrequency; }
+
+    void set_amplitude(const float amplitude) { fAmplitude = amplitude; }
+
+    float get_amplitude() const { return fAmplitude; }
+
+    float* get_table() { return fTable.data(); }
+
+    size_t get_table_size() const { return fTableSize; }
+
+    /* writes `frames` samples into `output` */
+    void process(float* output, const size_t frames) {
+        const float* table     = fTable.data();
+        const float  size      = static_cast<float>(fTableSize);
+        const float  increment = fPhaseIncrement;
+        const float  amplitude = fAmplitude;
+        float        phase     = fPhase;
+        for (size_t i = 0; i < frames; ++i) {
+            const auto  index    = static_cast<size_t>(phase);
+            const float fraction = phase - static_cast<float>(index);
+            const float a        = table[index];
+            const float b        = table[index + 1];
+            output[i]            = (a + (b - a) * fraction) * amplitude;
+            phase += increment;
+            if (phase >= size) {
+                phase -= size;
+            } else if (phase < 0.0f) {
+                phase += size;
+            }
+        }
+        fPhase = phase;
+    }
+
+    /* single sample path, kept for comparison with the block path */
+    float process() {
+        float sample;
+        process(&sample, 1);
+        return sample;
+    }
+
+private:
+    std::vector<float> fTable;
+    const size_t       fTableSize;
+    const float        fSampleRate;
+    float              fFrequency{0.0f};
+    float              fPhaseIncrement{0.0f};
+    float              fAmplitude{0.75f};
+    float              fPhase{0.0f};
+};
@@ -0,0 +1,225 @@
+/*
+ * this example demonstrates how to process audio in blocks instead of sample by sample. the
+ * `Block*` classes mirror `Sampler`, `LowPassFilter`, `ADSR`, `Reverb` and `Wavetable` but
+ * offer a `process(float* buffer, size_t frames)` method that processes a whole block per
+ * call. press `1` to trigger the envelope and `b` to run a benchmark that compares the
+ * block path with the per-sample path at 64, 256 and 1024 frames. the `Block*` classes are
+ * also run through their single sample `process`, so that the effect of processing in blocks
+ * is measured separately from the differences between the implementations.
+ */
+
+#include <chrono>
+#include <cstdio>
+
+#include "Umfeld.h"
+#include "audio/AudioUtilities.h"
+#include "audio/Sampler.h"
+#include "audio/LowPassFilter.h"
+#include "audio/ADSR.h"
+#include "audio/Reverb.h"
+#include "audio/Wavetable.h"
+
+#include "BlockSampler.h"
+#include "BlockLowPassFilter.h"
+#include "BlockADSR.h"
+#include "BlockReverb.h"
+#include "BlockWavetable.h"
+
+using namespace umfeld;
+
+Sampler* sample_source;
+
+BlockSampler*       sampler;
+BlockLowPassFilter* filter;
+BlockWavetable*     oscillator;
+BlockADSR*          adsr;
+BlockReverb*        reverb;
+
+std::vector<std::string> benchmark_results;
+
+void settings() {
+    size(1024, 768);
+    audio();
+}
+
+void run_benchmark() {
+    static constexpr size_t BLOCK_SIZES[] = {64, 256, 1024};
+    static constexpr size_t FRAMES_TOTAL  = 48000 * 4;
+
+    const float sample_rate = get_audio_sample_rate();
+
+    /* NOTE separate instances so that the benchmark does not interfere with the audio thread */
+    Sampler*       ps_sampler    = loadSample("teilchen.wav");
+    LowPassFilter* ps_filter     = new LowPassFilter(sample_rate);
+    Wavetable*     ps_oscillator = new Wavetable(1024, sample_rate);
+    ADSR*          ps_adsr       = new ADSR(sample_rate);
+    Reverb*        ps_reverb     = new Reverb();
+    ps_sampler->set_looping();
+    ps_sampler->play();
+    ps_oscillator->set_waveform(WAVEFORM_TRIANGLE);
+    ps_adsr->start();
+
+    BlockSampler       b_sampler(sample_source->get_buffer(), sample_source->get_buffer_length());
+    BlockLowPassFilter b_filter(sample_rate);
+    BlockWavetable     b_oscillator(1024, sample_rate);
+    BlockADSR          b_adsr(sample_rate);
+    BlockReverb        b_reverb(sample_rate);
+    b_sampler.set_looping();
+    b_sampler.play();
+    b_oscillator.set_waveform(BlockWavetable::TRIANGLE);
+    b_adsr.start();
+
+    /* the same classes, called with one sample at a time */
+    BlockSampler       bs_sampler(sample_source->get_buffer(), sample_source->get_buffer_length());
+    BlockLowPassFilter bs_filter(sample_rate);
+    BlockWavetable     bs_oscillator(1024, sample_rate);
+    BlockADSR          bs_adsr(sample_rate);
+    BlockReverb        bs_reverb(sample_rate);
+    bs_sampler.set_looping();
+    bs_sampler.play();
+    bs_oscillator.set_waveform(BlockWavetable::TRIANGLE);
+    bs_adsr.start();
+
+    std::vector<float> buffer_a(1024);
+    std::vector<float> buffer_b(1024);
+
+    benchmark_results.clear();
+    for (const size_t frames: BLOCK_SIZES) {
+        const size_t blocks = FRAMES_TOTAL / frames;
+
+        const auto per_sample_start = std::chrono::high_resolution_clock::now();
+        for (size_t b = 0; b < blocks; ++b) {
+            for (size_t i = 0; i < frames; ++i) {
+                float sample = ps_sampler->process();
+                sample       = ps_filter->process(sample);
+                float tone   = ps_oscillator->process();
+                tone         = ps_adsr->process(tone);
+                buffer_a[i]  = ps_reverb->process(sample + tone);
+            }
+        }
+        const auto per_sample_end = std::chrono::high_resolution_clock::now();
+
+        const auto block_per_sample_start = std::chrono::high_resolution_clock::now();
+        for (size_t b = 0; b < blocks; ++b) {
+            for (size_t i = 0; i < frames; ++i) {
+                float sample = bs_sampler.process();
+                sample       = bs_filter.process(sample);
+                float tone   = bs_oscillator.process();
+                tone         = bs_adsr.process(tone);
+                buffer_a[i]  = bs_reverb.process(sample + tone);
+            }
+        }
+        const auto block_per_sample_end = std::chrono::high_resolution_clock::now();
+
+        const auto block_start = std::chrono::high_resolution_clock::now();
+        for (size_t b = 0; b < blocks; ++b) {
+            b_sampler.process(buffer_a.data(), frames);
+            b_filter.process(buffer_a.data(), frames);
+            b_oscillator.process(buffer_b.data(), frames);
+            b_adsr.process(buffer_b.data(), frames);
+            for (size_t i = 0; i < frames; ++i) {
+                buffer_a[i] += buffer_b[i];
+            }
+            b_reverb.process(buffer_a.data(), frames);
+        }
+        const auto block_end = std::chrono::high_resolution_clock::now();
+
+        const double per_sample_us       = std::chrono::duration<double, std::micro>(per_sample_end - per_sample_start).count() / blocks;
+        const double block_per_sample_us = std::chrono::duration<double, std::micro>(block_per_sample_end - block_per_sample_start).count() / blocks;
+        const double block_us            = std::chrono::duration<double, std::micro>(block_end - block_start).count() / blocks;
+        char         result[160];
+        snprintf(result, sizeof(result), "FRAMES %4zu : PER SAMPLE %8.2fus / BLOCK CLASSES PER SAMPLE %8.2fus / BLOCK %8.2fus ( x%.2f, x%.2f from blocks )",
+                 frames, per_sample_us, block_per_sample_us, block_us, per_sample_us / block_us, block_per_sample_us / block_us);
+        benchmark_results.emplace_back(result);
+        console(benchmark_results.back());
+    }
+
+    delete ps_sampler;
+    delete ps_filter;
+    delete ps_oscillator;
+    delete ps_adsr;
+    delete ps_reverb;
+}
+
+void setup() {
+    if (get_audio_output_channels() != 2) {
+        error("this example requires a stereo output");
+        exit(1);
+    }
+
+    sample_source = loadSample("teilchen.wav");
+    sampler       = new BlockSampler(sample_source->get_buffer(), sample_source->get_buffer_length());
+    sampler->set_looping();
+    sampler->play();
+
+    filter     = new BlockLowPassFilter(get_audio_sample_rate());
+    oscillator = new BlockWavetable(1024, get_audio_sample_rate());
+    oscillator->set_waveform(BlockWavetable::TRIANGLE);
+    oscillator->set_amplitude(0.5f);
+    adsr   = new BlockADSR(get_audio_sample_rate());
+    reverb = new BlockReverb(get_audio_sample_rate());
+
+    run_benchmark();
+}
+
+void draw() {
+    background(0.85f);
+
+    const float size = height / 2.0f;
+    const float x    = width / 2.0f;
+    const float y    = height / 2.0f;
+
+    strokeWeight(16.0f);
+    noFill();
+    stroke(1.0f, 0.25f, 0.35f);
+    arc(x, y, size, size, -HALF_PI, TWO_PI * sampler->get_position_normalized() - HALF_PI);
+
+    filter->set_frequency(map(mouseX, 0, width, 20.0f, 8000.0f));
+    filter->set_resonance(map(mouseY, 0, height, 0.1f, 0.9f));
+    oscillator->set_frequency(map(mouseX, 0, width, 55.0f, 440.0f));
+
+    fill(0);
+    for (size_t i = 0; i < benchmark_results.size(); ++i) {
+        debug_text(benchmark_results[i], 10, 10 + i * 15);
+    }
+}
+
+void keyPressed() {
+    if (key == '1') {
+        adsr->start();
+    }
+    if (key == 'b') {
+        run_benchmark();
+    }
+}
+
+void keyReleased() {
+    if (key == '1') {
+        adsr->stop();
+    }
+}
+
+void audioEvent(const PAudio& audio) {
+    float sample_buffer[audio.buffer_size];
+    float tone_buffer[audio.buffer_size];
+    sampler->process(sample_buffer, audio.buffer_size);
+    filter->process(sample_buffer, audio.buffer_size);
+    oscillator->process(tone_buffer, audio.buffer_size);
+    adsr->process(tone_buffer, audio.buffer_size);
+    for (int i = 0; i < audio.buffer_size; i++) {
+        sample_buffer[i] += tone_buffer[i];
+    }
+    reverb->process(sample_buffer, audio.buffer_size);
+    if (audio.output_channels == 2) {
+        merge_interleaved_stereo(sample_buffer, sample_buffer, audio.output_buffer, audio.buffer_size);
+    }
+}
+
+void shutdown() {
+    delete sampler;
+    delete filter;
+    delete oscillator;
+    delete adsr;
+    delete reverb;
+    delete sample_source;
+}
@@ -0,0 +1,495 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CHANNEL_UTILITIES_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define CHANNEL_UTILITIES_NEON
+#endif
+
+/**
+ * vectorized channel utilities for any number of channels:
+ *
+ * - `interleave` / `deinterleave` between planar buffers ( one per channel ) and interleaved
+ *   buffers. 2 channels and multiples of 4 channels ( 4, 8, 16, … ) use SIMD shuffles and
+ *   4×4 transposes, other channel counts fall back to scalar loops.
+ * - `merge_interleaved_stereo`, `mix_mono_to_stereo` and `mix_stereo_to_mono` as
+ *   replacements for the functions in `audio/AudioUtilities.h`.
+ * - `mix_matrix` applies a gain matrix ( `output_channels × input_channels`, row major ) and
+ *   `make_pan_matrix` creates an equal power panning matrix for it.
+ * - `float_to_int16` / `float_to_int24` with optional TPDF dither and the reverse
+ *   conversions `int16_to_float` / `int24_to_float`. int24 samples are packed little endian
+ *   ( 3 bytes per sample ), the int24 conversions are scalar only.
+ *
+ * SIMD paths use SSE2 on x86 and NEON on 64 bit ARM. the scalar reference implementations
+ * are available in `simd::scalar` e.g. for testing and benchmarking.
+ */
+namespace simd {
+    /* maximum number of channels for `mix_matrix` */
+    static constexpr size_t MAX_CHANNELS = 64;
+    /* size in samples of each of the two stack scratch buffers of `mix_matrix` ( 4KB each ) */
+    static constexpr size_t MIX_SCRATCH_SAMPLES = 1024;
+
+    /* state of the dither noise generator ( 4 independent xorshift generators ) */
+    struct Dither {
+        uint32_t state[4] = {0x12345678, 0x9abcdef1, 0x2468ace1, 0x13579bdf};
+    };
+
+    namespace scalar {
+        inline void interleave(const float* const* inputs, float* output, const size_t channels, const size_t frames) {
+            for (size_t i = 0; i < frames; ++i) {
+                for (size_t c = 0; c < channels; ++c) {
+                    output[i * channels + c] = inputs[c][i];
+                }
+            }
+        }
+
+        inline void deinterleave(const float* input, float* const* outputs, const size_t channels, const size_t frames) {
+            for (size_t i = 0; i < frames; ++i) {
+                for (size_t c = 0; c < channels; ++c) {
+                    outputs[c][i] = input[i * channels + c];
+                }
+            }
+        }
+
+        inline void mix_mono_to_stereo(const float* input, float* output, const size_t frames) {
+            for (size_t i = 0; i < frames; ++i) {
+                output[i * 2 + 0] = input[i];
+                output[i * 2 + 1] = input[i];
+            }
+        }
+
+        inline void mix_stereo_to_mono(const float* input, float* output, const size_t frames) {
+            for (size_t i = 0; i < frames; ++i) {
+                output[i] = (input[i * 2 + 0] + input[i * 2 + 1]) * 0.5f;
+            }
+        }
+
+        inline void mix_matrix(const float* input, const size_t input_channels, float* output, const size_t output_channels, const float* matrix, const size_t frames) {
+            for (size_t i = 0; i < frames; ++i) {
+                const float* in  = input + i * input_channels;
+                float*       out = output + i * output_channels;
+                for (size_t o = 0; o < output_channels; ++o) {
+                    float sum = 0.0f;
+                    for (size_t c = 0; c < input_channels; ++c) {
+                        sum += matrix[o * input_channels + c] * in[c];
+                    }
+                    out[o] = sum;
+                }
+            }
+        }
+
+        inline uint32_t next_random(uint32_t& state) {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+
+        /* uniform random number in [0, 1) */
+        inline float next_uniform(uint32_t& state) {
+            return static_cast<float>(next_random(state) >> 8) * (1.0f / 16777216.0f);
+        }
+
+        inline void float_to_int16(const float* input, int16_t* output, const size_t samples, Dither* dither = nullptr) {
+            for (size_t i = 0; i < samples; ++i) {
+                float value = std::clamp(input[i], -1.0f, 1.0f) * 32767.0f;
+                if (dither != nullptr) {
+                    value += next_uniform(dither->state[0]) - next_uniform(dither->state[0]);
+                }
+                output[i] = static_cast<int16_t>(std::clamp(std::nearbyint(value), -32768.0f, 32767.0f));
+            }
+        }
+
+        inline void int16_to_float(const int16_t* input, float* output, const size_t samples) {
+            for (size_t i = 0; i < samples; ++i) {
+                output[i] = static_cast<float>(input[i]) * (1.0f / 32768.0f);
+            }
+        }
+
+        inline void float_to_int24(const float* input, uint8_t* output, const size_t samples, Dither* dither = nullptr) {
+            for (size_t i = 0; i < samples; ++i) {
+                /* NOTE double precision because float cannot represent all 24 bit values plus dither */
+                double value = static_cast<double>(std::clamp(input[i], -1.0f, 1.0f)) * 8388607.0;
+                if (dither != nullptr) {
+                    value += static_cast<double>(next_uniform(dither->state[0]) - next_uniform(dither->state[0]));
+                }
+                const auto sample = static_cast<int32_t>(std::clamp(std::nearbyint(value), -8388608.0, 8388607.0));
+                output[i * 3 + 0] = static_cast<uint8_t>(sample);
+                output[i * 3 + 1] = static_cast<uint8_t>(sample >> 8);
+                output[i * 3 + 2] = static_cast<uint8_t>(sample >> 16);
+            }
+        }
+
+        inline void int24_to_float(const uint8_t* input, float* output, const size_t samples) {
+            for (size_t i = 0; i < samples; ++i) {
+                const auto sample = static_cast<int32_t>(static_cast<uint32_t>(input[i * 3 + 0]) << 8 |
+                                                         static_cast<uint32_t>(input[i * 3 + 1]) << 16 |
+                                                         static_cast<uint32_t>(input[i * 3 + 2]) << 24) >>
+                                    8;
+                output[i] = static_cast<float>(sample) * (1.0f / 8388608.0f);
+            }
+        }
+    } // namespace scalar
+
+#if defined(CHANNEL_UTILITIES_SSE2)
+    using vec4  = __m128;
+    using ivec4 = __m128i;
+
+    inline vec4 load(const float* p) { return _mm_loadu_ps(p); }
+    inline void store(float* p, const vec4 v) { _mm_storeu_ps(p, v); }
+    inline vec4 set1(const float v) { return _mm_set1_ps(v); }
+    inline vec4 add(const vec4 a, const vec4 b) { return _mm_add_ps(a, b); }
+    inline vec4 sub(const vec4 a, const vec4 b) { return _mm_sub_ps(a, b); }
+    inline vec4 mul(const vec4 a, const vec4 b) { return _mm_mul_ps(a, b); }
+    inline vec4 clamp(const vec4 v, const float lo, const float hi) { return _mm_min_ps(_mm_max_ps(v, _mm_set1_ps(lo)), _mm_set1_ps(hi)); }
+
+    /* a = [a0 a1 a2 a3], b = [b0 b1 b2 b3] → lo = [a0 b0 a1 b1], hi = [a2 b2 a3 b3] */
+    inline void zip(const vec4 a, const vec4 b, vec4& lo, vec4& hi) {
+        lo = _mm_unpacklo_ps(a, b);
+        hi = _mm_unpackhi_ps(a, b);
+    }
+
+    /* inverse of `zip` */
+    inline void unzip(const vec4 lo, const vec4 hi, vec4& a, vec4& b) {
+        a = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+        b = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+    }
+
+    inline void transpose(vec4& r0, vec4& r1, vec4& r2, vec4& r3) { _MM_TRANSPOSE4_PS(r0, r1, r2, r3); }
+
+    inline ivec4 load_state(const Dither& dither) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(dither.state)); }
+    inline void  store_state(Dither& dither, const ivec4 state) { _mm_storeu_si128(reinterpret_cast<__m128i*>(dither.state), state); }
+
+    /* 4 uniform random numbers in [0, 1) */
+    inline vec4 next_uniform(ivec4& state) {
+        state = _mm_xor_si128(state, _mm_slli_epi32(state, 13));
+        state = _mm_xor_si128(state, _mm_srli_epi32(state, 17));
+        state = _mm_xor_si128(state, _mm_slli_epi32(state, 5));
+        /* use the upper 23 bits as mantissa of a float in [1, 2) */
+        const ivec4 bits = _mm_or_si128(_mm_srli_epi32(state, 9), _mm_set1_epi32(0x3f800000));
+        return _mm_sub_ps(_mm_castsi128_ps(bits), _mm_set1_ps(1.0f));
+    }
+
+    /* converts 8 floats ( already scaled to the int16 range ) to int16 with rounding and saturation */
+    inline void store_int16(int16_t* p, const vec4 a, const vec4 b) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+    }
+
+    /* converts 8 int16 to floats ( not scaled ) */
+    inline void load_int16(const int16_t* p, vec4& a, vec4& b) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        /* sign extend by shifting the samples into the upper half of each 32 bit lane */
+        a = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16));
+        b = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16));
+    }
+#elif defined(CHANNEL_UTILITIES_NEON)
+    using vec4  = float32x4_t;
+    using ivec4 = uint32x4_t;
+
+    inline vec4 load(const float* p) { return vld1q_f32(p); }
+    inline void store(float* p, const vec4 v) { vst1q_f32(p, v); }
+    inline vec4 set1(const float v) { return vdupq_n_f32(v); }
+    inline vec4 add(const vec4 a, const vec4 b) { return vaddq_f32(a, b); }
+    inline vec4 sub(const vec4 a, const vec4 b) { return vsubq_f32(a, b); }
+    inline vec4 mul(const vec4 a, const vec4 b) { return vmulq_f32(a, b); }
+    inline vec4 clamp(const vec4 v, const float lo, const float hi) { return vminq_f32(vmaxq_f32(v, vdupq_n_f32(lo)), vdupq_n_f32(hi)); }
+
+    inline void zip(const vec4 a, const vec4 b, vec4& lo, vec4& hi) {
+        lo = vzip1q_f32(a, b);
+        hi = vzip2q_f32(a, b);
+    }
+
+    inline void unzip(const vec4 lo, const vec4 hi, vec4& a, vec4& b) {
+        a = vuzp1q_f32(lo, hi);
+        b = vuzp2q_f32(lo, hi);
+    }
+
+    inline void transpose(vec4& r0, vec4& r1, vec4& r2, vec4& r3) {
+        const float32x4x2_t t01 = vtrnq_f32(r0, r1);
+        const float32x4x2_t t23 = vtrnq_f32(r2, r3);
+        r0                      = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+        r1                      = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+        r2                      = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+        r3                      = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+    }
+
+    inline ivec4 load_state(const Dither& dither) { return vld1q_u32(dither.state); }
+    inline void  store_state(Dither& dither, const ivec4 state) { vst1q_u32(dither.state, state); }
+
+    inline vec4 next_uniform(ivec4& state) {
+        state            = veorq_u32(state, vshlq_n_u32(state, 13));
+        state            = veorq_u32(state, vshrq_n_u32(state, 17));
+        state            = veorq_u32(state, vshlq_n_u32(state, 5));
+        const ivec4 bits = vorrq_u32(vshrq_n_u32(state, 9), vdupq_n_u32(0x3f800000));
+        return vsubq_f32(vreinterpretq_f32_u32(bits), vdupq_n_f32(1.0f));
+    }
+
+    inline void store_int16(int16_t* p, const vec4 a, const vec4 b) {
+        vst1q_s16(p, vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(a)), vqmovn_s32(vcvtnq_s32_f32(b))));
+    }
+
+    inline void load_int16(const int16_t* p, vec4& a, vec4& b) {
+        const int16x8_t v = vld1q_s16(p);
+        a                 = vcvtq_f32_s32(vmovl_s16(vget_low_s16(v)));
+        b                 = vcvtq_f32_s32(vmovl_s16(vget_high_s16(v)));
+    }
+#endif
+
+    inline void interleave(const float* const* inputs, float* output, const size_t channels, const size_t frames) {
+        size_t i = 0;
+#if defined(CHANNEL_UTILITIES_SSE2) || defined(CHANNEL_UTILITIES_NEON)
+        if (channels == 2) {
+            for (; i + 4 <= frames; i += 4) {
+                vec4 lo, hi;
+                zip(load(inputs[0] + i), load(inputs[1] + i), lo, hi);
+                store(output + i * 2, lo);
+                store(output + i * 2 + 4, hi);
+            }
+        } else if (channels % 4 == 0) {
+            /* transpose 4 frames × 4 channels at a time */
+            for (; i + 4 <= frames; i += 4) {
+                for (size_t c = 0; c < channels; c += 4) {
+                    vec4 r0 = load(inputs[c + 0] + i);
+                    vec4 r1 = load(inputs[c + 1] + i);
+                    vec4 r2 = load(inputs[c + 2] + i);
+                    vec4 r3 = load(inputs[c + 3] + i);
+                    transpose(r0, r1, r2, r3);
+                    store(output + (i + 0) * channels + c, r0);
+                    store(output + (i + 1) * channels + c, r1);
+                    store(output + (i + 2) * channels + c, r2);
+                    store(output + (i + 3) * channels + c, r3);
+                }
+            }
+        }
+#endif
+        for (; i < frames; ++i) {
+            for (size_t c = 0; c < channels; ++c) {
+                output[i * channels + c] = inputs[c][i];
+            }
+        }
+    }
+
+    inline void deinterleave(const float* input, float* const* outputs, const size_t channels, const size_t frames) {
+        size_t i = 0;
+#if defined(CHANNEL_UTILITIES_SSE2) || defined(CHANNEL_UTILITIES_NEON)
+        if (channels == 2) {
+            for (; i + 4 <= frames; i += 4) {
+                vec4 a, b;
+                unzip(load(input + i * 2), load(input + i * 2 + 4), a, b);
+                store(outputs[0] + i, a);
+                store(outputs[1] + i, b);
+            }
+        } else if (channels % 4 == 0) {
+            for (; i + 4 <= frames; i += 4) {
+                for (size_t c = 0; c < channels; c += 4) {
+                    vec4 r0 = load(input + (i + 0) * channels + c);
+                    vec4 r1 = load(input + (i + 1) * channels + c);
+                    vec4 r2 = load(input + (i + 2) * channels + c);
+                    vec4 r3 = load(input + (i + 3) * channels + c);
+                    transpose(r0, r1, r2, r3);
+                    store(outputs[c + 0] + i, r0);
+                    store(outputs[c + 1] + i, r1);
+                    store(outputs[c + 2] + i, r2);
+                    store(outputs[c + 3] + i, r3);
+                }
+            }
+        }
+#endif
+        for (; i < frames; ++i) {
+            for (size_t c = 0; c < channels; ++c) {
+                outputs[c][i] = input[i * channels + c];
+            }
+        }
+    }
+
+    inline void merge_interleaved_stereo(const float* left, const float* right, float* output, const size_t frames) {
+        size_t i = 0;
+#if defined(CHANNEL_UTILITIES_SSE2) || defined(CHANNEL_UTILITIES_NEON)
+        for (; i + 4 <= frames; i += 4) {
+            vec4 lo, hi;
+            zip(load(left + i), load(right + i), lo, hi);
+            store(output + i * 2, lo);
+            store(output + i * 2 + 4, hi);
+        }
+#endif
+        for (; i < frames; ++i) {
+            output[i * 2]     = left[i];
+            output[i * 2 + 1] = right[i];
+        }
+    }
+
+    inline void split_interleaved_stereo(const float* input, float* left, float* right, const size_t frames) {
+        size_t i = 0;
+#if defined(CHANNEL_UTILITIES_SSE2) || defined(CHANNEL_UTILITIES_NEON)
+        for (; i + 4 <= frames; i += 4) {
+            vec4 a, b;
+            unzip(load(input + i * 2), load(input + i * 2 + 4), a, b);
+            store(left + i, a);
+            store(right + i, b);
+        }
+#endif
+        for (; i < frames; ++i) {
+            left[i]  = input[i * 2];
+            right[i] = input[i * 2 + 1];
+        }
+    }
+
+    inline void mix_mono_to_stereo(const float* input, float* output, const size_t frames) {
+        merge_interleaved_stereo(input, input, output, frames);
+    }
+
+    inline void mix_stereo_to_mono(const float* input, float* output, const size_t frames) {
+        size_t i = 0;
+#if defined(CHANNEL_UTILITIES_SSE2) || defined(CHANNEL_UTILITIES_NEON)
+        const vec4 half = set1(0.5f);
+        for (; i + 4 <= frames; i += 4) {
+            vec4 left, right;
+            unzip(load(input + i * 2), load(input + i * 2 + 4), left, right);
+            store(output + i, mul(add(left, right), half));
+        }
+#endif
+        scalar::mix_stereo_to_mono(input + i * 2, output + i, frames - i);
+    }
+
+    /* multiplies `samples` samples in place with `gain` */
+    inline void apply_gain(float* buffer, const size_t samples, const float gain) {
+        size_t i = 0;
+#if defined(CHANNEL_UTILITIES_SSE2) || defined(CHANNEL_UTILITIES_NEON)
+        const vec4 g = set1(gain);
+        for (; i + 4 <= samples; i += 4) {
+            store(buffer + i, mul(load(buffer + i), g));
+        }
+#endif
+        for (; i < samples; ++i) {
+            buffer[i] *= gain;
+        }
+    }
+
+    /**
+     * mixes interleaved `input` into interleaved `output` with a gain matrix.
+     * `matrix[o * input_channels + c]` is the gain from input channel `c` to output channel `o`.
+     * blocks of frames are deinterleaved into planar scratch buffers, mixed with vectorized
+     * multiply-adds and interleaved again. the scratch buffers have a fixed size of
+     * `MIX_SCRATCH_SAMPLES` samples each, i.e. the more channels the shorter the blocks.
+     *
+     * NOTE `input_channels` and `output_channels` must not exceed `MAX_CHANNELS`
+     */
+    inline void mix_matrix(const float* input, const size_t input_channels, float* output, const size_t output_channels, const float* matrix, size_t frames) {
+        alignas(16) float planar_in[MIX_SCRATCH_SAMPLES];
+        alignas(16) float planar_out[MIX_SCRATCH_SAMPLES];
+        float*            in_channels[MAX_CHANNELS];
+        float*            out_channels[MAX_CHANNELS];
+        /* block length per channel, a multiple of 4 so that every planar channel stays aligned */
+        const size_t      block_size = MIX_SCRATCH_SAMPLES / std::max(std::max(input_channels, output_channels), size_t{1}) / 4 * 4;
+        for (size_t c = 0; c < input_channels; ++c) {
+            in_channels[c] = planar_in + c * block_size;
+        }
+        for (size_t c = 0; c < output_channels; ++c) {
+            out_channels[c] = planar_out + c * block_size;
+        }
+        while (frames > 0) {
+            const size_t block = std::min(frames, block_size);
+            deinterleave(input, in_channels, input_channels, block);
+            for (size_t o = 0; o < output_channels; ++o) {
+                float* out = out_channels[o];
+                std::fill(out, out + block, 0.0f);
+                for (size_t c = 0; c < input_channels; ++c) {
+                    const float gain = matrix[o * input_channels + c];
+                    if (gain == 0.0f) {
+                        continue;
+                    }
+                    const float* in = in_channels[c];
+                    size_t       i  = 0;
+#if defined(CHANNEL_UTILITIES_SSE2) || defined(CHANNEL_UTILITIES_NEON)
+                    const vec4 g = set1(gain);
+                    for (; i + 4 <= block; i += 4) {
+                        store(out + i, add(load(out + i), mul(load(in + i), g)));
+                    }
+#endif
+                    for (; i < block; ++i) {
+                        out[i] += in[i] * gain;
+                    }
+                }
+            }
+            interleave(out_channels, output, output_channels, block);
+            input += block * input_channels;
+            output += block * output_channels;
+            frames -= block;
+        }
+    }
+
+    /**
+     * fills `matrix` ( `output_channels × input_channels` ) with equal power panning gains.
+     * `positions[c]` in [0, 1] places input channel `c` between the first ( 0 ) and the last
+     * ( 1 ) output channel; each input feeds the two nearest outputs.
+     */
+    inline void make_pan_matrix(float* matrix, const size_t input_channels, const size_t output_channels, const float* positions) {
+        std::fill(matrix, matrix + input_channels * output_channels, 0.0f);
+        for (size_t c = 0; c < input_channels; ++c) {
+            if (output_channels == 1) {
+                matrix[c] = 1.0f;
+                continue;
+            }
+            const float  position = std::clamp(positions[c], 0.0f, 1.0f) * static_cast<float>(output_channels - 1);
+            const size_t left     = std::min(static_cast<size_t>(position), output_channels - 2);
+            const float  fraction = position - static_cast<float>(left);
+            matrix[left * input_channels + c]       = std::cos(fraction * static_cast<float>(M_PI) * 0.5f);
+            matrix[(left + 1) * input_channels + c] = std::sin(fraction * static_cast<float>(M_PI) * 0.5f);
+        }
+    }
+
+    /* converts `samples` floats in [-1, 1] to int16. if `dither` is not null triangular ( TPDF ) dither of ±1 LSB is added */
+    inline void float_to_int16(const float* input, int16_t* output, const size_t samples, Dither* dither = nullptr) {
+        size_t i = 0;
+#if defined(CHANNEL_UTILITIES_SSE2) || defined(CHANNEL_UTILITIES_NEON)
+        const vec4 scale = set1(32767.0f);
+        if (dither != nullptr) {
+            ivec4 state = load_state(*dither);
+            for (; i + 8 <= samples; i += 8) {
+                vec4 a = mul(clamp(load(input + i), -1.0f, 1.0f), scale);
+                vec4 b = mul(clamp(load(input + i + 4), -1.0f, 1.0f), scale);
+                a      = add(a, sub(next_uniform(state), next_uniform(state)));
+                b      = add(b, sub(next_uniform(state), next_uniform(state)));
+                store_int16(output + i, a, b);
+            }
+            store_state(*dither, state);
+        } else {
+            for (; i + 8 <= samples; i += 8) {
+                store_int16(output + i, mul(clamp(load(input + i), -1.0f, 1.0f), scale), mul(clamp(load(input + i + 4), -1.0f, 1.0f), scale));
+            }
+        }
+#endif
+        scalar::float_to_int16(input + i, output + i, samples - i, dither);
+    }
+
+    inline void int16_to_float(const int16_t* input, float* output, const size_t samples) {
+        size_t i = 0;
+#if defined(CHANNEL_UTILITIES_SSE2) || defined(CHANNEL_UTILITIES_NEON)
+        const vec4 scale = set1(1.0f / 32768.0f);
+        for (; i + 8 <= samples; i += 8) {
+            vec4 a, b;
+            load_int16(input + i, a, b);
+            store(output + i, mul(a, scale));
+            store(output + i + 4, mul(b, scale));
+        }
+#endif
+        scalar::int16_to_float(input + i, output + i, samples - i);
+    }
+
+    /* NOTE the int24 conversions are scalar only: packed 3 byte samples do not map to vector
+     * lanes, and the dithered conversion needs double precision ( see `scalar::float_to_int24` ) */
+    inline void float_to_int24(const float* input, uint8_t* output, const size_t samples, Dither* dither = nullptr) {
+        scalar::float_to_int24(input, output, samples, dither);
+    }
+
+    inline void int24_to_float(const uint8_t* input, float* output, const size_t samples) {
+        scalar::int24_to_float(input, output, samples);
+    }
+} // namespace simd
@@ -0,0 +1,189 @@
+/*
+ * this example demonstrates vectorized channel utilities: interleaving, deinterleaving, gain
+ * and pan matrices and float ↔ int16/int24 conversion with dither. 8 oscillators are panned
+ * across all output channels of the audio device with an equal power pan matrix; move the
+ * mouse horizontally to rotate them. press `b` to run a micro-benchmark that compares the
+ * SIMD functions with their scalar versions for 2 to 32 channels.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "Umfeld.h"
+#include "audio/AudioUtilities.h"
+#include "audio/Wavetable.h"
+
+#include "ChannelUtilities.h"
+
+using namespace umfeld;
+
+static constexpr int NUMBER_OF_SOURCES = 8;
+
+std::vector<Wavetable*>  oscillators;
+std::vector<float>       source_buffers[NUMBER_OF_SOURCES];
+std::vector<float>       interleaved_sources;
+std::vector<float>       pan_matrix;
+std::atomic<float>       rotation{0.0f};
+std::vector<std::string> benchmark_results;
+
+void settings() {
+    size(1024, 768);
+    audio();
+}
+
+/* runs `function` `iterations` times and returns the average time in nanoseconds per frame */
+template<typename Function>
+float measure(const Function& function, const size_t frames, const size_t iterations = 2000) {
+    function(); // warm up
+    const auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        function();
+    }
+    const float ns = std::chrono::duration<float, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+    return ns / static_cast<float>(iterations * frames);
+}
+
+void add_result(const char* name, const size_t channels, const float scalar_ns, const float simd_ns) {
+    char result[128];
+    snprintf(result, sizeof(result), "%-16s %2zu CH : SCALAR %7.3fns / SIMD %7.3fns per frame ( x%.2f )",
+             name, channels, scalar_ns, simd_ns, scalar_ns / simd_ns);
+    benchmark_results.emplace_back(result);
+    console(benchmark_results.back());
+}
+
+/* for functions without a vector version */
+void add_scalar_result(const char* name, const size_t channels, const float scalar_ns) {
+    char result[128];
+    snprintf(result, sizeof(result), "%-16s %2zu CH : SCALAR %7.3fns per frame ( SCALAR ONLY )", name, channels, scalar_ns);
+    benchmark_results.emplace_back(result);
+    console(benchmark_results.back());
+}
+
+void run_benchmark() {
+    static constexpr size_t FRAMES     = 512;
+    static constexpr size_t CHANNELS[] = {2, 4, 8, 16, 32};
+
+    benchmark_results.clear();
+
+    std::vector<float> left(FRAMES, 0.25f);
+    std::vector<float> right(FRAMES, -0.25f);
+    std::vector<float> stereo(FRAMES * 2);
+    add_result("MERGE STEREO", 2,
+               measure([&] { merge_interleaved_stereo(left.data(), right.data(), stereo.data(), FRAMES); }, FRAMES),
+               measure([&] { simd::merge_interleaved_stereo(left.data(), right.data(), stereo.data(), FRAMES); }, FRAMES));
+    add_result("STEREO TO MONO", 2,
+               measure([&] { simd::scalar::mix_stereo_to_mono(stereo.data(), left.data(), FRAMES); }, FRAMES),
+               measure([&] { simd::mix_stereo_to_mono(stereo.data(), left.data(), FRAMES); }, FRAMES));
+
+    for (const size_t channels: CHANNELS) {
+        std::vector<std::vector<float>> planar(channels, std::vector<float>(FRAMES, 0.5f));
+        std::vector<const float*>       inputs;
+        std::vector<float*>             outputs;
+        for (auto& channel: planar) {
+            inputs.push_back(channel.data());
+            outputs.push_back(channel.data());
+        }
+        std::vector<float> interleaved(FRAMES * channels);
+        std::vector<float> mixed(FRAMES * channels);
+        std::vector<float> matrix(channels * channels, 1.0f / channels);
+
+        add_result("INTERLEAVE", channels,
+                   measure([&] { simd::scalar::interleave(inputs.data(), interleaved.data(), channels, FRAMES); }, FRAMES),
+                   measure([&] { simd::interleave(inputs.data(), interleaved.data(), channels, FRAMES); }, FRAMES));
+        add_result("DEINTERLEAVE", channels,
+                   measure([&] { simd::scalar::deinterleave(interleaved.data(), outputs.data(), channels, FRAMES); }, FRAMES),
+                   measure([&] { simd::deinterleave(interleaved.data(), outputs.data(), channels, FRAMES); }, FRAMES));
+        add_result("GAIN MATRIX", channels,
+                   measure([&] { simd::scalar::mix_matrix(interleaved.data(), channels, mixed.data(), channels, matrix.data(), FRAMES); }, FRAMES, 200),
+                   measure([&] { simd::mix_matrix(interleaved.data(), channels, mixed.data(), channels, matrix.data(), FRAMES); }, FRAMES, 200));
+    }
+
+    std::vector<float>   samples(FRAMES * 2, 0.3f);
+    std::vector<int16_t> int16_samples(FRAMES * 2);
+    std::vector<uint8_t> int24_samples(FRAMES * 2 * 3);
+    simd::Dither         dither;
+    add_result("FLOAT → INT16", 2,
+               measure([&] { simd::scalar::float_to_int16(samples.data(), int16_samples.data(), FRAMES * 2, &dither); }, FRAMES),
+               measure([&] { simd::float_to_int16(samples.data(), int16_samples.data(), FRAMES * 2, &dither); }, FRAMES));
+    add_result("INT16 → FLOAT", 2,
+               measure([&] { simd::scalar::int16_to_float(int16_samples.data(), samples.data(), FRAMES * 2); }, FRAMES),
+               measure([&] { simd::int16_to_float(int16_samples.data(), samples.data(), FRAMES * 2); }, FRAMES));
+    add_scalar_result("FLOAT → INT24", 2,
+                      measure([&] { simd::scalar::float_to_int24(samples.data(), int24_samples.data(), FRAMES * 2, &dither); }, FRAMES));
+}
+
+void setup() {
+    if (get_audio_output_channels() < 1 || get_audio_output_channels() > static_cast<int>(simd::MAX_CHANNELS)) {
+        error("this example requires 1 to " + to_string(simd::MAX_CHANNELS) + " output channels");
+        exit(1);
+    }
+
+    for (int i = 0; i < NUMBER_OF_SOURCES; ++i) {
+        auto* oscillator = new Wavetable(1024, get_audio_sample_rate());
+        oscillator->set_waveform(WAVEFORM_SINE);
+        oscillator->set_frequency(220.0f * (1 + i) * 0.5f);
+        oscillator->set_amplitude(0.5f / NUMBER_OF_SOURCES);
+        oscillators.push_back(oscillator);
+    }
+    pan_matrix.resize(get_audio_output_channels() * NUMBER_OF_SOURCES);
+
+    run_benchmark();
+}
+
+void draw() {
+    background(0.85f);
+
+    rotation = static_cast<float>(mouseX) / width;
+
+    noFill();
+    stroke(1.0f, 0.25f, 0.35f);
+    strokeWeight(16.0f);
+    for (int i = 0; i < NUMBER_OF_SOURCES; ++i) {
+        const float position = std::fmod(rotation + static_cast<float>(i) / NUMBER_OF_SOURCES, 1.0f);
+        const float angle    = position * TWO_PI - HALF_PI;
+        point(width / 2.0f + cos(angle) * height / 4.0f, height / 2.0f + sin(angle) * height / 4.0f);
+    }
+
+    fill(0);
+    debug_text("OUTPUT CHANNELS: " + to_string(get_audio_output_channels()), 10, 10);
+    for (size_t i = 0; i < benchmark_results.size(); ++i) {
+        debug_text(benchmark_results[i], 10, 40 + i * 15);
+    }
+}
+
+void keyPressed() {
+    if (key == 'b') {
+        run_benchmark();
+    }
+}
+
+void audioEvent(const PAudio& audio) {
+    const auto frames = static_cast<size_t>(audio.buffer_size);
+
+    /* NOTE buffers only allocate on the first call or if the buffer size changes */
+    const float* sources[NUMBER_OF_SOURCES];
+    for (int i = 0; i < NUMBER_OF_SOURCES; ++i) {
+        source_buffers[i].resize(frames);
+        for (size_t j = 0; j < frames; ++j) {
+            source_buffers[i][j] = oscillators[i]->process();
+        }
+        sources[i] = source_buffers[i].data();
+    }
+    interleaved_sources.resize(frames * NUMBER_OF_SOURCES);
+    simd::interleave(sources, interleaved_sources.data(), NUMBER_OF_SOURCES, frames);
+
+    float positions[NUMBER_OF_SOURCES];
+    for (int i = 0; i < NUMBER_OF_SOURCES; ++i) {
+        positions[i] = std::fmod(rotation + static_cast<float>(i) / NUMBER_OF_SOURCES, 1.0f);
+    }
+    simd::make_pan_matrix(pan_matrix.data(), NUMBER_OF_SOURCES, audio.output_channels, positions);
+    simd::mix_matrix(interleaved_sources.data(), NUMBER_OF_SOURCES, audio.output_buffer, audio.output_channels, pan_matrix.data(), frames);
+}
+
+void shutdown() {
+    for (const auto* oscillator: oscillators) {
+        delete oscillator;
+    }
+}
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "UniformConvolver.h"
+
+/**
+ * low latency convolution with long impulse responses ( e.g. reverbs of several seconds ).
+ * the impulse response is split into two uniformly partitioned segments ( non-uniform
+ * partitioning ):
+ *
+ * - the head covers the first `2 * tail_block_size - block_size` samples with short
+ *   partitions of `block_size` samples and is processed in the audio thread. it determines
+ *   the latency ( `block_size` samples ).
+ * - the tail covers the rest with long partitions of `tail_block_size` samples and is
+ *   processed by a background thread. long partitions need far fewer operations per sample,
+ *   and the tail starts late enough in the impulse response that the thread has one full
+ *   tail block of time to deliver its output.
+ *
+ * the audio thread hands a full tail block of input to the background thread and picks up
+ * the result two tail blocks later through two preallocated slots and a pair of atomic
+ * counters, i.e. it never waits. if the background thread misses its deadline the tail is
+ * muted for one tail block and an underrun is counted.
+ *
+ * with `tail_block_size = 0` ( or an impulse response shorter than the head ) all partitions
+ * are processed in the audio thread ( uniform partitioning ).
+ *
+ * `process()` accepts blocks of any size. input and output may point to the same buffer.
+ *
+ * NOTE `block_size` and `tail_block_size` must be powers of two with
+ *      `tail_block_size >= block_size`. the impulse response is mono.
+ */
+class PartitionedConvolver {
+public:
+    PartitionedConvolver(const float* impulse_response, const size_t length, const size_t block_size = 256, const size_t tail_block_size = 8192)
+        : fBlockSize(block_size),
+          fTailBlockSize(get_head_length(block_size, tail_block_size) < length ? tail_block_size : 0),
+          fLength(length),
+          fInput(block_size, 0.0f),
+          fOutput(block_size, 0.0f) {
+        const size_t head_length = fTailBlockSize > 0 ? get_head_length(block_size, fTailBlockSize) : length;
+        fHead                    = std::make_unique<UniformConvolver>(fBlockSize, impulse_response, head_length);
+        if (fTailBlockSize > 0) {
+            fTail = std::make_unique<UniformConvolver>(fTailBlockSize, impulse_response + head_length, length - head_length);
+            for (auto& slot: fSlots) {
+                slot.input.assign(fTailBlockSize, 0.0f);
+                slot.output.assign(fTailBlockSize, 0.0f);
+            }
+            fRunning.store(true);
+            fTailThread = std::thread(&PartitionedConvolver::tail_loop, this);
+        }
+    }
+
+    ~PartitionedConvolver() {
+        fRunning.store(false);
+        if (fTailThread.joinable()) {
+            fTailThread.join();
+        }
+    }
+
+    PartitionedConvolver(const PartitionedConvolver&)            = delete;
+    PartitionedConvolver& operator=(const PartitionedConvolver&) = delete;
+
+    /* number of impulse response samples processed in the audio thread */
+    static size_t get_head_length(const size_t block_size, const size_t tail_block_size) {
+        return tail_block_size > 0 ? 2 * tail_block_size - block_size : 0;
+    }
+
+    size_t get_length() const { return fLength; }
+
+    /* latency in samples */
+    size_t get_latency() const { return fBlockSize; }
+
+    size_t get_block_size() const { return fBlockSize; }
+
+    /* 0 if all partitions are processed in the audio thread */
+    size_t get_tail_block_size() const { return fTailBlockSize; }
+
+    size_t get_head_partitions() const { return fHead->get_number_of_partitions(); }
+
+    size_t get_tail_partitions() const { return fTail ? fTail->get_number_of_partitions() : 0; }
+
+    /* average time spent in the audio thread per block of `block_size` samples */
+    float get_head_time_us() const { return fHeadTime.load(std::memory_order_relaxed); }
+
+    /* average time spent in the background thread per block of `tail_block_size` samples */
+    float get_tail_time_us() const { return fTailTime.load(std::memory_order_relaxed); }
+
+    /* number of tail blocks that were not ready in time */
+    uint64_t get_tail_underruns() const { return fTailUnderruns.load(std::memory_order_relaxed); }
+
+    /* audio thread. convolves `frames` samples */
+    void process(const float* input, float* output, const size_t frames) {
+        size_t i = 0;
+        while (i < frames) {
+            const size_t count = std::min(frames - i, fBlockSize - fPosition);
+            /* NOTE copy input before output so that `input` and `output` may be the same buffer */
+            std::copy(input + i, input + i + count, fInput.begin() + fPosition);
+            std::copy(fOutput.begin() + fPosition, fOutput.begin() + fPosition + count, output + i);
+            fPosition += count;
+            i += count;
+            if (fPosition == fBlockSize) {
+                fPosition = 0;
+                process_block();
+            }
+        }
+    }
+
+private:
+    static constexpr float SMOOTHING     = 0.05f;
+    static constexpr auto  POLL_INTERVAL = std::chrono::microseconds(500);
+
+    struct Slot {
+        std::vector<float> input;
+        std::vector<float> output;
+        int64_t            block{-1};
+    };
+
+    const size_t                      fBlockSize;
+    const size_t                      fTailBlockSize;
+    const size_t                      fLength;
+    std::unique_ptr<UniformConvolver> fHead;
+    std::unique_ptr<UniformConvolver> fTail;
+    std::vector<float>                fInput;
+    std::vector<float>                fOutput;
+    size_t                            fPosition{0};
+    std::atomic<float>                fHeadTime{0.0f};
+    std::atomic<float>                fTailTime{0.0f};
+
+    /* tail state. the audio thread owns `fWriteSlot` and `fReadSlot`, the background thread owns the submitted slot */
+    Slot                  fSlots[2];
+    int                   fWriteSlot{0};
+    int                   fReadSlot{-1};
+    int                   fSubmittedSlot{0};
+    size_t                fTailPosition{0};
+    int64_t               fPeriod{0};
+    std::atomic<uint64_t> fSubmitted{0};
+    std::atomic<uint64_t> fCompleted{0};
+    std::atomic<uint64_t> fTailUnderruns{0};
+    std::atomic<bool>     fRunning{false};
+    std::thread           fTailThread;
+
+    static void update_average(std::atomic<float>& average, const float value) {
+        const float current = average.load(std::memory_order_relaxed);
+        average.store(current + SMOOTHING * (value - current), std::memory_order_relaxed);
+    }
+
+    void process_block() {
+        const auto start = std::chrono::steady_clock::now();
+
+        size_t tail_offset = 0;
+        if (fTail) {
+            std::copy(fInput.begin(), fInput.end(), fSlots[fWriteSlot].input.begin() + fTailPosition);
+            fTailPosition += fBlockSize;
+            if (fTailPosition == fTailBlockSize) {
+                fTailPosition = 0;
+                submit_tail_block();
+            }
+            tail_offset = fTailPosition;
+        }
+
+        fHead->process_block(fInput.data(), fOutput.data());
+
+        /* the result of tail block `n` is played during tail period `n + 2` */
+        if (fReadSlot >= 0) {
+            const float* tail = fSlots[fReadSlot].output.data() + tail_offset;
+            for (size_t i = 0; i < fBlockSize; ++i) {
+                fOutput[i] += tail[i];
+            }
+        }
+
+        const float elapsed = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count();
+        update_average(fHeadTime, elapsed);
+    }
+
+    /* audio thread. called when tail period `fPeriod` is complete */
+    void submit_tail_block() {
+        const uint64_t submitted = fSubmitted.load(std::memory_order_relaxed);
+        const int      other     = 1 - fWriteSlot;
+        if (fCompleted.load(std::memory_order_acquire) == submitted) {
+            /* the other slot holds the last submitted block, which is due in the next period */
+            fReadSlot                = fSlots[other].block == fPeriod - 1 ? other : -1;
+            fSlots[fWriteSlot].block = fPeriod;
+            fSubmittedSlot           = fWriteSlot;
+            fSubmitted.store(submitted + 1, std::memory_order_release);
+            fWriteSlot = other;
+        } else {
+            /* background thread is late: mute the tail and drop this block ( it is overwritten in the next period ) */
+            fReadSlot = -1;
+            fTailUnderruns.fetch_add(1, std::memory_order_relaxed);
+        }
+        ++fPeriod;
+    }
+
+    void tail_loop() {
+        int64_t expected_block = 0;
+        while (fRunning.load()) {
+            const uint64_t submitted = fSubmitted.load(std::memory_order_acquire);
+            if (submitted == fCompleted.load(std::memory_order_relaxed)) {
+                std::this_thread::sleep_for(POLL_INTERVAL);
+                continue;
+            }
+            Slot& slot = fSlots[fSubmittedSlot];
+            if (slot.block > expected_block) {
+                /* dropped blocks enter the delay line as silence to keep the timing */
+                fTail->skip_blocks(static_cast<size_t>(slot.block - expected_block));
+            }
+            const auto start = std::chrono::steady_clock::now();
+            fTail->process_block(slot.input.data(), slot.output.data());
+            const float elapsed = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count();
+            update_average(fTailTime, elapsed);
+            expected_block = slot.block + 1;
+            fCompleted.store(submitted, std::memory_order_release);
+        }
+    }
+};
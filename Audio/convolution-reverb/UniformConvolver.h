@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "RealFFT.h"
+
+/**
+ * uniformly partitioned convolution ( overlap-save ). the impulse response is split into
+ * partitions of `block_size` samples whose spectra are computed once in the constructor. each
+ * call to `process_block()` transforms one block of input, stores its spectrum in a frequency
+ * domain delay line and multiplies the delay line with the partition spectra. this costs one
+ * forward and one inverse FFT of size `2 * block_size` per block plus one complex
+ * multiply-add per partition and bin, instead of `ir_length` multiply-adds per sample.
+ *
+ * the output of `process_block()` belongs to the same block as the input, i.e. the
+ * convolver adds no latency on top of collecting a full block.
+ *
+ * all memory is allocated in the constructor.
+ *
+ * NOTE `block_size` must be a power of two and at least 2.
+ */
+class UniformConvolver {
+public:
+    UniformConvolver(const size_t block_size, const float* impulse_response, const size_t length)
+        : fBlockSize(block_size),
+          fBins(block_size + 1),
+          fPartitions(std::max<size_t>(1, (length + block_size - 1) / block_size)),
+          fFFT(block_size * 2),
+          fFilterReal(fPartitions * fBins, 0.0f),
+          fFilterImag(fPartitions * fBins, 0.0f),
+          fDelayLineReal(fPartitions * fBins, 0.0f),
+          fDelayLineImag(fPartitions * fBins, 0.0f),
+          fAccumulatorReal(fBins),
+          fAccumulatorImag(fBins),
+          fTimeDomain(block_size * 2, 0.0f),
+          fInverse(block_size * 2) {
+        /* the inverse FFT is scaled by `block_size`, compensate in the filter spectra */
+        const float normalization = 1.0f / static_cast<float>(block_size);
+        for (size_t p = 0; p < fPartitions; ++p) {
+            std::fill(fTimeDomain.begin(), fTimeDomain.end(), 0.0f);
+            const size_t offset = p * block_size;
+            const size_t count  = offset < length ? std::min(block_size, length - offset) : 0;
+            for (size_t i = 0; i < count; ++i) {
+                fTimeDomain[i] = impulse_response[offset + i] * normalization;
+            }
+            fFFT.forward(fTimeDomain.data(), &fFilterReal[p * fBins], &fFilterImag[p * fBins]);
+        }
+        std::fill(fTimeDomain.begin(), fTimeDomain.end(), 0.0f);
+    }
+
+    size_t get_block_size() const { return fBlockSize; }
+
+    size_t get_number_of_partitions() const { return fPartitions; }
+
+    /* clears the input history and the delay line */
+    void reset() {
+        std::fill(fDelayLineReal.begin(), fDelayLineReal.end(), 0.0f);
+        std::fill(fDelayLineImag.begin(), fDelayLineImag.end(), 0.0f);
+        std::fill(fTimeDomain.begin(), fTimeDomain.end(), 0.0f);
+        fNewest = 0;
+    }
+
+    /* advances the delay line by `count` blocks of silence without computing any output */
+    void skip_blocks(const size_t count) {
+        for (size_t i = 0; i < std::min(count, fPartitions); ++i) {
+            fNewest = fNewest == 0 ? fPartitions - 1 : fNewest - 1;
+            std::fill_n(fDelayLineReal.begin() + fNewest * fBins, fBins, 0.0f);
+            std::fill_n(fDelayLineImag.begin() + fNewest * fBins, fBins, 0.0f);
+        }
+        if (count > 0) {
+            std::fill(fTimeDomain.begin() + fBlockSize, fTimeDomain.end(), 0.0f);
+        }
+    }
+
+    /* convolves `block_size` samples of `input` and writes ( or adds ) `block_size` samples to `output` */
+    void process_block(const float* input, float* output, const bool accumulate = false) {
+        /* the FFT input is the previous block followed by the current block */
+        std::copy(fTimeDomain.begin() + fBlockSize, fTimeDomain.end(), fTimeDomain.begin());
+        std::copy(input, input + fBlockSize, fTimeDomain.begin() + fBlockSize);
+
+        fNewest = fNewest == 0 ? fPartitions - 1 : fNewest - 1;
+        fFFT.forward(fTimeDomain.data(), &fDelayLineReal[fNewest * fBins], &fDelayLineImag[fNewest * fBins]);
+
+        /* partition `p` is multiplied with the spectrum of the input `p` blocks ago */
+        std::fill(fAccumulatorReal.begin(), fAccumulatorReal.end(), 0.0f);
+        std::fill(fAccumulatorImag.begin(), fAccumulatorImag.end(), 0.0f);
+        size_t slot = fNewest;
+        for (size_t p = 0; p < fPartitions; ++p) {
+            multiply_add(&fDelayLineReal[slot * fBins], &fDelayLineImag[slot * fBins],
+                         &fFilterReal[p * fBins], &fFilterImag[p * fBins]);
+            slot = slot + 1 == fPartitions ? 0 : slot + 1;
+        }
+
+        /* only the second half of the inverse transform is valid, the first half is aliased */
+        fFFT.inverse(fAccumulatorReal.data(), fAccumulatorImag.data(), fInverse.data());
+        const float* valid = fInverse.data() + fBlockSize;
+        if (accumulate) {
+            for (size_t i = 0; i < fBlockSize; ++i) {
+                output[i] += valid[i];
+            }
+        } else {
+            std::copy(valid, valid + fBlockSize, output);
+        }
+    }
+
+private:
+    const size_t       fBlockSize;
+    const size_t       fBins;
+    const size_t       fPartitions;
+    RealFFT            fFFT;
+    std::vector<float> fFilterReal;
+    std::vector<float> fFilterImag;
+    std::vector<float> fDelayLineReal;
+    std::vector<float> fDelayLineImag;
+    std::vector<float> fAccumulatorReal;
+    std::vector<float> fAccumulatorImag;
+    std::vector<float> fTimeDomain;
+    std::vector<float> fInverse;
+    size_t             fNewest{0};
+
+    void multiply_add(const float* __restrict x_real, const float* __restrict x_imag,
+                      const float* __restrict h_real, const float* __restrict h_imag) {
+        float* __restrict y_real = fAccumulatorReal.data();
+        float* __restrict y_imag = fAccumulatorImag.data();
+        for (size_t i = 0; i < fBins; ++i) {
+            y_real[i] += x_real[i] * h_real[i] - x_imag[i] * h_imag[i];
+            y_imag[i] += x_real[i] * h_imag[i] + x_imag[i] * h_real[i];
+        }
+    }
+};
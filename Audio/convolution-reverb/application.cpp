@@ -0,0 +1,192 @@
+/*
+ * this example demonstrates a convolution reverb with a partitioned FFT convolution engine.
+ * the impulse response is loaded with the same loader as samples ( `loadSample()` ) and
+ * resampled to the audio sample rate if necessary ( see `Resampler` from the `resampler`
+ * example ). the first part of the impulse response is processed in the audio thread with
+ * short partitions ( low latency ), the long tail is processed with long partitions in a
+ * background thread.
+ *
+ * move the mouse horizontally to change the dry/wet mix. press `1` to switch between the
+ * convolution reverb and the algorithmic `Reverb` from `audio/Reverb.h`. press `b` to
+ * measure the CPU cost per block for impulse responses of different lengths.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "Umfeld.h"
+#include "audio/AudioUtilities.h"
+#include "audio/Sampler.h"
+#include "audio/Reverb.h"
+
+#include "PartitionedConvolver.h"
+#include "Resampler.h"
+
+using namespace umfeld;
+
+static constexpr size_t BLOCK_SIZE      = 256;
+static constexpr size_t TAIL_BLOCK_SIZE = 8192;
+
+Sampler*                 sampler;
+Reverb*                  reverb;
+PartitionedConvolver*    convolver;
+std::atomic<bool>        use_convolution{true};
+std::atomic<float>       mix{0.5f};
+std::vector<std::string> benchmark_results;
+
+void settings() {
+    size(1024, 768);
+    audio();
+}
+
+/* average time in microseconds that `convolver` needs for one block of noise */
+float measure(UniformConvolver& convolver, const size_t blocks) {
+    std::vector<float> input(convolver.get_block_size());
+    std::vector<float> output(convolver.get_block_size());
+    for (auto& sample: input) {
+        sample = static_cast<float>(rand()) / RAND_MAX * 2.0f - 1.0f;
+    }
+    convolver.process_block(input.data(), output.data()); // warm up
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < blocks; ++i) {
+        convolver.process_block(input.data(), output.data());
+    }
+    return std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count() / blocks;
+}
+
+void run_benchmark() {
+    static constexpr float LENGTHS[] = {0.5f, 1.0f, 2.0f, 4.0f, 8.0f};
+
+    const float  sample_rate = get_audio_sample_rate();
+    const float  budget      = BLOCK_SIZE * 1000000.0f / sample_rate;
+    const size_t head_length = PartitionedConvolver::get_head_length(BLOCK_SIZE, TAIL_BLOCK_SIZE);
+
+    benchmark_results.clear();
+    char result[192];
+    snprintf(result, sizeof(result), "CPU TIME PER BLOCK OF %zu SAMPLES ( budget %.1fus )", BLOCK_SIZE, budget);
+    benchmark_results.emplace_back(result);
+    console(benchmark_results.back());
+
+    for (const float seconds: LENGTHS) {
+        const auto         length = static_cast<size_t>(seconds * sample_rate);
+        std::vector<float> impulse_response(length);
+        for (size_t i = 0; i < length; ++i) {
+            impulse_response[i] = (static_cast<float>(rand()) / RAND_MAX * 2.0f - 1.0f) * std::exp(-6.9f * i / length);
+        }
+
+        UniformConvolver uniform(BLOCK_SIZE, impulse_response.data(), length);
+        UniformConvolver head(BLOCK_SIZE, impulse_response.data(), std::min(head_length, length));
+        const float      uniform_us = measure(uniform, 20);
+        const float      head_us    = measure(head, 20);
+        float            tail_us    = 0.0f;
+        if (length > head_length) {
+            /* amortized over the audio blocks of one tail block */
+            UniformConvolver tail(TAIL_BLOCK_SIZE, impulse_response.data() + head_length, length - head_length);
+            tail_us = measure(tail, 4) * BLOCK_SIZE / TAIL_BLOCK_SIZE;
+        }
+
+        snprintf(result, sizeof(result), "IR %4.1fs : UNIFORM %8.1fus ( %5.1f%% ) | PARTITIONED audio thread %6.1fus ( %5.1f%% ) + background %6.1fus",
+                 seconds, uniform_us, 100.0f * uniform_us / budget, head_us, 100.0f * head_us / budget, tail_us);
+        benchmark_results.emplace_back(result);
+        console(benchmark_results.back());
+    }
+}
+
+void setup() {
+    if (get_audio_output_channels() != 2) {
+        error("this example requires a stereo output");
+        exit(1);
+    }
+
+    sampler = loadSample("teilchen.wav");
+    sampler->set_looping();
+    sampler->play();
+
+    reverb = new Reverb();
+
+    /* NOTE the impulse response is only needed to compute the partition spectra */
+    Sampler*           impulse_response = loadSample("impulse-response.wav");
+    const float*       ir_buffer        = impulse_response->get_buffer();
+    size_t             ir_length        = impulse_response->get_buffer_length();
+    std::vector<float> ir_resampled;
+    if (impulse_response->get_sample_rate() != get_audio_sample_rate()) {
+        const double ir_sample_rate = impulse_response->get_sample_rate();
+        if (get_audio_sample_rate() / ir_sample_rate < Resampler::MIN_RATIO) {
+            error("can not resample impulse response from " + to_string(static_cast<int>(ir_sample_rate)) + " to " + to_string(static_cast<int>(get_audio_sample_rate())) + " Hz");
+            exit(1);
+        }
+        console("resampling impulse response from ", ir_sample_rate, " to ", get_audio_sample_rate(), " Hz");
+        ir_resampled = Resampler::resample(ir_buffer, ir_length, ir_sample_rate, get_audio_sample_rate());
+        ir_buffer    = ir_resampled.data();
+        ir_length    = ir_resampled.size();
+    }
+    convolver = new PartitionedConvolver(ir_buffer, ir_length, BLOCK_SIZE, TAIL_BLOCK_SIZE);
+    delete impulse_response;
+}
+
+void draw() {
+    background(0.85f);
+
+    mix = static_cast<float>(mouseX) / width;
+
+    noFill();
+    stroke(1.0f, 0.25f, 0.35f);
+    strokeWeight(16.0f);
+    arc(width / 2.0f, height / 2.0f, height / 2.0f, height / 2.0f, -HALF_PI, TWO_PI * mix - HALF_PI);
+
+    const float budget = BLOCK_SIZE * 1000000.0f / get_audio_sample_rate();
+    char        info[192];
+    fill(0);
+    debug_text(use_convolution ? "CONVOLUTION REVERB" : "ALGORITHMIC REVERB", 10, 10);
+    snprintf(info, sizeof(info), "IMPULSE RESPONSE: %.2fs / LATENCY: %zu samples / PARTITIONS: %zu x %zu + %zu x %zu",
+             convolver->get_length() / get_audio_sample_rate(), convolver->get_latency(),
+             convolver->get_head_partitions(), convolver->get_block_size(),
+             convolver->get_tail_partitions(), convolver->get_tail_block_size());
+    debug_text(info, 10, 25);
+    snprintf(info, sizeof(info), "AUDIO THREAD: %.1fus per block ( %.1f%% ) / BACKGROUND: %.1fus per tail block / UNDERRUNS: %llu",
+             convolver->get_head_time_us(), 100.0f * convolver->get_head_time_us() / budget,
+             convolver->get_tail_time_us(), static_cast<unsigned long long>(convolver->get_tail_underruns()));
+    debug_text(info, 10, 40);
+    for (size_t i = 0; i < benchmark_results.size(); ++i) {
+        debug_text(benchmark_results[i], 10, 70 + i * 15);
+    }
+}
+
+void keyPressed() {
+    if (key == '1') {
+        use_convolution = !use_convolution;
+    }
+    if (key == 'b') {
+        run_benchmark();
+    }
+}
+
+void audioEvent(const PAudio& audio) {
+    float dry[audio.buffer_size];
+    float wet[audio.buffer_size];
+    for (int i = 0; i < audio.buffer_size; i++) {
+        dry[i] = sampler->process();
+    }
+    if (use_convolution) {
+        convolver->process(dry, wet, audio.buffer_size);
+    } else {
+        for (int i = 0; i < audio.buffer_size; i++) {
+            wet[i] = reverb->process(dry[i]);
+        }
+    }
+    const float wet_gain = mix;
+    for (int i = 0; i < audio.buffer_size; i++) {
+        dry[i] = dry[i] * (1.0f - wet_gain) + wet[i] * wet_gain;
+    }
+    merge_interleaved_stereo(dry, dry, audio.output_buffer, audio.buffer_size);
+}
+
+void shutdown() {
+    delete convolver;
+    delete reverb;
+    delete sampler;
+}
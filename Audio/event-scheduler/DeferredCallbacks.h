@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "SPSCQueue.h"
+
+/**
+ * calls listeners outside of the audio thread. the audio thread only pushes events into a
+ * lock-free queue with `notify()`; another thread ( usually `draw()` ) calls `dispatch()`,
+ * which invokes all listeners with the queued events. listener code may therefore take as
+ * long as it wants, allocate or lock without ever stalling the audio thread.
+ *
+ * if the queue is full ( e.g. `dispatch()` is not called often enough ) events are dropped
+ * and counted. listeners must be added before the audio thread starts calling `notify()`.
+ */
+template<typename T, size_t CAPACITY = 256>
+class DeferredCallbacks {
+public:
+    using Listener = std::function<void(const T&)>;
+
+    /* setup. NOTE not thread-safe */
+    void add_listener(const Listener& listener) { fListeners.push_back(listener); }
+
+    /* audio thread. queues `event` for the listeners */
+    bool notify(const T& event) {
+        if (!fQueue.push(event)) {
+            fDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    /* consumer thread. calls all listeners with all queued events. returns the number of events */
+    size_t dispatch() {
+        size_t count = 0;
+        T      event;
+        while (fQueue.pop(event)) {
+            for (const auto& listener: fListeners) {
+                listener(event);
+            }
+            ++count;
+        }
+        return count;
+    }
+
+    uint64_t get_dropped_events() const { return fDropped.load(std::memory_order_relaxed); }
+
+private:
+    SPSCQueue<T, CAPACITY> fQueue;
+    std::vector<Listener>  fListeners;
+    std::atomic<uint64_t>  fDropped{0};
+};
@@ -0,0 +1,226 @@
+/*
+ * this example demonstrates how to schedule events at exact sample positions and how to call
+ * listeners outside of the audio thread.
+ *
+ * notes from the keyboard, from a sequence started in `draw()` and from a MIDI keyboard are
+ * posted to an `EventScheduler`, which places them at sample accurate offsets inside the next
+ * audio block ( instead of at the start of whatever block happens to be processed next ).
+ * the beats of a `Trigger` fed by an LFO start the ADSR directly in the audio thread, but the
+ * listeners that react to them ( drawing, console output ) are called from `draw()` via
+ * `DeferredCallbacks`.
+ *
+ * press and hold `1` to play a note. press `s` to schedule a sequence of 8 notes. press `t`
+ * to toggle the LFO trigger. move the mouse vertically to change the LFO frequency.
+ */
+
+#include <atomic>
+#include <cmath>
+
+#include "Umfeld.h"
+#include "MIDI.h"
+#include "audio/AudioUtilities.h"
+#include "audio/ADSR.h"
+#include "audio/Trigger.h"
+#include "audio/Wavetable.h"
+
+#include "DeferredCallbacks.h"
+#include "EventScheduler.h"
+
+using namespace umfeld;
+
+struct NoteEvent {
+    enum Type {
+        NOTE_ON,
+        NOTE_OFF
+    };
+    Type type{NOTE_ON};
+    int  note{0};
+};
+
+/* edge of the LFO trigger and the absolute frame at which it occurred */
+struct BeatEvent {
+    int      event{0};
+    uint64_t frame{0};
+};
+
+Wavetable*                           wavetable_oscillator;
+Wavetable*                           lfo;
+ADSR*                                adsr;
+Trigger*                             trigger;
+EventScheduler<NoteEvent>*           scheduler;
+EventScheduler<NoteEvent>::Producer* keyboard_events; // main thread: keyboard and `draw()`
+EventScheduler<NoteEvent>::Producer* midi_events;     // MIDI thread
+DeferredCallbacks<BeatEvent>         beat_callbacks;
+std::atomic<bool>                    use_trigger{true};
+bool                                 toggle        = false;
+uint64_t                             current_frame = 0; // audio thread: absolute frame currently rendered
+MIDI                                 midi;
+
+/* called from the MIDI thread */
+class SchedulerMIDI final : public MIDIListener {
+    void note_off(int channel, int note) override { midi_events->post({NoteEvent::NOTE_OFF, note}); }
+    void note_on(int channel, int note, int velocity) override {
+        midi_events->post({velocity == 0 ? NoteEvent::NOTE_OFF : NoteEvent::NOTE_ON, note});
+    }
+    void midi_message(const std::vector<unsigned char>& message) override {}
+    void control_change(int channel, int control, int value) override {}
+    void program_change(int channel, int program) override {}
+    void pitch_bend(int channel, int value) override {}
+    void sys_ex(const std::vector<unsigned char>& message) override {}
+};
+
+SchedulerMIDI midi_listener;
+
+/* called from the audio thread at the exact sample of the edge. NOTE only real-time safe code here */
+void beat(const int event) {
+    if (event == EVENT_RISING_EDGE) {
+        adsr->start();
+    } else {
+        adsr->stop();
+    }
+    beat_callbacks.notify({event, current_frame});
+}
+
+void settings() {
+    size(1024, 768);
+    audio();
+    run_audio_in_thread = true;
+}
+
+void setup() {
+    if (get_audio_output_channels() != 2) {
+        error("this example requires a stereo output");
+        exit(1);
+    }
+
+    adsr    = new ADSR(get_audio_sample_rate());
+    trigger = new Trigger();
+    trigger->set_callback(beat);
+
+    lfo = new Wavetable(2048, get_audio_sample_rate());
+    lfo->set_waveform(WAVEFORM_TRIANGLE);
+    lfo->set_frequency(1.0f);
+
+    wavetable_oscillator = new Wavetable(1024, get_audio_sample_rate());
+    wavetable_oscillator->set_waveform(WAVEFORM_SAWTOOTH_HARMONICS, 8);
+    wavetable_oscillator->set_frequency(110.0f);
+    wavetable_oscillator->set_amplitude(0.5f);
+
+    scheduler       = new EventScheduler<NoteEvent>(get_audio_sample_rate());
+    keyboard_events = &scheduler->add_producer();
+    midi_events     = &scheduler->add_producer();
+
+    /* listeners run in `draw()`, i.e. they may print, allocate or lock */
+    beat_callbacks.add_listener([](const BeatEvent& beat_event) {
+        toggle = beat_event.event == EVENT_RISING_EDGE;
+    });
+    beat_callbacks.add_listener([](const BeatEvent& beat_event) {
+        if (beat_event.event == EVENT_RISING_EDGE) {
+            console("beat at frame ", beat_event.frame);
+        }
+    });
+
+    midi.print_available_ports();
+    midi.open_input_port(0);
+    midi.callback(&midi_listener);
+}
+
+void draw() {
+    beat_callbacks.dispatch();
+
+    background(0.85f);
+    if (toggle) {
+        noStroke();
+        fill(1.0f, 0.25f, 0.35f);
+        circle(width / 2.0f, height / 2.0f, 100);
+    } else {
+        noFill();
+        stroke(1.0f, 0.25f, 0.35f);
+        circle(width / 2.0f, height / 2.0f, 100);
+    }
+
+    fill(0);
+    debug_text("FRAME POSITION: " + to_string(scheduler->get_frame_position()), 10, 10);
+    debug_text("LATE EVENTS   : " + to_string(scheduler->get_late_events()), 10, 25);
+    debug_text("DROPPED EVENTS: " + to_string(scheduler->get_dropped_events() + beat_callbacks.get_dropped_events()), 10, 40);
+    debug_text(use_trigger ? "LFO TRIGGER   : ON" : "LFO TRIGGER   : OFF", 10, 55);
+
+    lfo->set_frequency(map(mouseY, 0, height, 0.1f, 10.0f));
+}
+
+void keyPressed() {
+    if (key == '1') {
+        keyboard_events->post({NoteEvent::NOTE_ON, 45});
+    }
+    if (key == 's') {
+        /* 8 notes of 1/8 second each, starting 50ms from now */
+        static constexpr int NOTES[] = {45, 52, 57, 60, 64, 60, 57, 52};
+        const auto           step    = static_cast<uint64_t>(get_audio_sample_rate() * 0.125f);
+        const uint64_t       start   = scheduler->get_frame_position() + static_cast<uint64_t>(get_audio_sample_rate() * 0.05f);
+        for (size_t i = 0; i < 8; ++i) {
+            keyboard_events->post_at_frame({NoteEvent::NOTE_ON, NOTES[i]}, start + i * step);
+            keyboard_events->post_at_frame({NoteEvent::NOTE_OFF, NOTES[i]}, start + i * step + step / 2);
+        }
+    }
+    if (key == 't') {
+        use_trigger = !use_trigger;
+    }
+}
+
+void keyReleased() {
+    if (key == '1') {
+        keyboard_events->post({NoteEvent::NOTE_OFF, 45});
+    }
+}
+
+void handle(const NoteEvent& event) {
+    if (event.type == NoteEvent::NOTE_ON) {
+        wavetable_oscillator->set_frequency(440.0f * std::pow(2.0f, (event.note - 69) / 12.0f));
+        adsr->start();
+    } else {
+        adsr->stop();
+    }
+}
+
+void render(float* buffer, const size_t from, const size_t to) {
+    const bool     trigger_enabled = use_trigger;
+    const uint64_t block_start     = scheduler->get_frame_position();
+    for (size_t i = from; i < to; i++) {
+        current_frame = block_start + i;
+        /* feed lfo to trigger. `beat()` is called at the exact sample of the edge */
+        const float modulation = lfo->process();
+        if (trigger_enabled) {
+            trigger->process(modulation);
+        }
+        float sample = wavetable_oscillator->process();
+        sample       = adsr->process(sample);
+        buffer[i]    = sample;
+    }
+}
+
+void audioEvent(const PAudio& audio) {
+    const auto frames = static_cast<size_t>(audio.buffer_size);
+    float      sample_buffer[audio.buffer_size];
+
+    /* render up to each event, apply it and continue */
+    scheduler->begin_block(frames);
+    size_t    position = 0;
+    size_t    offset;
+    NoteEvent event;
+    while (scheduler->next_event(event, offset)) {
+        render(sample_buffer, position, offset);
+        handle(event);
+        position = offset;
+    }
+    render(sample_buffer, position, frames);
+
+    merge_interleaved_stereo(sample_buffer, sample_buffer, audio.output_buffer, audio.buffer_size);
+}
+
+void shutdown() {
+    delete wavetable_oscillator;
+    delete lfo;
+    delete adsr;
+    delete trigger;
+    delete scheduler;
+}
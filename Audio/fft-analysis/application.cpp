@@ -1,5 +1,8 @@
 /*
  * this example demonstrates how to generate a wavetable oscillator sound with ADSR envelope and reverb.
+ *
+ * NOTE `fft_process()` allocates a new vector for every block. see `Audio/fft-analyzer` for an
+ * analyzer that is safe to use on the audio thread.
  */
 
 #include "Umfeld.h"
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "TripleBuffer.h"
+
+/**
+ * real-time safe FFT analyzer. all memory ( window, twiddle factors, bit reversal table,
+ * input history and work buffers ) is allocated in the constructor, so `process()` and
+ * `analyze()` never allocate.
+ *
+ * `process()` accepts blocks of any size, collects them in a history buffer and analyzes the
+ * last `fft_size` samples every `hop_size` samples ( e.g. `hop_size = fft_size / 4` for 75%
+ * overlap ). each result is published to a triple buffer that another thread ( e.g `draw()` )
+ * can read with `acquire_spectrum()` without locks and without tearing. `analyze()` computes
+ * a single frame into a caller-provided output instead.
+ *
+ * results are magnitudes in dB relative to a full scale sine wave, one value per bin from DC
+ * to nyquist ( `fft_size / 2 + 1` bins ).
+ *
+ * NOTE `fft_size` must be a power of two.
+ */
+class FFTAnalyzer {
+public:
+    enum Window {
+        RECTANGULAR,
+        HANN,
+        HAMMING,
+        BLACKMAN
+    };
+
+    static constexpr float MIN_DB = -120.0f;
+
+    FFTAnalyzer(const size_t fft_size, const size_t hop_size, const float sample_rate, const Window window = HANN)
+        : fSize(fft_size),
+          fHopSize(std::clamp<size_t>(hop_size, 1, fft_size)),
+          fSampleRate(sample_rate),
+          fWindow(fft_size),
+          fCos(fft_size / 2),
+          fSin(fft_size / 2),
+          fBitReversed(fft_size),
+          fHistory(fft_size, 0.0f),
+          fFrame(fft_size),
+          fReal(fft_size),
+          fImag(fft_size),
+          fSpectrum(fft_size / 2 + 1, MIN_DB) {
+        set_window(window);
+
+        for (size_t i = 0; i < fSize / 2; ++i) {
+            const double phase = -2.0 * M_PI * static_cast<double>(i) / static_cast<double>(fSize);
+            fCos[i]            = static_cast<float>(std::cos(phase));
+            fSin[i]            = static_cast<float>(std::sin(phase));
+        }
+
+        size_t bits = 0;
+        while ((size_t{1} << bits) < fSize) {
+            ++bits;
+        }
+        for (size_t i = 0; i < fSize; ++i) {
+            size_t r = 0;
+            for (size_t b = 0; b < bits; ++b) {
+                r |= ((i >> b) & 1) << (bits - 1 - b);
+            }
+            fBitReversed[i] = r;
+        }
+    }
+
+    /* NOTE not thread-safe. only call this while the analyzer is not processing */
+    void set_window(const Window window) {
+        float sum = 0.0f;
+        for (size_t i = 0; i < fSize; ++i) {
+            const double r = 2.0 * M_PI * static_cast<double>(i) / static_cast<double>(fSize);
+            switch (window) {
+                case RECTANGULAR:
+                    fWindow[i] = 1.0f;
+                    break;
+                case HANN:
+                    fWindow[i] = static_cast<float>(0.5 - 0.5 * std::cos(r));
+                    break;
+                case HAMMING:
+                    fWindow[i] = static_cast<float>(0.54 - 0.46 * std::cos(r));
+                    break;
+                case BLACKMAN:
+                    fWindow[i] = static_cast<float>(0.42 - 0.5 * std::cos(r) + 0.08 * std::cos(2.0 * r));
+                    break;
+            }
+            sum += fWindow[i];
+        }
+        /* a full scale sine wave results in 0dB */
+        fNormalization = sum > 0.0f ? 2.0f / sum : 1.0f;
+    }
+
+    size_t get_fft_size() const { return fSize; }
+
+    size_t get_hop_size() const { return fHopSize; }
+
+    size_t get_number_of_bins() const { return fSize / 2 + 1; }
+
+    float get_bin_frequency(const size_t bin) const { return static_cast<float>(bin) * fSampleRate / static_cast<float>(fSize); }
+
+    /* audio thread. collects `frames` samples and analyzes every `hop_size` samples. returns the number of analyzed frames */
+    size_t process(const float* input, const size_t frames) {
+        size_t analyzed = 0;
+        for (size_t i = 0; i < frames; ++i) {
+            fHistory[fWritePosition] = input[i];
+            fWritePosition           = (fWritePosition + 1) % fSize;
+            if (++fSamplesSinceAnalysis >= fHopSize) {
+                fSamplesSinceAnalysis = 0;
+                /* unwrap history so that the oldest sample comes first */
+                std::copy(fHistory.begin() + fWritePosition, fHistory.end(), fFrame.begin());
+                std::copy(fHistory.begin(), fHistory.begin() + fWritePosition, fFrame.begin() + (fSize - fWritePosition));
+                analyze(fFrame.data(), fSpectrum.write_buffer());
+                fSpectrum.publish();
+                ++analyzed;
+            }
+        }
+        return analyzed;
+    }
+
+    /* analyzes `fft_size` samples of `input` and writes `get_number_of_bins()` values in dB into `output`.
+     * NOTE uses the internal work buffers, i.e do not call this concurrently with `process()` */
+    void analyze(const float* input, float* output) {
+        for (size_t i = 0; i < fSize; ++i) {
+            const size_t j = fBitReversed[i];
+            fReal[j]       = input[i] * fWindow[i];
+            fImag[j]       = 0.0f;
+        }
+        transform();
+        const size_t bins = get_number_of_bins();
+        for (size_t i = 0; i < bins; ++i) {
+            const float magnitude = std::sqrt(fReal[i] * fReal[i] + fImag[i] * fImag[i]) * fNormalization;
+            output[i]             = magnitude > 0.0f ? std::max(20.0f * std::log10(magnitude), MIN_DB) : MIN_DB;
+        }
+    }
+
+    /* render thread. returns the latest published spectrum. the pointer stays valid until the next call */
+    const float* acquire_spectrum() {
+        fSpectrum.acquire();
+        return fSpectrum.read_buffer();
+    }
+
+private:
+    const size_t        fSize;
+    const size_t        fHopSize;
+    const float         fSampleRate;
+    std::vector<float>  fWindow;
+    std::vector<float>  fCos;
+    std::vector<float>  fSin;
+    std::vector<size_t> fBitReversed;
+    std::vector<float>  fHistory;
+    std::vector<float>  fFrame;
+    std::vector<float>  fReal;
+    std::vector<float>  fImag;
+    TripleBuffer<float> fSpectrum;
+    float               fNormalization{1.0f};
+    size_t              fWritePosition{0};
+    size_t              fSamplesSinceAnalysis{0};
+
+    /* in-place iterative radix-2 FFT on bit reversed input */
+    void transform() {
+        float* re = fReal.data();
+        float* im = fImag.data();
+        for (size_t length = 2; length <= fSize; length <<= 1) {
+            const size_t half   = length / 2;
+            const size_t stride = fSize / length;
+            for (size_t start = 0; start < fSize; start += length) {
+                for (size_t k = 0; k < half; ++k) {
+                    const float  wr = fCos[k * stride];
+                    const float  wi = fSin[k * stride];
+                    const size_t a  = start + k;
+                    const size_t b  = a + half;
+                    const float  tr = re[b] * wr - im[b] * wi;
+                    const float  ti = re[b] * wi + im[b] * wr;
+                    re[b]           = re[a] - tr;
+                    im[b]           = im[a] - ti;
+                    re[a] += tr;
+                    im[a] += ti;
+                }
+            }
+        }
+    }
+};
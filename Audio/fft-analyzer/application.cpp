@@ -0,0 +1,93 @@
+/*
+ * this example demonstrates how to analyze audio with `FFTAnalyzer`. unlike `fft_process()`
+ * the analyzer does not allocate memory on the audio thread. it analyzes overlapping frames
+ * ( here 2048 samples every 512 samples ) and publishes each spectrum through a lock-free
+ * triple buffer that `draw()` reads without tearing. press `1` to `4` to change the window.
+ */
+
+#include "Umfeld.h"
+#include "audio/AudioUtilities.h"
+#include "audio/Wavetable.h"
+
+#include "FFTAnalyzer.h"
+
+using namespace umfeld;
+
+static constexpr float MIN_FREQUENCY = 20.0f;
+static constexpr float MAX_FREQUENCY = 2000.0f;
+
+Wavetable*   wavetable_oscillator;
+FFTAnalyzer* analyzer;
+
+void settings() {
+    size(1024, 768);
+    audio();
+}
+
+void setup() {
+    analyzer = new FFTAnalyzer(2048, 512, get_audio_sample_rate(), FFTAnalyzer::HANN);
+
+    wavetable_oscillator = new Wavetable(1024, get_audio_sample_rate());
+    wavetable_oscillator->set_waveform(WAVEFORM_SAWTOOTH_HARMONICS, 8);
+    wavetable_oscillator->set_frequency(220.0f);
+    wavetable_oscillator->set_amplitude(0.5f);
+}
+
+void draw() {
+    background(0.85f);
+
+    wavetable_oscillator->set_frequency(map(mouseX, 0, width, 20.0f, 400.0f));
+    wavetable_oscillator->set_amplitude(map(mouseY, 0, height, 0.5f, 0.0f));
+
+    const float* spectrum  = analyzer->acquire_spectrum();
+    const float  bin_width = width * analyzer->get_bin_frequency(1) / (MAX_FREQUENCY - MIN_FREQUENCY);
+    noStroke();
+    fill(0.0f, 0.5f, 1.0f);
+    for (size_t i = 0; i < analyzer->get_number_of_bins(); ++i) {
+        const float frequency = analyzer->get_bin_frequency(i);
+        if (frequency < MIN_FREQUENCY || frequency > MAX_FREQUENCY) {
+            continue;
+        }
+        const float x = map(frequency, MIN_FREQUENCY, MAX_FREQUENCY, 0.0f, width);
+        const float h = map(spectrum[i], -90.0f, 0.0f, height, 0.0f);
+        rect(x - bin_width * 0.5f, h, bin_width, height - h);
+    }
+}
+
+void keyPressed() {
+    // NOTE `set_window()` is not thread-safe. this is fine as long as `run_audio_in_thread` is not set
+    FFTAnalyzer::Window window;
+    switch (key) {
+        case '1':
+            window = FFTAnalyzer::RECTANGULAR;
+            break;
+        case '2':
+            window = FFTAnalyzer::HANN;
+            break;
+        case '3':
+            window = FFTAnalyzer::HAMMING;
+            break;
+        case '4':
+            window = FFTAnalyzer::BLACKMAN;
+            break;
+        default:
+            return;
+    }
+    analyzer->set_window(window);
+}
+
+void audioEvent(const PAudio& audio) {
+    float sample_buffer[audio.buffer_size];
+    for (int i = 0; i < audio.buffer_size; i++) {
+        sample_buffer[i] = wavetable_oscillator->process();
+    }
+    analyzer->process(sample_buffer, audio.buffer_size);
+    if (audio.output_channels == 2) {
+        merge_interleaved_stereo(sample_buffer, sample_buffer, audio.output_buffer, audio.buffer_size);
+    }
+}
+
+void shutdown() {
+    delete wavetable_oscillator;
+    delete analyzer;
+}
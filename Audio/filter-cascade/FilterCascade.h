@@ -0,0 +1,316 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define FILTER_CASCADE_AVX
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define FILTER_CASCADE_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define FILTER_CASCADE_NEON
+#endif
+
+#include "SPSCQueue.h"
+#include "StateVariableFilter.h"
+
+/**
+ * cascade of up to `MAX_BANDS` state variable filters ( see `FilterCoefficients` for the
+ * available responses ) applied in series to every channel of an interleaved buffer, e.g. a
+ * multi-band EQ or a crossover. all channels share the same bands.
+ *
+ * channels are processed in SIMD lanes: `LANES` adjacent channels of a frame are loaded as
+ * one vector ( 8 lanes with AVX, 4 lanes with SSE2 or NEON, 4 scalar lanes otherwise, see
+ * `BACKEND` ), so
+ * 16 channels need 2 or 4 vector passes instead of 16 scalar ones. remaining channels are
+ * processed in a partially filled vector.
+ *
+ * `set_band()` may be called from another thread ( e.g. `draw()` ). new coefficients are
+ * passed to the audio thread through a lock-free queue and interpolated linearly across the
+ * next block, so that sweeping a band does not produce zipper noise. only one thread may call
+ * `set_band()`.
+ *
+ * NOTE buffers only allocate in the constructor.
+ */
+class FilterCascade {
+public:
+#if defined(FILTER_CASCADE_AVX)
+    static constexpr size_t      LANES   = 8;
+    static constexpr const char* BACKEND = "AVX";
+#elif defined(FILTER_CASCADE_SSE2)
+    static constexpr size_t      LANES   = 4;
+    static constexpr const char* BACKEND = "SSE2";
+#elif defined(FILTER_CASCADE_NEON)
+    static constexpr size_t      LANES   = 4;
+    static constexpr const char* BACKEND = "NEON";
+#else
+    static constexpr size_t      LANES   = 4;
+    static constexpr const char* BACKEND = "SCALAR LANES";
+#endif
+    static constexpr size_t MAX_BANDS = 16;
+
+    struct Band {
+        FilterCoefficients::Type type{FilterCoefficients::BYPASS};
+        float                    frequency{1000.0f};
+        float                    q{0.707f};
+        float                    gain_db{0.0f};
+    };
+
+    FilterCascade(const size_t channels, const size_t bands, const float sample_rate)
+        : fChannels(channels),
+          fBands(std::min(bands, MAX_BANDS)),
+          fGroups((channels + LANES - 1) / LANES),
+          fSampleRate(sample_rate),
+          fSettings(fBands),
+          fCurrent(fBands),
+          fTarget(fBands),
+          fIC1(fBands * fGroups * LANES, 0.0f),
+          fIC2(fBands * fGroups * LANES, 0.0f) {}
+
+    size_t get_channels() const { return fChannels; }
+
+    size_t get_number_of_bands() const { return fBands; }
+
+    /* control thread. settings of `band` as last set with `set_band()`, a bypass band if `band` does not exist */
+    const Band& get_band(const size_t band) const {
+        static const Band BYPASS{};
+        return band < fBands ? fSettings[band] : BYPASS;
+    }
+
+    /* control thread. returns false if the update queue is full */
+    bool set_band(const size_t band, const Band& settings) {
+        if (band >= fBands) {
+            return false;
+        }
+        fSettings[band] = settings;
+        const Update update{band, FilterCoefficients::create(settings.type, settings.frequency, settings.q, settings.gain_db, fSampleRate)};
+        return fUpdates.push(update);
+    }
+
+    /* audio thread. applies the next coefficients immediately, e.g. after initializing all bands */
+    void skip_interpolation() {
+        apply_updates();
+        fCurrent = fTarget;
+    }
+
+    /* audio thread. clears the filter state */
+    void reset() {
+        std::fill(fIC1.begin(), fIC1.end(), 0.0f);
+        std::fill(fIC2.begin(), fIC2.end(), 0.0f);
+    }
+
+    /* audio thread. filters `frames` interleaved frames of `channels` channels in place */
+    void process(float* buffer, const size_t frames) {
+        if (frames == 0) {
+            return;
+        }
+        apply_updates();
+
+        /* per sample increments of all coefficients to reach the target at the end of the block */
+        bool               interpolate = false;
+        FilterCoefficients delta[MAX_BANDS];
+        const float        scale = 1.0f / static_cast<float>(frames);
+        for (size_t b = 0; b < fBands; ++b) {
+            const FilterCoefficients& c = fCurrent[b];
+            const FilterCoefficients& t = fTarget[b];
+            delta[b]                    = {(t.a1 - c.a1) * scale, (t.a2 - c.a2) * scale, (t.a3 - c.a3) * scale,
+                                           (t.m0 - c.m0) * scale, (t.m1 - c.m1) * scale, (t.m2 - c.m2) * scale};
+            interpolate |= t.a1 != c.a1 || t.a2 != c.a2 || t.a3 != c.a3 || t.m0 != c.m0 || t.m1 != c.m1 || t.m2 != c.m2;
+        }
+
+        for (size_t g = 0; g < fGroups; ++g) {
+            if (interpolate) {
+                process_group<true>(buffer, frames, g, delta);
+            } else {
+                process_group<false>(buffer, frames, g, delta);
+            }
+        }
+        std::copy(fTarget.begin(), fTarget.end(), fCurrent.begin());
+    }
+
+private:
+    struct Update {
+        size_t             band{0};
+        FilterCoefficients coefficients;
+    };
+
+    const size_t                    fChannels;
+    const size_t                    fBands;
+    const size_t                    fGroups;
+    const float                     fSampleRate;
+    std::vector<Band>               fSettings; // control thread
+    std::vector<FilterCoefficients> fCurrent;  // audio thread
+    std::vector<FilterCoefficients> fTarget;   // audio thread
+    std::vector<float>              fIC1;      // state per band, group and lane
+    std::vector<float>              fIC2;
+    SPSCQueue<Update, 64>           fUpdates;
+
+#if defined(FILTER_CASCADE_AVX)
+    using lane_t = __m256;
+
+    static lane_t lane_load(const float* p) { return _mm256_loadu_ps(p); }
+    static void   lane_store(float* p, const lane_t v) { _mm256_storeu_ps(p, v); }
+    static lane_t lane_set(const float v) { return _mm256_set1_ps(v); }
+    static lane_t lane_add(const lane_t a, const lane_t b) { return _mm256_add_ps(a, b); }
+    static lane_t lane_sub(const lane_t a, const lane_t b) { return _mm256_sub_ps(a, b); }
+    static lane_t lane_mul(const lane_t a, const lane_t b) { return _mm256_mul_ps(a, b); }
+    /* the first `lanes` elements are set */
+    static __m256i lane_mask(const size_t lanes) {
+        static constexpr int32_t MASK[16] = {-1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0};
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(MASK + 8 - lanes));
+    }
+    static lane_t lane_load_partial(const float* p, const size_t lanes) { return _mm256_maskload_ps(p, lane_mask(lanes)); }
+    static void   lane_store_partial(float* p, const lane_t v, const size_t lanes) { _mm256_maskstore_ps(p, lane_mask(lanes), v); }
+#elif defined(FILTER_CASCADE_SSE2)
+    using lane_t = __m128;
+
+    static lane_t lane_load(const float* p) { return _mm_loadu_ps(p); }
+    static void   lane_store(float* p, const lane_t v) { _mm_storeu_ps(p, v); }
+    static lane_t lane_set(const float v) { return _mm_set1_ps(v); }
+    static lane_t lane_add(const lane_t a, const lane_t b) { return _mm_add_ps(a, b); }
+    static lane_t lane_sub(const lane_t a, const lane_t b) { return _mm_sub_ps(a, b); }
+    static lane_t lane_mul(const lane_t a, const lane_t b) { return _mm_mul_ps(a, b); }
+    static lane_t lane_load_partial(const float* p, const size_t lanes) {
+        switch (lanes) {
+            case 1:
+                return _mm_load_ss(p);
+            case 2:
+                return _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(p)));
+            default:
+                return _mm_movelh_ps(_mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(p))), _mm_load_ss(p + 2));
+        }
+    }
+    static void lane_store_partial(float* p, const lane_t v, const size_t lanes) {
+        switch (lanes) {
+            case 1:
+                _mm_store_ss(p, v);
+                break;
+            case 2:
+                _mm_store_sd(reinterpret_cast<double*>(p), _mm_castps_pd(v));
+                break;
+            default:
+                _mm_store_sd(reinterpret_cast<double*>(p), _mm_castps_pd(v));
+                _mm_store_ss(p + 2, _mm_movehl_ps(v, v));
+                break;
+        }
+    }
+#elif defined(FILTER_CASCADE_NEON)
+    using lane_t = float32x4_t;
+
+    static lane_t lane_load(const float* p) { return vld1q_f32(p); }
+    static void   lane_store(float* p, const lane_t v) { vst1q_f32(p, v); }
+    static lane_t lane_set(const float v) { return vdupq_n_f32(v); }
+    static lane_t lane_add(const lane_t a, const lane_t b) { return vaddq_f32(a, b); }
+    static lane_t lane_sub(const lane_t a, const lane_t b) { return vsubq_f32(a, b); }
+    static lane_t lane_mul(const lane_t a, const lane_t b) { return vmulq_f32(a, b); }
+    static lane_t lane_load_partial(const float* p, const size_t lanes) {
+        float partial[LANES] = {};
+        std::copy(p, p + lanes, partial);
+        return vld1q_f32(partial);
+    }
+    static void lane_store_partial(float* p, const lane_t v, const size_t lanes) {
+        float partial[LANES];
+        vst1q_f32(partial, v);
+        std::copy(partial, partial + lanes, p);
+    }
+#else
+    struct lane_t {
+        float v[LANES];
+    };
+
+    static lane_t lane_load(const float* p) {
+        lane_t r;
+        std::copy(p, p + LANES, r.v);
+        return r;
+    }
+    static void   lane_store(float* p, const lane_t& a) { std::copy(a.v, a.v + LANES, p); }
+    static lane_t lane_set(const float v) {
+        lane_t r;
+        std::fill(r.v, r.v + LANES, v);
+        return r;
+    }
+    static lane_t lane_add(const lane_t& a, const lane_t& b) {
+        lane_t r;
+        for (size_t i = 0; i < LANES; ++i) { r.v[i] = a.v[i] + b.v[i]; }
+        return r;
+    }
+    static lane_t lane_sub(const lane_t& a, const lane_t& b) {
+        lane_t r;
+        for (size_t i = 0; i < LANES; ++i) { r.v[i] = a.v[i] - b.v[i]; }
+        return r;
+    }
+    static lane_t lane_mul(const lane_t& a, const lane_t& b) {
+        lane_t r;
+        for (size_t i = 0; i < LANES; ++i) { r.v[i] = a.v[i] * b.v[i]; }
+        return r;
+    }
+    static lane_t lane_load_partial(const float* p, const size_t lanes) {
+        lane_t r{};
+        std::copy(p, p + lanes, r.v);
+        return r;
+    }
+    static void lane_store_partial(float* p, const lane_t& a, const size_t lanes) { std::copy(a.v, a.v + lanes, p); }
+#endif
+
+    void apply_updates() {
+        Update update;
+        while (fUpdates.pop(update)) {
+            fTarget[update.band] = update.coefficients;
+        }
+    }
+
+    template<bool INTERPOLATE>
+    void process_group(float* buffer, const size_t frames, const size_t group, const FilterCoefficients* delta) {
+        const size_t first_channel = group * LANES;
+        const size_t lanes         = std::min(LANES, fChannels - first_channel);
+
+        /* load filter state and coefficients into registers ( as far as the compiler can keep them there ) */
+        lane_t             ic1[MAX_BANDS];
+        lane_t             ic2[MAX_BANDS];
+        FilterCoefficients c[MAX_BANDS];
+        for (size_t b = 0; b < fBands; ++b) {
+            ic1[b] = lane_load(&fIC1[(b * fGroups + group) * LANES]);
+            ic2[b] = lane_load(&fIC2[(b * fGroups + group) * LANES]);
+            c[b]   = fCurrent[b];
+        }
+
+        for (size_t i = 0; i < frames; ++i) {
+            float* frame = buffer + i * fChannels + first_channel;
+            lane_t v0    = lanes == LANES ? lane_load(frame) : lane_load_partial(frame, lanes);
+
+            for (size_t b = 0; b < fBands; ++b) {
+                if (INTERPOLATE) {
+                    c[b].a1 += delta[b].a1;
+                    c[b].a2 += delta[b].a2;
+                    c[b].a3 += delta[b].a3;
+                    c[b].m0 += delta[b].m0;
+                    c[b].m1 += delta[b].m1;
+                    c[b].m2 += delta[b].m2;
+                }
+                const lane_t v3 = lane_sub(v0, ic2[b]);
+                const lane_t v1 = lane_add(lane_mul(lane_set(c[b].a1), ic1[b]), lane_mul(lane_set(c[b].a2), v3));
+                const lane_t v2 = lane_add(ic2[b], lane_add(lane_mul(lane_set(c[b].a2), ic1[b]), lane_mul(lane_set(c[b].a3), v3)));
+                ic1[b]          = lane_sub(lane_add(v1, v1), ic1[b]);
+                ic2[b]          = lane_sub(lane_add(v2, v2), ic2[b]);
+                v0              = lane_add(lane_mul(lane_set(c[b].m0), v0),
+                                           lane_add(lane_mul(lane_set(c[b].m1), v1), lane_mul(lane_set(c[b].m2), v2)));
+            }
+
+            if (lanes == LANES) {
+                lane_store(frame, v0);
+            } else {
+                lane_store_partial(frame, v0, lanes);
+            }
+        }
+
+        for (size_t b = 0; b < fBands; ++b) {
+            lane_store(&fIC1[(b * fGroups + group) * LANES], ic1[b]);
+            lane_store(&fIC2[(b * fGroups + group) * LANES], ic2[b]);
+        }
+    }
+};
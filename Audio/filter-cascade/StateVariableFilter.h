@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * coefficients of a trapezoidal state variable filter ( after Andrew Simper / Cytomic ). one
+ * structure covers all common biquad responses. unlike a direct form biquad the filter stays
+ * stable and does not click when its coefficients change while it is running, which makes it
+ * a good fit for modulation.
+ *
+ * the filter computes low-pass ( v2 ) and band-pass ( v1 ) outputs from the input ( v0 ) and
+ * mixes them: `output = m0 * v0 + m1 * v1 + m2 * v2`.
+ */
+struct FilterCoefficients {
+    enum Type {
+        BYPASS,
+        LOW_PASS,
+        HIGH_PASS,
+        BAND_PASS,
+        NOTCH,
+        PEAK,
+        LOW_SHELF,
+        HIGH_SHELF,
+        ALL_PASS
+    };
+
+    float a1{0.0f};
+    float a2{0.0f};
+    float a3{0.0f};
+    float m0{1.0f};
+    float m1{0.0f};
+    float m2{0.0f};
+
+    /* `gain_db` is only used by `PEAK`, `LOW_SHELF` and `HIGH_SHELF` */
+    static FilterCoefficients create(const Type type, const float frequency, const float q, const float gain_db, const float sample_rate) {
+        const float f = std::clamp(frequency, 10.0f, sample_rate * 0.49f);
+        const float A = std::pow(10.0f, gain_db / 40.0f);
+        float       g = std::tan(static_cast<float>(M_PI) * f / sample_rate);
+        float       k = 1.0f / std::max(q, 0.01f);
+
+        FilterCoefficients c;
+        switch (type) {
+            case BYPASS:
+                return c;
+            case LOW_PASS:
+                c.m0 = 0.0f;
+                c.m1 = 0.0f;
+                c.m2 = 1.0f;
+                break;
+            case HIGH_PASS:
+                c.m0 = 1.0f;
+                c.m1 = -k;
+                c.m2 = -1.0f;
+                break;
+            case BAND_PASS:
+                c.m0 = 0.0f;
+                c.m1 = k; // unity gain at the center frequency
+                c.m2 = 0.0f;
+                break;
+            case NOTCH:
+                c.m0 = 1.0f;
+                c.m1 = -k;
+                c.m2 = 0.0f;
+                break;
+            case PEAK:
+                k    = 1.0f / (std::max(q, 0.01f) * A);
+                c.m0 = 1.0f;
+                c.m1 = k * (A * A - 1.0f);
+                c.m2 = 0.0f;
+                break;
+            case LOW_SHELF:
+                g /= std::sqrt(A);
+                c.m0 = 1.0f;
+                c.m1 = k * (A - 1.0f);
+                c.m2 = A * A - 1.0f;
+                break;
+            case HIGH_SHELF:
+                g *= std::sqrt(A);
+                c.m0 = A * A;
+                c.m1 = k * (1.0f - A) * A;
+                c.m2 = 1.0f - A * A;
+                break;
+            case ALL_PASS:
+                c.m0 = 1.0f;
+                c.m1 = -2.0f * k;
+                c.m2 = 0.0f;
+                break;
+        }
+        c.a1 = 1.0f / (1.0f + g * (g + k));
+        c.a2 = g * c.a1;
+        c.a3 = g * c.a2;
+        return c;
+    }
+};
+
+/**
+ * single channel state variable filter processed per sample. reference implementation for
+ * `FilterCascade` and a drop-in for single filters.
+ */
+class StateVariableFilter {
+public:
+    void set(const FilterCoefficients& coefficients) { fCoefficients = coefficients; }
+
+    void reset() {
+        fIC1 = 0.0f;
+        fIC2 = 0.0f;
+    }
+
+    float process(const float v0) {
+        const FilterCoefficients& c  = fCoefficients;
+        const float               v3 = v0 - fIC2;
+        const float               v1 = c.a1 * fIC1 + c.a2 * v3;
+        const float               v2 = fIC2 + c.a2 * fIC1 + c.a3 * v3;
+        fIC1                         = 2.0f * v1 - fIC1;
+        fIC2                         = 2.0f * v2 - fIC2;
+        return c.m0 * v0 + c.m1 * v1 + c.m2 * v2;
+    }
+
+private:
+    FilterCoefficients fCoefficients;
+    float              fIC1{0.0f};
+    float              fIC2{0.0f};
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "TripleBuffer.h"
+
+/**
+ * RMS and peak follower for interleaved multichannel audio. each call to `process()` measures
+ * the block and updates the followers once per block instead of once per sample: the mean
+ * square is smoothed with a time constant of `rms_time` seconds and the peak falls with a
+ * time constant of `release_time` seconds. the inner loop runs over the channels of a frame,
+ * so the compiler can vectorize it for any number of channels.
+ *
+ * levels are published per block to a triple buffer that another thread ( e.g. `draw()` )
+ * reads with `acquire_levels()` without locks.
+ */
+class LevelFollower {
+public:
+    struct Level {
+        float rms{0.0f};
+        float peak{0.0f};
+    };
+
+    LevelFollower(const size_t channels, const float sample_rate, const float rms_time = 0.3f, const float release_time = 1.5f)
+        : fChannels(std::max<size_t>(channels, 1)),
+          fSampleRate(sample_rate),
+          fRMSTime(rms_time),
+          fReleaseTime(release_time),
+          fSum(fChannels),
+          fPeak(fChannels),
+          fMeanSquare(fChannels, 0.0f),
+          fPeakState(fChannels, 0.0f),
+          fLevels(fChannels) {}
+
+    size_t get_channels() const { return fChannels; }
+
+    /* audio thread. measures `frames` interleaved frames with `get_channels()` channels */
+    void process(const float* interleaved, const size_t frames) {
+        if (frames == 0) {
+            return;
+        }
+        float* sum  = fSum.data();
+        float* peak = fPeak.data();
+        std::fill(fSum.begin(), fSum.end(), 0.0f);
+        std::fill(fPeak.begin(), fPeak.end(), 0.0f);
+        for (size_t i = 0; i < frames; ++i) {
+            const float* frame = interleaved + i * fChannels;
+            for (size_t c = 0; c < fChannels; ++c) {
+                sum[c] += frame[c] * frame[c];
+                peak[c] = std::max(peak[c], std::abs(frame[c]));
+            }
+        }
+
+        const float duration   = static_cast<float>(frames) / fSampleRate;
+        const float rms_decay  = std::exp(-duration / fRMSTime);
+        const float peak_decay = std::exp(-duration / fReleaseTime);
+        const float inv_frames = 1.0f / static_cast<float>(frames);
+        Level*      levels     = fLevels.write_buffer();
+        for (size_t c = 0; c < fChannels; ++c) {
+            fMeanSquare[c] = sum[c] * inv_frames + (fMeanSquare[c] - sum[c] * inv_frames) * rms_decay;
+            fPeakState[c]  = std::max(peak[c], fPeakState[c] * peak_decay);
+            levels[c].rms  = std::sqrt(fMeanSquare[c]);
+            levels[c].peak = fPeakState[c];
+        }
+        fLevels.publish();
+    }
+
+    /* render thread. returns the latest published levels ( one per channel ). the pointer stays valid until the next call */
+    const Level* acquire_levels() {
+        fLevels.acquire();
+        return fLevels.read_buffer();
+    }
+
+    static float to_db(const float level, const float min_db = -90.0f) { return level > 0.0f ? std::max(20.0f * std::log10(level), min_db) : min_db; }
+
+private:
+    const size_t        fChannels;
+    const float         fSampleRate;
+    const float         fRMSTime;
+    const float         fReleaseTime;
+    std::vector<float>  fSum;
+    std::vector<float>  fPeak;
+    std::vector<float>  fMeanSquare;
+    std::vector<float>  fPeakState;
+    TripleBuffer<Level> fLevels;
+};
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "RealFFT.h"
+#include "TripleBuffer.h"
+
+/**
+ * monophonic pitch tracker based on YIN ( de Cheveigné and Kawahara, 2002 ). every
+ * `hop_size` samples the last `window_size` samples are analyzed: the difference function
+ * is computed for all lags up to `window_size / 2`, normalized by its cumulative mean and
+ * the first dip below `threshold` is refined with parabolic interpolation.
+ *
+ * the difference function `d(t) = sum( ( x[j] - x[j + t] )² )` is expanded into two energy
+ * terms, which are computed with a running sum, and the cross correlation of the first half
+ * of the window with the whole window, which is computed with FFTs. this takes O(N log N)
+ * instead of the O(N²) of the direct form.
+ *
+ * the result is published to a triple buffer ( `acquire_pitch()` ). `frequency` is 0 if the
+ * frame is unvoiced or quieter than `silence_db`. all memory is allocated in the constructor.
+ *
+ * NOTE `window_size` must be a power of two. the lowest detectable frequency is
+ * `sample_rate / ( window_size / 2 )`, e.g. ~47Hz for a window of 2048 samples at 48kHz.
+ */
+class PitchTracker {
+public:
+    struct Pitch {
+        float frequency{0.0f};
+        float confidence{0.0f}; // 1 - normalized difference at the detected lag
+    };
+
+    PitchTracker(const size_t window_size, const size_t hop_size, const float sample_rate, const float threshold = 0.15f, const float silence_db = -60.0f)
+        : fSize(window_size),
+          fHalf(window_size / 2),
+          fHopSize(std::clamp<size_t>(hop_size, 1, window_size)),
+          fSampleRate(sample_rate),
+          fThreshold(threshold),
+          fSilence(std::pow(10.0f, silence_db / 20.0f)),
+          fFFT(window_size * 2),
+          fHistory(window_size, 0.0f),
+          fPadded(window_size * 2, 0.0f),
+          fCorrelation(window_size * 2),
+          fWindowReal(window_size + 1),
+          fWindowImag(window_size + 1),
+          fHeadReal(window_size + 1),
+          fHeadImag(window_size + 1),
+          fDifference(window_size / 2),
+          fPitch(1) {
+        fPosition = fSize - fHopSize;
+    }
+
+    size_t get_window_size() const { return fSize; }
+
+    size_t get_hop_size() const { return fHopSize; }
+
+    float get_min_frequency() const { return fSampleRate / static_cast<float>(fHalf); }
+
+    /* audio thread. collects `frames` mono samples and analyzes every `hop_size` samples. returns the number of analyzed frames */
+    size_t process(const float* input, const size_t frames) {
+        size_t analyzed = 0;
+        size_t consumed = 0;
+        while (consumed < frames) {
+            const size_t n = std::min(frames - consumed, fSize - fPosition);
+            std::copy_n(input + consumed, n, fHistory.data() + fPosition);
+            fPosition += n;
+            consumed += n;
+            if (fPosition == fSize) {
+                Pitch& pitch = *fPitch.write_buffer();
+                pitch        = analyze(fHistory.data());
+                fPitch.publish();
+                std::copy(fHistory.begin() + fHopSize, fHistory.end(), fHistory.begin());
+                fPosition = fSize - fHopSize;
+                ++analyzed;
+            }
+        }
+        return analyzed;
+    }
+
+    /* analyzes `window_size` samples of `input`. NOTE uses the internal work buffers, i.e do not call this concurrently with `process()` */
+    Pitch analyze(const float* input) {
+        /* energy of the first half, which is also the energy term of lag 0 */
+        float energy = 0.0f;
+        for (size_t j = 0; j < fHalf; ++j) {
+            energy += input[j] * input[j];
+        }
+        if (std::sqrt(energy / static_cast<float>(fHalf)) < fSilence) {
+            return {};
+        }
+
+        /* cross correlation r(t) = sum( x[j] * x[j + t] ) for j < N / 2 */
+        std::copy_n(input, fSize, fPadded.data());
+        std::fill(fPadded.begin() + fSize, fPadded.end(), 0.0f);
+        fFFT.forward(fPadded.data(), fWindowReal.data(), fWindowImag.data());
+        std::fill(fPadded.begin() + fHalf, fPadded.end(), 0.0f);
+        fFFT.forward(fPadded.data(), fHeadReal.data(), fHeadImag.data());
+        for (size_t k = 0; k < fWindowReal.size(); ++k) {
+            /* conj(head) * window */
+            const float re = fHeadReal[k] * fWindowReal[k] + fHeadImag[k] * fWindowImag[k];
+            const float im = fHeadReal[k] * fWindowImag[k] - fHeadImag[k] * fWindowReal[k];
+            fWindowReal[k] = re;
+            fWindowImag[k] = im;
+        }
+        fFFT.inverse(fWindowReal.data(), fWindowImag.data(), fCorrelation.data());
+        const float normalization = 1.0f / static_cast<float>(fSize);
+
+        /* cumulative mean normalized difference d'(t) = d(t) * t / sum( d(1) … d(t) ) */
+        float shifted_energy = energy;
+        float sum            = 0.0f;
+        fDifference[0]       = 1.0f;
+        for (size_t t = 1; t < fHalf; ++t) {
+            shifted_energy += input[t + fHalf - 1] * input[t + fHalf - 1] - input[t - 1] * input[t - 1];
+            const float difference = std::max(energy + shifted_energy - 2.0f * fCorrelation[t] * normalization, 0.0f);
+            sum += difference;
+            fDifference[t] = sum > 0.0f ? difference * static_cast<float>(t) / sum : 1.0f;
+        }
+
+        /* first dip below the threshold, followed down to its minimum */
+        size_t lag = 0;
+        for (size_t t = 2; t < fHalf - 1; ++t) {
+            if (fDifference[t] < fThreshold) {
+                while (t + 1 < fHalf - 1 && fDifference[t + 1] < fDifference[t]) {
+                    ++t;
+                }
+                lag = t;
+                break;
+            }
+        }
+        if (lag == 0) {
+            return {};
+        }
+
+        /* parabolic interpolation around the minimum */
+        const float a     = fDifference[lag - 1];
+        const float b     = fDifference[lag];
+        const float c     = fDifference[lag + 1];
+        const float denom = a - 2.0f * b + c;
+        const float shift = denom > 0.0f ? 0.5f * (a - c) / denom : 0.0f;
+        return {fSampleRate / (static_cast<float>(lag) + shift), std::clamp(1.0f - b, 0.0f, 1.0f)};
+    }
+
+    /* render thread. returns the pitch of the latest analyzed frame. the pointer stays valid until the next call */
+    const Pitch* acquire_pitch() {
+        fPitch.acquire();
+        return fPitch.read_buffer();
+    }
+
+    /* e.g. 440Hz → 69. returns -1 for 0Hz */
+    static float frequency_to_note(const float frequency) { return frequency > 0.0f ? 12.0f * std::log2(frequency / 440.0f) + 69.0f : -1.0f; }
+
+private:
+    const size_t        fSize;
+    const size_t        fHalf;
+    const size_t        fHopSize;
+    const float         fSampleRate;
+    const float         fThreshold;
+    const float         fSilence;
+    RealFFT             fFFT;
+    std::vector<float>  fHistory;
+    std::vector<float>  fPadded;
+    std::vector<float>  fCorrelation;
+    std::vector<float>  fWindowReal;
+    std::vector<float>  fWindowImag;
+    std::vector<float>  fHeadReal;
+    std::vector<float>  fHeadImag;
+    std::vector<float>  fDifference;
+    TripleBuffer<Pitch> fPitch;
+    size_t              fPosition{0};
+};
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "RealFFT.h"
+#include "SPSCQueue.h"
+#include "TripleBuffer.h"
+
+/**
+ * detects onsets and computes a chromagram from one FFT per hop. all memory is allocated in
+ * the constructor, `process()` never allocates.
+ *
+ * onsets are detected with spectral flux: the sum of the increases of the log compressed
+ * magnitudes from one frame to the next. a frame is an onset if its flux is a local maximum,
+ * exceeds the mean of the recent flux by `sensitivity` and at least `min_interval` seconds
+ * have passed since the last onset. because of the local maximum test onsets are reported
+ * one hop late. the chromagram sums the energy of all bins between 50Hz and 5kHz into the 12
+ * pitch classes ( C, C#, … B ) and normalizes the maximum to 1.
+ *
+ * the features of every frame are published to a triple buffer ( `acquire_features()` ).
+ * onsets are passed through a lock-free queue ( `pop_onset()` ) so that none get lost
+ * between two frames of the render thread.
+ *
+ * NOTE `fft_size` must be a power of two.
+ */
+class SpectralAnalyzer {
+public:
+    static constexpr size_t PITCH_CLASSES = 12;
+
+    struct Features {
+        float    flux{0.0f};
+        float    threshold{0.0f};
+        float    chroma[PITCH_CLASSES]{};
+        uint64_t frame{0};
+    };
+
+    struct Onset {
+        uint64_t frame{0}; // end of the frame that contains the onset, in samples since the analyzer was created
+        float    strength{0.0f};
+    };
+
+    SpectralAnalyzer(const size_t fft_size, const size_t hop_size, const float sample_rate, const float sensitivity = 1.5f, const float min_interval = 0.05f)
+        : fSize(fft_size),
+          fHopSize(std::clamp<size_t>(hop_size, 1, fft_size)),
+          fSampleRate(sample_rate),
+          fSensitivity(sensitivity),
+          fMinInterval(static_cast<uint64_t>(min_interval * sample_rate)),
+          fFFT(fft_size),
+          fWindow(fft_size),
+          fHistory(fft_size, 0.0f),
+          fFrame(fft_size),
+          fReal(fft_size / 2 + 1),
+          fImag(fft_size / 2 + 1),
+          fMagnitude(fft_size / 2 + 1, 0.0f),
+          fPitchClass(fft_size / 2 + 1, -1),
+          fFluxHistory(FLUX_HISTORY, 0.0f),
+          fFeatures(1) {
+        for (size_t i = 0; i < fSize; ++i) {
+            fWindow[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * M_PI * static_cast<double>(i) / static_cast<double>(fSize)));
+        }
+        for (size_t i = 1; i < fPitchClass.size(); ++i) {
+            const float frequency = static_cast<float>(i) * fSampleRate / static_cast<float>(fSize);
+            if (frequency >= 50.0f && frequency <= 5000.0f) {
+                /* MIDI note 0 is a C */
+                const int note = static_cast<int>(std::lround(12.0f * std::log2(frequency / 440.0f) + 69.0f));
+                fPitchClass[i] = note % static_cast<int>(PITCH_CLASSES);
+            }
+        }
+        fPosition = fSize - fHopSize;
+    }
+
+    size_t get_fft_size() const { return fSize; }
+
+    size_t get_hop_size() const { return fHopSize; }
+
+    /* audio thread. collects `frames` mono samples and analyzes every `hop_size` samples. returns the number of analyzed frames */
+    size_t process(const float* input, const size_t frames) {
+        size_t analyzed = 0;
+        size_t consumed = 0;
+        while (consumed < frames) {
+            const size_t n = std::min(frames - consumed, fSize - fPosition);
+            std::copy_n(input + consumed, n, fHistory.data() + fPosition);
+            fPosition += n;
+            consumed += n;
+            fFramePosition += n;
+            if (fPosition == fSize) {
+                analyze();
+                std::copy(fHistory.begin() + fHopSize, fHistory.end(), fHistory.begin());
+                fPosition = fSize - fHopSize;
+                ++analyzed;
+            }
+        }
+        return analyzed;
+    }
+
+    /* render thread. returns the features of the latest analyzed frame. the pointer stays valid until the next call */
+    const Features* acquire_features() {
+        fFeatures.acquire();
+        return fFeatures.read_buffer();
+    }
+
+    /* render thread. returns true and the oldest onset if there is one */
+    bool pop_onset(Onset& onset) { return fOnsets.pop(onset); }
+
+    uint32_t get_dropped_onsets() const { return fDroppedOnsets.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t FLUX_HISTORY = 16;
+
+    const size_t           fSize;
+    const size_t           fHopSize;
+    const float            fSampleRate;
+    const float            fSensitivity;
+    const uint64_t         fMinInterval;
+    RealFFT                fFFT;
+    std::vector<float>     fWindow;
+    std::vector<float>     fHistory;
+    std::vector<float>     fFrame;
+    std::vector<float>     fReal;
+    std::vector<float>     fImag;
+    std::vector<float>     fMagnitude;
+    std::vector<int>       fPitchClass;
+    std::vector<float>     fFluxHistory;
+    TripleBuffer<Features> fFeatures;
+    SPSCQueue<Onset, 64>   fOnsets;
+    std::atomic<uint32_t>  fDroppedOnsets{0};
+    size_t                 fPosition{0};
+    size_t                 fFluxIndex{0};
+    uint64_t               fFramePosition{0};
+    uint64_t               fLastOnset{0};
+    float                  fPreviousFlux{0.0f};
+    float                  fPreviousThreshold{0.0f};
+    bool                   fRising{false};
+
+    void analyze() {
+        for (size_t i = 0; i < fSize; ++i) {
+            fFrame[i] = fHistory[i] * fWindow[i];
+        }
+        fFFT.forward(fFrame.data(), fReal.data(), fImag.data());
+
+        Features&    features = *fFeatures.write_buffer();
+        const size_t bins     = fMagnitude.size();
+        const float  scale    = 2.0f / static_cast<float>(fSize);
+        float        flux     = 0.0f;
+        std::fill(std::begin(features.chroma), std::end(features.chroma), 0.0f);
+        for (size_t i = 0; i < bins; ++i) {
+            const float energy    = (fReal[i] * fReal[i] + fImag[i] * fImag[i]) * scale * scale;
+            const float magnitude = std::log1p(1000.0f * std::sqrt(energy));
+            flux += std::max(magnitude - fMagnitude[i], 0.0f);
+            fMagnitude[i] = magnitude;
+            if (fPitchClass[i] >= 0) {
+                features.chroma[fPitchClass[i]] += energy;
+            }
+        }
+        flux /= static_cast<float>(bins);
+
+        const float chroma_max = *std::max_element(std::begin(features.chroma), std::end(features.chroma));
+        if (chroma_max > 0.0f) {
+            for (float& c: features.chroma) {
+                c /= chroma_max;
+            }
+        }
+
+        float mean = 0.0f;
+        for (const float f: fFluxHistory) {
+            mean += f;
+        }
+        mean /= static_cast<float>(FLUX_HISTORY);
+        const float threshold    = mean * fSensitivity + 0.01f;
+        fFluxHistory[fFluxIndex] = flux;
+        fFluxIndex               = (fFluxIndex + 1) % FLUX_HISTORY;
+
+        /* the previous frame is an onset if it was a local maximum above its threshold */
+        const uint64_t previous_frame = fFramePosition - fHopSize;
+        if (fRising && flux <= fPreviousFlux && fPreviousFlux > fPreviousThreshold && previous_frame - fLastOnset >= fMinInterval) {
+            fLastOnset = previous_frame;
+            if (!fOnsets.push({previous_frame, fPreviousFlux})) {
+                fDroppedOnsets.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        fRising            = flux > fPreviousFlux;
+        fPreviousFlux      = flux;
+        fPreviousThreshold = threshold;
+
+        features.flux      = flux;
+        features.threshold = threshold;
+        features.frame     = fFramePosition;
+        fFeatures.publish();
+    }
+};
@@ -0,0 +1,206 @@
+/*
+ * this example demonstrates how to analyze live audio input on the audio thread. the
+ * analyzers work on whole blocks, never allocate and publish their results lock-free:
+ *
+ * - `LevelFollower` measures RMS and peak of every input channel
+ * - `SpectralAnalyzer` detects onsets with spectral flux and computes a chromagram
+ * - `PitchTracker` tracks the pitch of monophonic input with YIN
+ *
+ * `draw()` shows level meters, the onset detection function, the chromagram and the pitch.
+ * the circle flashes on every onset. press `b` to measure the cost of the analyzers.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "Umfeld.h"
+
+#include "LevelFollower.h"
+#include "PitchTracker.h"
+#include "SpectralAnalyzer.h"
+
+using namespace umfeld;
+
+static constexpr size_t FLUX_HISTORY = 256;
+static constexpr char   NOTE_NAMES[SpectralAnalyzer::PITCH_CLASSES][3] =
+    {"C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"};
+
+LevelFollower*           levels;
+SpectralAnalyzer*        spectral;
+PitchTracker*            pitch;
+std::vector<float>       flux_history(FLUX_HISTORY, 0.0f);
+std::vector<float>       threshold_history(FLUX_HISTORY, 0.0f);
+uint64_t                 last_feature_frame = 0;
+float                    onset_flash        = 0.0f;
+uint32_t                 onset_count        = 0;
+std::vector<std::string> benchmark_results;
+
+void settings() {
+    size(1024, 768);
+    audio(2, 2);
+}
+
+void setup() {
+    if (get_audio_input_channels() == 0) {
+        error("this example requires an audio input");
+        exit(1);
+    }
+    levels   = new LevelFollower(get_audio_input_channels(), get_audio_sample_rate());
+    spectral = new SpectralAnalyzer(1024, 256, get_audio_sample_rate());
+    pitch    = new PitchTracker(2048, 512, get_audio_sample_rate());
+}
+
+void run_benchmark() {
+    static constexpr size_t CHANNELS[] = {1, 2, 8, 32};
+    static constexpr size_t FRAMES     = 512;
+    static constexpr float  SECONDS    = 10.0f;
+
+    const float  sample_rate = get_audio_sample_rate();
+    const size_t blocks      = static_cast<size_t>(SECONDS * sample_rate / FRAMES);
+
+    auto measure = [&](auto&& process) {
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (size_t block = 0; block < blocks; ++block) {
+            process(block);
+        }
+        const auto end = std::chrono::high_resolution_clock::now();
+        /* CPU time in percent of real time */
+        return std::chrono::duration<float>(end - start).count() / SECONDS * 100.0f;
+    };
+
+    benchmark_results.clear();
+    char result[128];
+    for (const size_t channels: CHANNELS) {
+        std::vector<float> buffer(FRAMES * channels);
+        for (size_t i = 0; i < buffer.size(); ++i) {
+            buffer[i] = std::sin(static_cast<float>(i) * 0.01f) * 0.5f;
+        }
+        LevelFollower follower(channels, sample_rate);
+        const float   load = measure([&](size_t) { follower.process(buffer.data(), FRAMES); });
+        snprintf(result, sizeof(result), "LEVELS   %2zu CH             : %6.3f%% CPU", channels, load);
+        benchmark_results.emplace_back(result);
+    }
+
+    std::vector<float> signal(FRAMES * 64);
+    for (size_t i = 0; i < signal.size(); ++i) {
+        signal[i] = std::sin(static_cast<float>(i) * 0.05f) * 0.5f + std::sin(static_cast<float>(i) * 0.0173f) * 0.25f;
+    }
+    SpectralAnalyzer spectral_analyzer(1024, 256, sample_rate);
+    PitchTracker     pitch_tracker(2048, 512, sample_rate);
+    const float      spectral_load = measure([&](const size_t block) { spectral_analyzer.process(signal.data() + (block % 64) * FRAMES, FRAMES); });
+    const float      pitch_load    = measure([&](const size_t block) { pitch_tracker.process(signal.data() + (block % 64) * FRAMES, FRAMES); });
+    snprintf(result, sizeof(result), "SPECTRAL 1024 / HOP 256    : %6.3f%% CPU", spectral_load);
+    benchmark_results.emplace_back(result);
+    snprintf(result, sizeof(result), "PITCH    2048 / HOP 512    : %6.3f%% CPU", pitch_load);
+    benchmark_results.emplace_back(result);
+
+    for (const auto& r: benchmark_results) {
+        console(r);
+    }
+}
+
+void draw() {
+    background(0.85f);
+
+    /* level meters. peak as a line, RMS as a bar */
+    const LevelFollower::Level* level = levels->acquire_levels();
+    const float                 meter = 20.0f;
+    for (size_t c = 0; c < levels->get_channels(); ++c) {
+        const float y    = 40.0f + c * (meter + 4.0f);
+        const float rms  = map(LevelFollower::to_db(level[c].rms), -60.0f, 0.0f, 0.0f, width - 20.0f);
+        const float peak = map(LevelFollower::to_db(level[c].peak), -60.0f, 0.0f, 0.0f, width - 20.0f);
+        noStroke();
+        fill(0.0f, 0.5f, 1.0f);
+        rect(10, y, std::max(rms, 0.0f), meter);
+        stroke(0.0f);
+        line(10 + peak, y, 10 + peak, y + meter);
+    }
+
+    /* onset detection function ( blue ) and threshold ( gray ) */
+    const SpectralAnalyzer::Features* features = spectral->acquire_features();
+    if (features->frame != last_feature_frame) {
+        last_feature_frame = features->frame;
+        std::rotate(flux_history.begin(), flux_history.begin() + 1, flux_history.end());
+        std::rotate(threshold_history.begin(), threshold_history.begin() + 1, threshold_history.end());
+        flux_history.back()      = features->flux;
+        threshold_history.back() = features->threshold;
+    }
+    const float graph_y      = height * 0.5f;
+    const float graph_height = 150.0f;
+    const float step         = static_cast<float>(width) / FLUX_HISTORY;
+    for (size_t i = 1; i < FLUX_HISTORY; ++i) {
+        stroke(0.5f);
+        line((i - 1) * step, graph_y - threshold_history[i - 1] * graph_height * 4.0f, i * step, graph_y - threshold_history[i] * graph_height * 4.0f);
+        stroke(0.0f, 0.5f, 1.0f);
+        line((i - 1) * step, graph_y - flux_history[i - 1] * graph_height * 4.0f, i * step, graph_y - flux_history[i] * graph_height * 4.0f);
+    }
+
+    SpectralAnalyzer::Onset onset;
+    while (spectral->pop_onset(onset)) {
+        onset_flash = 1.0f;
+        ++onset_count;
+    }
+    noStroke();
+    fill(1.0f, 0.25f, 0.35f, onset_flash);
+    circle(width - 80.0f, graph_y - 80.0f, 100);
+    onset_flash *= 0.85f;
+
+    /* chromagram */
+    const float bar_width = (width - 20.0f) / SpectralAnalyzer::PITCH_CLASSES;
+    for (size_t i = 0; i < SpectralAnalyzer::PITCH_CLASSES; ++i) {
+        const float h = features->chroma[i] * 150.0f;
+        fill(0.0f, 0.5f, 1.0f);
+        rect(10 + i * bar_width, height - 40.0f - h, bar_width - 4.0f, h);
+        fill(0);
+        debug_text(NOTE_NAMES[i], 10 + i * bar_width, height - 30.0f);
+    }
+
+    /* pitch */
+    const PitchTracker::Pitch* p = pitch->acquire_pitch();
+    fill(0);
+    char info[128];
+    if (p->frequency > 0.0f) {
+        const float note = PitchTracker::frequency_to_note(p->frequency);
+        const int   n    = static_cast<int>(std::lround(note));
+        snprintf(info, sizeof(info), "PITCH: %.1fHz ( %s%d %+.0f cents ) CONFIDENCE %.2f", p->frequency, NOTE_NAMES[n % 12], n / 12 - 1, (note - n) * 100.0f, p->confidence);
+    } else {
+        snprintf(info, sizeof(info), "PITCH: --");
+    }
+    debug_text(info, 10, 10);
+    debug_text("ONSETS: " + to_string(onset_count) + " ( DROPPED " + to_string(spectral->get_dropped_onsets()) + " )", 10, 25);
+    for (size_t i = 0; i < benchmark_results.size(); ++i) {
+        debug_text(benchmark_results[i], width * 0.5f, 10 + i * 15);
+    }
+}
+
+void keyPressed() {
+    if (key == 'b') {
+        run_benchmark();
+    }
+}
+
+void audioEvent(const PAudio& audio) {
+    levels->process(audio.input_buffer, audio.buffer_size);
+
+    /* pitch and onsets are detected on the sum of all input channels */
+    float mono_buffer[audio.buffer_size];
+    for (int i = 0; i < audio.buffer_size; i++) {
+        float sample = 0.0f;
+        for (int j = 0; j < audio.input_channels; j++) {
+            sample += audio.input_buffer[i * audio.input_channels + j];
+        }
+        mono_buffer[i] = sample / audio.input_channels;
+    }
+    spectral->process(mono_buffer, audio.buffer_size);
+    pitch->process(mono_buffer, audio.buffer_size);
+
+    /* NOTE the input is not passed to the output to avoid feedback */
+    std::fill_n(audio.output_buffer, audio.buffer_size * audio.output_channels, 0.0f);
+}
+
+void shutdown() {
+    delete levels;
+    delete spectral;
+    delete pitch;
+}
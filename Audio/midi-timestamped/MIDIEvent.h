@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * fixed-size MIDI channel message with the time it was received. unlike a
+ * `std::vector<unsigned char>` it can be copied through lock-free queues and into the audio
+ * thread without allocating.
+ */
+struct MIDIEvent {
+    enum Type : uint8_t {
+        NOTE_OFF         = 0x80,
+        NOTE_ON          = 0x90,
+        POLY_PRESSURE    = 0xA0,
+        CONTROL_CHANGE   = 0xB0,
+        PROGRAM_CHANGE   = 0xC0,
+        CHANNEL_PRESSURE = 0xD0,
+        PITCH_BEND       = 0xE0
+    };
+
+    int64_t time_ns{0}; // steady clock time of arrival
+    uint8_t status{0};
+    uint8_t data1{0};
+    uint8_t data2{0};
+    uint8_t size{0};
+
+    Type type() const { return static_cast<Type>(status & 0xF0); }
+    int  channel() const { return status & 0x0F; }
+    int  note() const { return data1; }
+    int  velocity() const { return data2; }
+    int  control() const { return data1; }
+    int  value() const { return data2; }
+    int  program() const { return data1; }
+
+    /* -8192 to 8191, 0 is the center */
+    int pitch_bend() const { return (data2 << 7 | data1) - 8192; }
+
+    /* a note on with velocity 0 is a note off */
+    bool is_note_on() const { return type() == NOTE_ON && data2 > 0; }
+    bool is_note_off() const { return type() == NOTE_OFF || (type() == NOTE_ON && data2 == 0); }
+
+    /* parses a channel message. returns false for other messages ( system exclusive, clock etc. ) */
+    static bool parse(const unsigned char* data, const size_t size, MIDIEvent& event) {
+        if (size == 0 || data[0] < 0x80 || data[0] >= 0xF0) {
+            return false;
+        }
+        const uint8_t type     = data[0] & 0xF0;
+        const size_t  expected = type == PROGRAM_CHANGE || type == CHANNEL_PRESSURE ? 2 : 3;
+        if (size < expected) {
+            return false;
+        }
+        event.status = data[0];
+        event.data1  = data[1] & 0x7F;
+        event.data2  = expected == 3 ? data[2] & 0x7F : 0;
+        event.size   = static_cast<uint8_t>(expected);
+        return true;
+    }
+};
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "RtMidi.h"
+
+#include "EventScheduler.h"
+#include "MIDIEvent.h"
+
+/**
+ * receives MIDI channel messages from one port and posts them as timestamped `MIDIEvent`s to
+ * an `EventScheduler`, which places them at sample accurate offsets in the audio blocks.
+ *
+ * the messages are converted in the callback of the MIDI backend thread and stamped with the
+ * time of arrival. no `std::vector` is copied and nothing is allocated per message. system
+ * exclusive, timing and active sensing messages are ignored. the input can also open a
+ * virtual port, e.g. to test with a loopback ( see `MIDILatencyTest` ).
+ *
+ * NOTE each input needs its own producer because each port is served by its own thread.
+ * NOTE virtual ports are not supported on windows.
+ */
+class MIDIInput {
+public:
+    using Producer = EventScheduler<MIDIEvent>::Producer;
+
+    explicit MIDIInput(Producer& producer) : fProducer(producer) {}
+
+    ~MIDIInput() { close(); }
+
+    MIDIInput(const MIDIInput&)            = delete;
+    MIDIInput& operator=(const MIDIInput&) = delete;
+
+    bool open_port(const unsigned int index) {
+        close();
+        try {
+            fInput = new RtMidiIn();
+            if (index >= fInput->getPortCount()) {
+                close();
+                return false;
+            }
+            fInput->openPort(index);
+            start();
+            return true;
+        } catch (const RtMidiError&) {
+            close();
+            return false;
+        }
+    }
+
+    /* opens the first port whose name contains `name` */
+    bool open_port(const std::string& name) {
+        const std::vector<std::string> names = get_port_names();
+        for (unsigned int i = 0; i < names.size(); ++i) {
+            if (names[i].find(name) != std::string::npos) {
+                return open_port(i);
+            }
+        }
+        return false;
+    }
+
+    bool open_virtual_port(const std::string& name) {
+        close();
+        try {
+            fInput = new RtMidiIn();
+            fInput->openVirtualPort(name);
+            start();
+            return true;
+        } catch (const RtMidiError&) {
+            close();
+            return false;
+        }
+    }
+
+    void close() {
+        if (fInput != nullptr) {
+            fInput->cancelCallback();
+            fInput->closePort();
+            delete fInput;
+            fInput = nullptr;
+        }
+    }
+
+    bool is_open() const { return fInput != nullptr; }
+
+    static std::vector<std::string> get_port_names() {
+        std::vector<std::string> names;
+        try {
+            RtMidiIn input;
+            for (unsigned int i = 0; i < input.getPortCount(); ++i) {
+                names.push_back(input.getPortName(i));
+            }
+        } catch (const RtMidiError&) {}
+        return names;
+    }
+
+    uint64_t get_received_events() const { return fReceived.load(std::memory_order_relaxed); }
+
+    uint64_t get_ignored_messages() const { return fIgnored.load(std::memory_order_relaxed); }
+
+private:
+    Producer&             fProducer;
+    RtMidiIn*             fInput{nullptr};
+    std::atomic<uint64_t> fReceived{0};
+    std::atomic<uint64_t> fIgnored{0};
+
+    void start() {
+        fInput->ignoreTypes(true, true, true);
+        fInput->setCallback(&MIDIInput::callback, this);
+    }
+
+    /* called from the MIDI backend thread */
+    static void callback(double, std::vector<unsigned char>* message, void* user_data) {
+        auto&         input = *static_cast<MIDIInput*>(user_data);
+        const int64_t time  = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        MIDIEvent     event;
+        if (!MIDIEvent::parse(message->data(), message->size(), event)) {
+            input.fIgnored.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        event.time_ns = time;
+        if (input.fProducer.post(event)) {
+            input.fReceived.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+};
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "RtMidi.h"
+
+#include "MIDIEvent.h"
+#include "TripleBuffer.h"
+
+/**
+ * measures the latency and timing jitter of MIDI input with a loopback: a sender thread
+ * plays notes at a fixed interval into a virtual output port, a `MIDIInput` connected to that
+ * port receives them and the audio thread passes every received event to `measure()`
+ * together with the frame at which it is rendered.
+ *
+ * two things are measured:
+ *
+ * - *latency*: time from sending a note to its arrival in the MIDI callback. the deviation
+ *   is the jitter of the MIDI backend.
+ * - *onset jitter*: how much the interval between the rendered notes ( in frames ) deviates
+ *   from the interval at which they were sent. this is measured for the sample accurate
+ *   position of the event and, for comparison, for the start of the block ( which is where
+ *   the notes would be rendered without timestamps ).
+ *
+ * the test notes are sent on channel 16 and carry their index in note and velocity.
+ *
+ * NOTE virtual ports are not supported on windows.
+ */
+class MIDILatencyTest {
+public:
+    static constexpr size_t MAX_NOTES = 128 * 127; // index in note and velocity ( 1 to 127 )
+    static constexpr int    CHANNEL   = 15;
+
+    struct Results {
+        size_t expected{0};
+        size_t received{0};
+        float  latency_mean_ms{0.0f};
+        float  latency_deviation_ms{0.0f};
+        float  latency_max_ms{0.0f};
+        float  onset_jitter_ms{0.0f}; // RMS of the deviation from the sent interval
+        float  onset_jitter_max_ms{0.0f};
+        float  block_onset_jitter_ms{0.0f};
+        float  block_onset_jitter_max_ms{0.0f};
+    };
+
+    explicit MIDILatencyTest(const float sample_rate) : fSampleRate(sample_rate),
+                                                        fSendTimes(new std::atomic<int64_t>[MAX_NOTES]),
+                                                        fResults(1) {}
+
+    ~MIDILatencyTest() {
+        if (fSender.joinable()) {
+            fSender.join();
+        }
+        delete fOutput;
+    }
+
+    MIDILatencyTest(const MIDILatencyTest&)            = delete;
+    MIDILatencyTest& operator=(const MIDILatencyTest&) = delete;
+
+    /* opens the virtual output port. connect a `MIDIInput` to a port with this name */
+    bool open(const std::string& port_name) {
+        try {
+            fOutput = new RtMidiOut();
+            fOutput->openVirtualPort(port_name);
+            return true;
+        } catch (const RtMidiError&) {
+            delete fOutput;
+            fOutput = nullptr;
+            return false;
+        }
+    }
+
+    /* sends `count` notes every `interval_ms` milliseconds. returns false if a test is still running */
+    bool start(const size_t count, const float interval_ms) {
+        if (fOutput == nullptr || fSending.load()) {
+            return false;
+        }
+        if (fSender.joinable()) {
+            fSender.join();
+        }
+        fCount.store(std::min(count, MAX_NOTES));
+        fIntervalNs.store(static_cast<int64_t>(interval_ms * 1.0e6f));
+        fGeneration.fetch_add(1, std::memory_order_release);
+        fSending.store(true);
+        fSender = std::thread(&MIDILatencyTest::send_notes, this);
+        return true;
+    }
+
+    bool is_sending() const { return fSending.load(); }
+
+    /* audio thread. `frame` is the frame the event is rendered at, `block_start` the first frame of the block */
+    void measure(const MIDIEvent& event, const uint64_t frame, const uint64_t block_start) {
+        if (event.type() != MIDIEvent::NOTE_ON || event.channel() != CHANNEL) {
+            return;
+        }
+        const size_t index = static_cast<size_t>(event.note()) | static_cast<size_t>(event.velocity() - 1) << 7;
+        const size_t count = fCount.load();
+        if (event.velocity() == 0 || index >= count) {
+            return;
+        }
+        /* a new test was started: reset here, so that only the audio thread touches the statistics */
+        const uint32_t generation = fGeneration.load(std::memory_order_acquire);
+        if (generation != fMeasuredGeneration) {
+            fMeasuredGeneration = generation;
+            fLatency            = {};
+            fOnset              = {};
+            fBlockOnset         = {};
+            fPreviousIndex      = SIZE_MAX;
+        }
+
+        fLatency.add(static_cast<double>(event.time_ns - fSendTimes[index].load(std::memory_order_acquire)) * 1.0e-6);
+        /* compare consecutive notes only, a lost note would count as a large deviation */
+        if (fPreviousIndex != SIZE_MAX && index == fPreviousIndex + 1) {
+            const double expected_frames = static_cast<double>(fIntervalNs.load()) * 1.0e-9 * fSampleRate;
+            const double frames_to_ms    = 1000.0 / fSampleRate;
+            fOnset.add((static_cast<double>(frame - fPreviousFrame) - expected_frames) * frames_to_ms);
+            fBlockOnset.add((static_cast<double>(block_start - fPreviousBlockStart) - expected_frames) * frames_to_ms);
+        }
+        fPreviousIndex      = index;
+        fPreviousFrame      = frame;
+        fPreviousBlockStart = block_start;
+
+        Results& results                  = *fResults.write_buffer();
+        results.expected                  = count;
+        results.received                  = fLatency.count;
+        results.latency_mean_ms           = static_cast<float>(fLatency.mean());
+        results.latency_deviation_ms      = static_cast<float>(fLatency.deviation());
+        results.latency_max_ms            = static_cast<float>(fLatency.max);
+        results.onset_jitter_ms           = static_cast<float>(fOnset.rms());
+        results.onset_jitter_max_ms       = static_cast<float>(fOnset.max_abs);
+        results.block_onset_jitter_ms     = static_cast<float>(fBlockOnset.rms());
+        results.block_onset_jitter_max_ms = static_cast<float>(fBlockOnset.max_abs);
+        fResults.publish();
+    }
+
+    /* latest results of the running or last test */
+    Results get_results() {
+        fResults.acquire();
+        return *fResults.read_buffer();
+    }
+
+private:
+    struct Accumulator {
+        size_t count{0};
+        double sum{0.0};
+        double sum_of_squares{0.0};
+        double max{-1.0e9};
+        double max_abs{0.0};
+
+        void add(const double value) {
+            count++;
+            sum += value;
+            sum_of_squares += value * value;
+            max     = std::max(max, value);
+            max_abs = std::max(max_abs, std::abs(value));
+        }
+
+        double mean() const { return count > 0 ? sum / count : 0.0; }
+        double rms() const { return count > 0 ? std::sqrt(sum_of_squares / count) : 0.0; }
+        double deviation() const { return count > 0 ? std::sqrt(std::max(0.0, sum_of_squares / count - mean() * mean())) : 0.0; }
+    };
+
+    const float                             fSampleRate;
+    RtMidiOut*                              fOutput{nullptr};
+    std::thread                             fSender;
+    std::atomic<bool>                       fSending{false};
+    std::atomic<uint32_t>                   fGeneration{0};
+    std::unique_ptr<std::atomic<int64_t>[]> fSendTimes;
+    std::atomic<size_t>                     fCount{0};
+    std::atomic<int64_t>                    fIntervalNs{0};
+    TripleBuffer<Results>                   fResults;
+    /* audio thread only */
+    uint32_t    fMeasuredGeneration{0};
+    Accumulator fLatency;
+    Accumulator fOnset;
+    Accumulator fBlockOnset;
+    size_t      fPreviousIndex{SIZE_MAX};
+    uint64_t    fPreviousFrame{0};
+    uint64_t    fPreviousBlockStart{0};
+
+    static int64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void send_notes() {
+        const auto start = std::chrono::steady_clock::now();
+        const size_t  count    = fCount.load();
+        const int64_t interval = fIntervalNs.load();
+        for (size_t i = 0; i < count; ++i) {
+            std::this_thread::sleep_until(start + std::chrono::nanoseconds(interval * static_cast<int64_t>(i)));
+            const unsigned char message[3] = {static_cast<unsigned char>(MIDIEvent::NOTE_ON | CHANNEL),
+                                              static_cast<unsigned char>(i & 0x7F),
+                                              static_cast<unsigned char>((i >> 7) + 1)};
+            fSendTimes[i].store(now_ns(), std::memory_order_release);
+            fOutput->sendMessage(message, 3);
+        }
+        fSending.store(false);
+    }
+};
@@ -0,0 +1,167 @@
+/*
+ * this example demonstrates how to deliver MIDI input to the audio thread with timestamps so
+ * that notes are rendered sample accurately.
+ *
+ * a `MIDIInput` receives MIDI messages, converts them to fixed-size `MIDIEvent`s ( no
+ * `std::vector` per message ), stamps them with the time of arrival and posts them to an
+ * `EventScheduler`. in `audioEvent()` the scheduler places each event at the same relative
+ * position inside the block at which it arrived, i.e. with a constant latency of one block
+ * instead of a latency that varies with the block size.
+ *
+ * notes from the first MIDI input port play a sawtooth. press `l` to run a latency test: a
+ * sender thread plays 500 notes at an interval of 10ms into a virtual MIDI port which is
+ * connected to a second `MIDIInput` ( loopback ). the test measures the latency of the MIDI
+ * backend and compares the timing jitter of sample accurate notes with notes that are
+ * rendered at the start of the block.
+ */
+
+#include <cmath>
+#include <cstdio>
+
+#include "Umfeld.h"
+#include "audio/ADSR.h"
+#include "audio/Wavetable.h"
+
+#include "EventScheduler.h"
+#include "MIDIEvent.h"
+#include "MIDIInput.h"
+#include "MIDILatencyTest.h"
+
+using namespace umfeld;
+
+static constexpr const char* LOOPBACK_PORT = "umfeld loopback";
+
+Wavetable*                 wavetable_oscillator;
+Wavetable*                 click_oscillator;
+ADSR*                      adsr;
+float                      click_level = 0.0f;
+EventScheduler<MIDIEvent>* scheduler;
+MIDIInput*                 device_input;
+MIDIInput*                 loopback_input;
+MIDILatencyTest*           latency_test;
+
+void settings() {
+    size(1024, 768);
+    audio();
+    run_audio_in_thread = true;
+}
+
+void setup() {
+    adsr = new ADSR(get_audio_sample_rate());
+
+    wavetable_oscillator = new Wavetable(1024, get_audio_sample_rate());
+    wavetable_oscillator->set_waveform(WAVEFORM_SAWTOOTH_HARMONICS, 8);
+    wavetable_oscillator->set_amplitude(0.5f);
+
+    click_oscillator = new Wavetable(1024, get_audio_sample_rate());
+    click_oscillator->set_waveform(WAVEFORM_SINE);
+    click_oscillator->set_frequency(2000.0f);
+
+    /* one producer per input, each port is served by its own thread */
+    scheduler      = new EventScheduler<MIDIEvent>(get_audio_sample_rate());
+    device_input   = new MIDIInput(scheduler->add_producer());
+    loopback_input = new MIDIInput(scheduler->add_producer());
+    latency_test   = new MIDILatencyTest(get_audio_sample_rate());
+
+    const std::vector<std::string> port_names = MIDIInput::get_port_names();
+    for (size_t i = 0; i < port_names.size(); ++i) {
+        console("MIDI input port ", i, ": ", port_names[i]);
+    }
+    if (!port_names.empty() && !device_input->open_port(0u)) {
+        console("could not open MIDI input port 0");
+    }
+    if (!latency_test->open(LOOPBACK_PORT) || !loopback_input->open_port(LOOPBACK_PORT)) {
+        console("could not create the MIDI loopback, the latency test is not available");
+    }
+}
+
+void draw() {
+    background(0.85f);
+
+    const MIDILatencyTest::Results results = latency_test->get_results();
+    if (results.expected > 0) {
+        noStroke();
+        fill(1.0f, 0.25f, 0.35f);
+        rect(10, 200, (width - 20) * static_cast<float>(results.received) / results.expected, 20);
+    }
+
+    fill(0);
+    char info[160];
+    snprintf(info, sizeof(info), "RECEIVED EVENTS: %llu / IGNORED MESSAGES: %llu / DROPPED EVENTS: %llu",
+             static_cast<unsigned long long>(device_input->get_received_events() + loopback_input->get_received_events()),
+             static_cast<unsigned long long>(device_input->get_ignored_messages() + loopback_input->get_ignored_messages()),
+             static_cast<unsigned long long>(scheduler->get_dropped_events()));
+    debug_text(info, 10, 10);
+    snprintf(info, sizeof(info), "LATENCY TEST%s: %zu / %zu NOTES", latency_test->is_sending() ? " ( RUNNING )" : "", results.received, results.expected);
+    debug_text(info, 10, 40);
+    snprintf(info, sizeof(info), "MIDI LATENCY        : MEAN %.3fms / DEVIATION %.3fms / MAX %.3fms",
+             results.latency_mean_ms, results.latency_deviation_ms, results.latency_max_ms);
+    debug_text(info, 10, 55);
+    snprintf(info, sizeof(info), "ONSET JITTER ( SAMPLE ACCURATE ): RMS %.3fms / MAX %.3fms", results.onset_jitter_ms, results.onset_jitter_max_ms);
+    debug_text(info, 10, 70);
+    snprintf(info, sizeof(info), "ONSET JITTER ( BLOCK START )    : RMS %.3fms / MAX %.3fms", results.block_onset_jitter_ms, results.block_onset_jitter_max_ms);
+    debug_text(info, 10, 85);
+}
+
+void keyPressed() {
+    if (key == 'l') {
+        latency_test->start(500, 10.0f);
+    }
+}
+
+void handle(const MIDIEvent& event) {
+    if (event.channel() == MIDILatencyTest::CHANNEL) {
+        if (event.is_note_on()) {
+            click_level = 0.5f;
+        }
+    } else if (event.is_note_on()) {
+        wavetable_oscillator->set_frequency(440.0f * std::pow(2.0f, (event.note() - 69) / 12.0f));
+        adsr->start();
+    } else if (event.is_note_off()) {
+        adsr->stop();
+    }
+}
+
+void render(float* buffer, const size_t from, const size_t to) {
+    for (size_t i = from; i < to; i++) {
+        float sample = adsr->process(wavetable_oscillator->process());
+        sample += click_oscillator->process() * click_level;
+        click_level *= 0.995f;
+        buffer[i] = sample;
+    }
+}
+
+void audioEvent(const PAudio& audio) {
+    const auto frames = static_cast<size_t>(audio.buffer_size);
+    float      sample_buffer[audio.buffer_size];
+
+    /* render up to each event, apply it and continue */
+    scheduler->begin_block(frames);
+    const uint64_t block_start = scheduler->get_frame_position();
+    size_t         position    = 0;
+    size_t         offset;
+    MIDIEvent      event;
+    while (scheduler->next_event(event, offset)) {
+        render(sample_buffer, position, offset);
+        latency_test->measure(event, block_start + offset, block_start);
+        handle(event);
+        position = offset;
+    }
+    render(sample_buffer, position, frames);
+
+    for (int i = 0; i < audio.buffer_size; i++) {
+        for (int j = 0; j < audio.output_channels; j++) {
+            audio.output_buffer[i * audio.output_channels + j] = sample_buffer[i];
+        }
+    }
+}
+
+void shutdown() {
+    delete device_input;
+    delete loopback_input;
+    delete latency_test;
+    delete scheduler;
+    delete wavetable_oscillator;
+    delete click_oscillator;
+    delete adsr;
+}
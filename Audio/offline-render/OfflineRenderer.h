@@ -0,0 +1,118 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "WAVWriter.h"
+
+/**
+ * drives an audio callback without an audio device. blocks are rendered back to back as fast
+ * as the CPU allows, optionally written to a WAV file, and the time spent in the callback is
+ * measured for every block ( file I/O is not included ).
+ *
+ * the callback has the signature `void(float* output, int channels, int frames)` and writes
+ * `frames` interleaved frames, i.e. it can share its body with `audioEvent()`.
+ *
+ * all buffers are allocated before rendering starts so that allocations do not distort the
+ * measurements. `get_progress()` may be called from another thread while rendering.
+ */
+class OfflineRenderer {
+public:
+    struct Statistics {
+        size_t blocks{0};
+        float  budget_us{0.0f}; // duration of one block in real time
+        float  mean_us{0.0f};
+        float  min_us{0.0f};
+        float  p50_us{0.0f};
+        float  p90_us{0.0f};
+        float  p99_us{0.0f};
+        float  max_us{0.0f};
+        float  realtime_factor{0.0f}; // rendered audio duration / wall clock time spent in the callback
+    };
+
+    OfflineRenderer(const float sample_rate, const int channels, const int buffer_size)
+        : fSampleRate(sample_rate),
+          fChannels(channels),
+          fBufferSize(buffer_size) {}
+
+    float get_sample_rate() const { return fSampleRate; }
+    int   get_channels() const { return fChannels; }
+    int   get_buffer_size() const { return fBufferSize; }
+
+    /* renders `seconds` of audio. if `writer` is not null the output is written to it */
+    template<typename Render>
+    Statistics render(const float seconds, Render&& render, WAVWriter* writer = nullptr) {
+        const auto blocks = static_cast<size_t>(std::ceil(seconds * fSampleRate / fBufferSize));
+        fOutput.assign(static_cast<size_t>(fBufferSize) * fChannels, 0.0f);
+        fBlockTimes.assign(blocks, 0.0f);
+        fProgress.store(0.0f);
+
+        for (size_t b = 0; b < blocks; ++b) {
+            const auto start = std::chrono::steady_clock::now();
+            render(fOutput.data(), fChannels, fBufferSize);
+            fBlockTimes[b] = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count();
+            if (writer != nullptr) {
+                writer->write(fOutput.data(), fBufferSize);
+            }
+            fProgress.store(static_cast<float>(b + 1) / static_cast<float>(blocks), std::memory_order_relaxed);
+        }
+        fProgress.store(1.0f);
+        return compute_statistics();
+    }
+
+    /* renders `seconds` of audio into a 32 bit float WAV file at `path` */
+    template<typename Render>
+    Statistics render_to_file(const std::string& path, const float seconds, Render&& render, bool* success = nullptr) {
+        WAVWriter  writer;
+        const bool opened = writer.open(path, fChannels, static_cast<uint32_t>(fSampleRate));
+        if (success != nullptr) {
+            *success = opened;
+        }
+        return this->render(seconds, render, opened ? &writer : nullptr);
+    }
+
+    /* any thread. fraction of blocks rendered by the current or last `render` call */
+    float get_progress() const { return fProgress.load(std::memory_order_relaxed); }
+
+    /* per block times in microseconds of the last `render` call */
+    const std::vector<float>& get_block_times() const { return fBlockTimes; }
+
+private:
+    const float        fSampleRate;
+    const int          fChannels;
+    const int          fBufferSize;
+    std::vector<float> fOutput;
+    std::vector<float> fBlockTimes;
+    std::atomic<float> fProgress{0.0f};
+
+    Statistics compute_statistics() const {
+        Statistics stats;
+        stats.blocks    = fBlockTimes.size();
+        stats.budget_us = fBufferSize * 1000000.0f / fSampleRate;
+        if (fBlockTimes.empty()) {
+            return stats;
+        }
+        std::vector<float> sorted = fBlockTimes;
+        std::sort(sorted.begin(), sorted.end());
+        /* nearest rank percentile */
+        const auto percentile = [&sorted](const float p) {
+            const auto rank = static_cast<size_t>(std::ceil(p / 100.0f * sorted.size()));
+            return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+        };
+        const float total     = std::accumulate(sorted.begin(), sorted.end(), 0.0f);
+        stats.mean_us         = total / sorted.size();
+        stats.min_us          = sorted.front();
+        stats.p50_us          = percentile(50.0f);
+        stats.p90_us          = percentile(90.0f);
+        stats.p99_us          = percentile(99.0f);
+        stats.max_us          = sorted.back();
+        stats.realtime_factor = total > 0.0f ? stats.budget_us * stats.blocks / total : 0.0f;
+        return stats;
+    }
+};
@@ -0,0 +1,193 @@
+/*
+ * this example demonstrates how to render audio offline, i.e. without an audio device and
+ * faster than real time. the DSP chain is rendered by a function that is called both from
+ * `audioEvent()` and from an `OfflineRenderer`, which writes the output to a WAV file and
+ * reports the CPU time spent per block.
+ *
+ * press `r` to render 60 seconds to `render.wav` while the example is running. the file is
+ * rendered on a separate thread, the progress is shown in the window. start the example with
+ * the argument `--render` to render without window and audio device ( e.g. on a build
+ * machine ) and exit afterwards.
+ */
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "Umfeld.h"
+#include "audio/Sampler.h"
+#include "audio/LowPassFilter.h"
+#include "audio/Wavetable.h"
+
+#include "OfflineRenderer.h"
+
+using namespace umfeld;
+
+static constexpr float RENDER_SAMPLE_RATE = 48000.0f;
+static constexpr int   RENDER_CHANNELS    = 2;
+static constexpr int   RENDER_BUFFER_SIZE = 512;
+static constexpr float RENDER_DURATION    = 60.0f;
+
+/* DSP chain: sampler → low-pass filter, modulated by an LFO */
+struct Chain {
+    Sampler*       sampler;
+    LowPassFilter* filter;
+    Wavetable*     lfo;
+
+    explicit Chain(const float sample_rate) {
+        sampler = loadSample("teilchen.wav");
+        sampler->set_looping();
+        sampler->play();
+        filter = new LowPassFilter(sample_rate);
+        filter->set_resonance(0.6f);
+        lfo = new Wavetable(1024, sample_rate);
+        lfo->set_waveform(WAVEFORM_SINE);
+        lfo->set_frequency(0.25f);
+    }
+
+    ~Chain() {
+        delete sampler;
+        delete filter;
+        delete lfo;
+    }
+};
+
+Chain*                   chain           = nullptr;
+bool                     render_and_exit = false;
+OfflineRenderer          renderer(RENDER_SAMPLE_RATE, RENDER_CHANNELS, RENDER_BUFFER_SIZE);
+std::thread              render_thread;
+std::atomic<bool>        rendering{false};
+std::mutex               render_results_mutex;
+std::vector<std::string> render_results;
+
+/* renders `frames` interleaved frames. shared by `audioEvent()` and the offline renderer */
+void render(Chain& c, float* output, const int channels, const int frames) {
+    for (int i = 0; i < frames; i++) {
+        c.filter->set_frequency(2000.0f + 1800.0f * c.lfo->process());
+        const float sample = c.filter->process(c.sampler->process());
+        for (int j = 0; j < channels; j++) {
+            output[i * channels + j] = sample;
+        }
+    }
+}
+
+/* renders `offline_chain` to a file. the chain must not be used by the audio thread */
+void render_to_file(Chain& offline_chain) {
+    const std::string path    = sketchPath() + "render.wav";
+    bool              success = false;
+
+    const auto render_offline = [&offline_chain](float* output, const int channels, const int frames) {
+        render(offline_chain, output, channels, frames);
+    };
+    const OfflineRenderer::Statistics stats = renderer.render_to_file(path, RENDER_DURATION, render_offline, &success);
+    if (!success) {
+        error("could not write to: " + path);
+    }
+
+    char                     result[160];
+    std::vector<std::string> results;
+    results.emplace_back("RENDERED " + nf(RENDER_DURATION, 1) + "s in " + to_string(stats.blocks) + " blocks of " + to_string(RENDER_BUFFER_SIZE) + " frames to " + path);
+    snprintf(result, sizeof(result), "BLOCK TIME ( budget %.1fus ): mean %.2fus  min %.2fus  p50 %.2fus  p90 %.2fus  p99 %.2fus  max %.2fus",
+             stats.budget_us, stats.mean_us, stats.min_us, stats.p50_us, stats.p90_us, stats.p99_us, stats.max_us);
+    results.emplace_back(result);
+    snprintf(result, sizeof(result), "REAL TIME FACTOR: x%.1f", stats.realtime_factor);
+    results.emplace_back(result);
+    for (const auto& line: results) {
+        console(line);
+    }
+    std::lock_guard<std::mutex> lock(render_results_mutex);
+    render_results = std::move(results);
+}
+
+/* renders on a separate thread, so that neither `draw()` nor the audio thread are blocked */
+void start_render_thread() {
+    if (rendering.load()) {
+        return;
+    }
+    if (render_thread.joinable()) {
+        render_thread.join();
+    }
+    /* NOTE separate chain so that offline rendering does not interfere with the audio thread. it
+     *      is created here on the main thread, because `loadSample()` must not be called from
+     *      the render thread, and then moved into the render thread. */
+    auto offline_chain = std::make_unique<Chain>(RENDER_SAMPLE_RATE);
+    rendering.store(true);
+    render_thread = std::thread([offline_chain = std::move(offline_chain)] {
+        render_to_file(*offline_chain);
+        rendering.store(false);
+    });
+}
+
+void arguments(std::vector<std::string> args) {
+    for (const auto& arg: args) {
+        if (arg == "--render") {
+            render_and_exit = true;
+        }
+    }
+}
+
+void settings() {
+    if (render_and_exit) {
+        /* NOTE without `size()` and `audio()` neither a window nor an audio device is created */
+        return;
+    }
+    size(1024, 768);
+    audio();
+}
+
+void setup() {
+    if (render_and_exit) {
+        Chain offline_chain(RENDER_SAMPLE_RATE);
+        render_to_file(offline_chain);
+        exit();
+        return;
+    }
+
+    if (get_audio_output_channels() != 2) {
+        error("this example requires a stereo output");
+        exit(1);
+    }
+    chain = new Chain(get_audio_sample_rate());
+}
+
+void draw() {
+    background(0.85f);
+
+    noFill();
+    stroke(1.0f, 0.25f, 0.35f);
+    strokeWeight(16.0f);
+    if (chain != nullptr) {
+        arc(width / 2.0f, height / 2.0f, height / 2.0f, height / 2.0f, -HALF_PI, TWO_PI * chain->sampler->get_position_normalized() - HALF_PI);
+    }
+
+    fill(0);
+    if (rendering.load()) {
+        debug_text("RENDERING: " + nf(renderer.get_progress() * 100.0f, 1) + "%", 10, 10);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(render_results_mutex);
+    for (size_t i = 0; i < render_results.size(); ++i) {
+        debug_text(render_results[i], 10, 10 + i * 15);
+    }
+}
+
+void keyPressed() {
+    if (key == 'r') {
+        start_render_thread();
+    }
+}
+
+void audioEvent(const PAudio& audio) {
+    if (chain != nullptr) {
+        render(*chain, audio.output_buffer, audio.output_channels, audio.buffer_size);
+    }
+}
+
+void shutdown() {
+    if (render_thread.joinable()) {
+        render_thread.join();
+    }
+    delete chain;
+}
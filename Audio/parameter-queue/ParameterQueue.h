@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "SPSCQueue.h"
+
+/**
+ * passes parameter changes from one thread ( e.g `draw()` ) to the audio thread without
+ * locks. the producer calls `set()`, which pushes an event into a lock-free ring. the audio
+ * thread calls `update()` once at the beginning of each block to apply all pending events
+ * and then reads values with `get()`, `next()` or `advance()`. if an event has a ramp length
+ * the value moves linearly from its current value to the new value over that many frames.
+ *
+ * all audio thread methods are wait-free and never allocate.
+ */
+class ParameterQueue {
+public:
+    static constexpr size_t QUEUE_SIZE = 1024;
+
+    explicit ParameterQueue(const size_t number_of_parameters, const float initial_value = 0.0f)
+        : fParameters(number_of_parameters) {
+        for (auto& p: fParameters) {
+            p.value  = initial_value;
+            p.target = initial_value;
+        }
+    }
+
+    /* producer side. returns false and counts a dropped event if the ring is full */
+    bool set(const uint32_t id, const float value, const uint32_t ramp_frames = 0) {
+        if (fQueue.push({id, value, ramp_frames})) {
+            return true;
+        }
+        fDroppedEvents.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    /* sets the value immediately. only call this before audio is running */
+    void init(const uint32_t id, const float value) {
+        if (id < fParameters.size()) {
+            fParameters[id] = {value, value, 0.0f, 0};
+        }
+    }
+
+    uint32_t get_dropped_events() const { return fDroppedEvents.load(std::memory_order_relaxed); }
+
+    /* audio thread. applies all pending events, call this once per block */
+    void update() {
+        Event event{};
+        while (fQueue.pop(event)) {
+            if (event.id >= fParameters.size()) {
+                continue;
+            }
+            Parameter& p = fParameters[event.id];
+            p.target     = event.value;
+            if (event.ramp_frames == 0) {
+                p.value     = event.value;
+                p.increment = 0.0f;
+                p.remaining = 0;
+            } else {
+                p.increment = (event.value - p.value) / static_cast<float>(event.ramp_frames);
+                p.remaining = event.ramp_frames;
+            }
+        }
+    }
+
+    /* audio thread. current value without advancing the ramp */
+    float get(const uint32_t id) const { return fParameters[id].value; }
+
+    bool is_ramping(const uint32_t id) const { return fParameters[id].remaining > 0; }
+
+    /* audio thread. advances the ramp by one frame and returns the value for that frame */
+    float next(const uint32_t id) { return advance(id, 1); }
+
+    /* audio thread. advances the ramp by `frames` and returns the value reached */
+    float advance(const uint32_t id, const size_t frames) {
+        Parameter& p = fParameters[id];
+        if (p.remaining == 0) {
+            return p.value;
+        }
+        const size_t n = std::min<size_t>(frames, p.remaining);
+        p.remaining -= static_cast<uint32_t>(n);
+        p.value = p.remaining == 0 ? p.target : p.value + p.increment * static_cast<float>(n);
+        return p.value;
+    }
+
+    /* audio thread. writes the ( ramped ) value for each of the next `frames` frames into `output` */
+    void process(const uint32_t id, float* output, const size_t frames) {
+        Parameter&   p   = fParameters[id];
+        const size_t run = std::min<size_t>(frames, p.remaining);
+        float        v   = p.value;
+        for (size_t i = 0; i < run; ++i) {
+            v += p.increment;
+            output[i] = v;
+        }
+        p.remaining -= static_cast<uint32_t>(run);
+        if (p.remaining == 0) {
+            v = p.target;
+        }
+        std::fill(output + run, output + frames, v);
+        p.value = v;
+    }
+
+private:
+    struct Event {
+        uint32_t id;
+        float    value;
+        uint32_t ramp_frames;
+    };
+
+    struct Parameter {
+        float    value;
+        float    target;
+        float    increment;
+        uint32_t remaining;
+    };
+
+    SPSCQueue<Event, QUEUE_SIZE> fQueue;
+    std::vector<Parameter>       fParameters;
+    std::atomic<uint32_t>        fDroppedEvents{0};
+};
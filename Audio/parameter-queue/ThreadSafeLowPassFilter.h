@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Umfeld.h"
+#include "audio/LowPassFilter.h"
+
+#include "ParameterQueue.h"
+
+/**
+ * wraps `LowPassFilter` with setters that may be called from any single thread other than the
+ * audio thread ( e.g `draw()` ). changes are passed through a `ParameterQueue` and applied at
+ * the next block boundary. with a ramp length the filter glides to the new values; filter
+ * coefficients are then updated every `RAMP_STEP` frames instead of every frame.
+ */
+class ThreadSafeLowPassFilter {
+public:
+    static constexpr size_t RAMP_STEP = 16;
+
+    explicit ThreadSafeLowPassFilter(const float sample_rate, const float frequency = 1000.0f, const float resonance = 0.5f)
+        : fFilter(sample_rate),
+          fParameters(NUM_PARAMETERS) {
+        fParameters.init(FREQUENCY, frequency);
+        fParameters.init(RESONANCE, resonance);
+        fFilter.set_frequency(frequency);
+        fFilter.set_resonance(resonance);
+    }
+
+    /* thread-safe. `ramp_frames` is the glide time in frames */
+    bool set_frequency(const float frequency, const uint32_t ramp_frames = 0) {
+        return fParameters.set(FREQUENCY, frequency, ramp_frames);
+    }
+
+    /* thread-safe. `ramp_frames` is the glide time in frames */
+    bool set_resonance(const float resonance, const uint32_t ramp_frames = 0) {
+        return fParameters.set(RESONANCE, resonance, ramp_frames);
+    }
+
+    uint32_t get_dropped_events() const { return fParameters.get_dropped_events(); }
+
+    /* audio thread. filters `frames` samples of `buffer` in place */
+    void process(float* buffer, const size_t frames) {
+        fParameters.update();
+        size_t i = 0;
+        while (i < frames) {
+            const size_t step = fParameters.is_ramping(FREQUENCY) || fParameters.is_ramping(RESONANCE)
+                                    ? std::min(RAMP_STEP, frames - i)
+                                    : frames - i;
+            fFilter.set_frequency(fParameters.advance(FREQUENCY, step));
+            fFilter.set_resonance(fParameters.advance(RESONANCE, step));
+            for (const size_t end = i + step; i < end; ++i) {
+                buffer[i] = fFilter.process(buffer[i]);
+            }
+        }
+    }
+
+private:
+    enum {
+        FREQUENCY,
+        RESONANCE,
+        NUM_PARAMETERS
+    };
+
+    umfeld::LowPassFilter fFilter;
+    ParameterQueue        fParameters;
+};
@@ -0,0 +1,91 @@
+/*
+ * this example demonstrates how to change audio parameters from `draw()` while audio runs in
+ * its own thread. instead of calling setters of `LowPassFilter` directly ( which is a data
+ * race ) or guarding them with a mutex ( which may block the audio thread ) all changes are
+ * passed through a lock-free `ParameterQueue` and applied at the beginning of the next audio
+ * block. press `1` and `2` to fade the volume in and out with a per-sample ramp.
+ */
+
+#include "Umfeld.h"
+#include "audio/Sampler.h"
+
+#include "ParameterQueue.h"
+#include "ThreadSafeLowPassFilter.h"
+
+using namespace umfeld;
+
+enum {
+    GAIN,
+    NUM_PARAMETERS
+};
+
+Sampler*                 sampler;
+ThreadSafeLowPassFilter* filter;
+ParameterQueue           parameters{NUM_PARAMETERS, 1.0f};
+
+void settings() {
+    size(1024, 768);
+    audio();
+    run_audio_in_thread = true;
+}
+
+void setup() {
+    sampler = loadSample("teilchen.wav");
+    sampler->set_looping();
+    sampler->play();
+
+    filter = new ThreadSafeLowPassFilter(get_audio_sample_rate());
+
+    if (get_audio_output_channels() != 2) {
+        error("this example requires a stereo output");
+        exit(1);
+    }
+}
+
+void draw() {
+    background(0.85f);
+    noFill();
+    stroke(1.0f, 0.25f, 0.35f);
+    const float size = 50.0f;
+    const float x    = width / 2.0f;
+    const float y    = height / 2.0f;
+    line(x - size, y - size, x + size, y + size);
+    line(x - size, y + size, x + size, y - size);
+
+    /* glide to new values within 10ms to avoid zipper noise */
+    const uint32_t ramp_frames = get_audio_sample_rate() / 100;
+    filter->set_frequency(map(mouseX, 0, width, 20.0f, 8000.0f), ramp_frames);
+    filter->set_resonance(map(mouseY, 0, height, 0.1f, 0.9f), ramp_frames);
+
+    fill(0);
+    debug_text("DROPPED EVENTS: " + to_string(filter->get_dropped_events() + parameters.get_dropped_events()), 10, 10);
+}
+
+void keyPressed() {
+    const uint32_t fade_frames = get_audio_sample_rate() / 2;
+    if (key == '1') {
+        parameters.set(GAIN, 1.0f, fade_frames);
+    }
+    if (key == '2') {
+        parameters.set(GAIN, 0.0f, fade_frames);
+    }
+}
+
+void audioEvent(const PAudio& audio) {
+    float sample_buffer[audio.buffer_size];
+    float gain_buffer[audio.buffer_size];
+    parameters.update();
+    parameters.process(GAIN, gain_buffer, audio.buffer_size);
+    for (int i = 0; i < audio.buffer_size; i++) {
+        sample_buffer[i] = sampler->process() * gain_buffer[i];
+    }
+    filter->process(sample_buffer, audio.buffer_size);
+    if (audio.output_channels == 2) {
+        merge_interleaved_stereo(sample_buffer, sample_buffer, audio.output_buffer, audio.buffer_size);
+    }
+}
+
+void shutdown() {
+    delete sampler;
+    delete filter;
+}
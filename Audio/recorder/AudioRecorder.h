@@ -0,0 +1,222 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SPSCQueue.h"
+#include "WAVWriter.h"
+
+/**
+ * records interleaved audio from the audio thread to a WAV file without blocking I/O on the
+ * audio thread. `write()` copies each block into preallocated chunks of `chunk_frames` frames.
+ * full chunks are passed to a writer thread, which encodes them to disk and returns them:
+ *
+ *     audio thread → filled queue → writer thread → free queue → audio thread
+ *
+ * both queues are lock-free and nothing is allocated after construction. memory use is bounded
+ * by `number_of_chunks * chunk_frames * channels * sizeof(float)`, i.e. the chunks buffer
+ * `number_of_chunks * chunk_frames / sample_rate` seconds of audio while the disk is stalled.
+ * if no free chunk is available the block is dropped and counted as an overrun. the length of
+ * the recording is only limited by the disk ( see `WAVWriter` for files > 4GB ).
+ *
+ * `start()` and `stop()` must be called from the same ( non audio ) thread.
+ */
+class AudioRecorder {
+public:
+    static constexpr size_t MAX_CHUNKS = 1024;
+
+    struct Settings {
+        size_t            chunk_frames          = 4096;
+        size_t            number_of_chunks      = 64;
+        WAVWriter::Format format                = WAVWriter::INT24;
+        float             header_update_seconds = 10.0f;
+    };
+
+    AudioRecorder(const uint32_t channels, const uint32_t sample_rate) : AudioRecorder(channels, sample_rate, Settings{}) {}
+
+    AudioRecorder(const uint32_t channels, const uint32_t sample_rate, const Settings& settings)
+        : fSettings(settings), fChannels(std::max(channels, 1u)), fSampleRate(sample_rate) {
+        fSettings.number_of_chunks = std::clamp<size_t>(fSettings.number_of_chunks, 2, MAX_CHUNKS - 1);
+        fSettings.chunk_frames     = std::max<size_t>(fSettings.chunk_frames, 1);
+        fChunks.resize(fSettings.number_of_chunks);
+        for (auto& chunk: fChunks) {
+            chunk.data.assign(fSettings.chunk_frames * fChannels, 0.0f);
+            fFreeChunks.push(&chunk);
+        }
+    }
+
+    ~AudioRecorder() { stop(); }
+
+    AudioRecorder(const AudioRecorder&)            = delete;
+    AudioRecorder& operator=(const AudioRecorder&) = delete;
+
+    /* opens `path` and starts recording with the next call to `write()` */
+    bool start(const std::string& path) {
+        stop();
+        if (!fWriter.open(path, fChannels, fSampleRate, fSettings.format)) {
+            return false;
+        }
+        fFramesRecorded.store(0);
+        fFramesWritten.store(0);
+        fWriteErrors.store(0);
+        /* return chunks that were submitted after the last `stop()` timed out */
+        Chunk* chunk;
+        while (fFilledChunks.pop(chunk)) {
+            fFreeChunks.push(chunk);
+        }
+        fRunning.store(true);
+        fWriterThread = std::thread(&AudioRecorder::writer_loop, this);
+        fRecording.store(true);
+        return true;
+    }
+
+    /**
+     * stops recording, waits until the audio thread has handed over its last chunk and the
+     * writer thread has written all chunks, and closes the file. NOTE if the audio thread is
+     * not running the last partially filled chunk is lost.
+     */
+    void stop() {
+        if (!fRecording.load()) {
+            return;
+        }
+        fRecording.store(false);
+        const uint32_t request = fStopRequests.fetch_add(1) + 1;
+        for (int i = 0; i < 100 && fStopAcknowledged.load() != request; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        fRunning.store(false);
+        if (fWriterThread.joinable()) {
+            fWriterThread.join();
+        }
+        fWriter.close();
+    }
+
+    bool is_recording() const { return fRecording.load(std::memory_order_relaxed); }
+
+    /* audio thread. copies `frames` interleaved frames with `get_channels()` channels */
+    void write(const float* interleaved, const size_t frames) {
+        const uint32_t request = fStopRequests.load(std::memory_order_acquire);
+        if (!fRecording.load(std::memory_order_acquire)) {
+            if (fCurrentChunk != nullptr) {
+                submit_current_chunk();
+            }
+            fStopAcknowledged.store(request, std::memory_order_release);
+            return;
+        }
+        size_t copied = 0;
+        while (copied < frames) {
+            if (fCurrentChunk == nullptr) {
+                if (!fFreeChunks.pop(fCurrentChunk)) {
+                    fCurrentChunk = nullptr;
+                    fOverruns.fetch_add(1, std::memory_order_relaxed);
+                    fDroppedFrames.fetch_add(frames - copied, std::memory_order_relaxed);
+                    break;
+                }
+                fCurrentChunk->frames = 0;
+            }
+            const size_t n = std::min(frames - copied, fSettings.chunk_frames - fCurrentChunk->frames);
+            std::copy_n(interleaved + copied * fChannels, n * fChannels, fCurrentChunk->data.data() + fCurrentChunk->frames * fChannels);
+            fCurrentChunk->frames += n;
+            copied += n;
+            if (fCurrentChunk->frames == fSettings.chunk_frames) {
+                submit_current_chunk();
+            }
+        }
+        fFramesRecorded.fetch_add(copied, std::memory_order_relaxed);
+    }
+
+    uint32_t get_channels() const { return fChannels; }
+    uint32_t get_sample_rate() const { return fSampleRate; }
+    uint64_t get_frames_recorded() const { return fFramesRecorded.load(std::memory_order_relaxed); }
+    uint64_t get_frames_written() const { return fFramesWritten.load(std::memory_order_relaxed); }
+    uint64_t get_dropped_frames() const { return fDroppedFrames.load(std::memory_order_relaxed); }
+    uint32_t get_overruns() const { return fOverruns.load(std::memory_order_relaxed); }
+    uint32_t get_write_errors() const { return fWriteErrors.load(std::memory_order_relaxed); }
+    size_t   get_buffered_chunks() const { return fFilledChunks.size(); }
+    size_t   get_max_buffered_chunks() const { return fMaxBufferedChunks.load(std::memory_order_relaxed); }
+    size_t   get_number_of_chunks() const { return fSettings.number_of_chunks; }
+    size_t   get_memory_budget() const { return fSettings.number_of_chunks * fSettings.chunk_frames * fChannels * sizeof(float); }
+
+    float get_recorded_seconds() const { return static_cast<float>(get_frames_recorded()) / static_cast<float>(std::max(fSampleRate, 1u)); }
+
+    /* seconds of audio the chunks can buffer while the disk is stalled */
+    float get_buffer_seconds() const {
+        return static_cast<float>(fSettings.number_of_chunks * fSettings.chunk_frames) / static_cast<float>(std::max(fSampleRate, 1u));
+    }
+
+    /* clears overruns, dropped frames and the maximum number of buffered chunks */
+    void reset_statistics() {
+        fOverruns.store(0);
+        fDroppedFrames.store(0);
+        fMaxBufferedChunks.store(0);
+    }
+
+private:
+    struct Chunk {
+        std::vector<float> data;
+        size_t             frames{0};
+    };
+
+    Settings                      fSettings;
+    uint32_t                      fChannels;
+    uint32_t                      fSampleRate;
+    WAVWriter                     fWriter;
+    std::vector<Chunk>            fChunks;
+    SPSCQueue<Chunk*, MAX_CHUNKS> fFilledChunks;
+    SPSCQueue<Chunk*, MAX_CHUNKS> fFreeChunks;
+    std::thread                   fWriterThread;
+    std::atomic<bool>             fRunning{false};
+    std::atomic<bool>             fRecording{false};
+    std::atomic<uint32_t>         fStopRequests{0};
+    std::atomic<uint32_t>         fStopAcknowledged{0};
+    std::atomic<uint64_t>         fFramesRecorded{0};
+    std::atomic<uint64_t>         fFramesWritten{0};
+    std::atomic<uint64_t>         fDroppedFrames{0};
+    std::atomic<uint32_t>         fOverruns{0};
+    std::atomic<uint32_t>         fWriteErrors{0};
+    std::atomic<size_t>           fMaxBufferedChunks{0};
+    /* audio thread only */
+    Chunk*                        fCurrentChunk{nullptr};
+
+    void submit_current_chunk() {
+        /* NOTE can not fail, the queue holds all chunks */
+        fFilledChunks.push(fCurrentChunk);
+        fCurrentChunk = nullptr;
+        const size_t buffered = fFilledChunks.size();
+        if (buffered > fMaxBufferedChunks.load(std::memory_order_relaxed)) {
+            fMaxBufferedChunks.store(buffered, std::memory_order_relaxed);
+        }
+    }
+
+    void writer_loop() {
+        const auto     chunk_period         = std::chrono::microseconds(1000000 * fSettings.chunk_frames / std::max(1u, fSampleRate));
+        const uint64_t header_update_frames = static_cast<uint64_t>(std::max(fSettings.header_update_seconds, 0.1f) * fSampleRate);
+        uint64_t       next_header_update   = header_update_frames;
+        /* keep writing until the queue is drained after `stop()` */
+        while (true) {
+            const bool running = fRunning.load();
+            Chunk*     chunk;
+            if (!fFilledChunks.pop(chunk)) {
+                if (!running) {
+                    break;
+                }
+                std::this_thread::sleep_for(chunk_period / 4);
+                continue;
+            }
+            if (!fWriter.write(chunk->data.data(), chunk->frames)) {
+                fWriteErrors.fetch_add(1, std::memory_order_relaxed);
+            }
+            fFreeChunks.push(chunk);
+            fFramesWritten.store(fWriter.get_frames_written(), std::memory_order_relaxed);
+            if (fWriter.get_frames_written() >= next_header_update) {
+                fWriter.update_header();
+                next_header_update += header_update_frames;
+            }
+        }
+    }
+};
@@ -0,0 +1,128 @@
+/*
+ * this example demonstrates how to record the input and the output of `audioEvent()` to disk
+ * without blocking the audio thread. two `AudioRecorder`s copy every block into preallocated
+ * chunks which are written to WAV files by background threads. the recorders can run for
+ * hours: memory use is fixed and files larger than 4GB are written as RF64.
+ *
+ * the input is passed through to the output together with a quiet oscillator. press `r` to
+ * start and stop recording to `input.wav` and `output.wav`. press `c` to clear the overrun
+ * statistics.
+ */
+
+#include <cstdio>
+
+#include "Umfeld.h"
+#include "audio/Wavetable.h"
+
+#include "AudioRecorder.h"
+
+using namespace umfeld;
+
+AudioRecorder* input_recorder  = nullptr;
+AudioRecorder* output_recorder = nullptr;
+Wavetable*     oscillator;
+
+void settings() {
+    size(1024, 768);
+    audio(2, 2);
+}
+
+void setup() {
+    oscillator = new Wavetable(1024, get_audio_sample_rate());
+    oscillator->set_waveform(WAVEFORM_SINE);
+    oscillator->set_frequency(220.0f);
+    oscillator->set_amplitude(0.1f);
+
+    if (get_audio_input_channels() > 0) {
+        input_recorder = new AudioRecorder(get_audio_input_channels(), get_audio_sample_rate());
+    }
+    output_recorder = new AudioRecorder(get_audio_output_channels(), get_audio_sample_rate());
+}
+
+void draw_recorder(const char* name, const AudioRecorder* recorder, const float y) {
+    if (recorder == nullptr) {
+        debug_text(std::string(name) + ": NO CHANNELS", 10, y);
+        return;
+    }
+    char info[256];
+    snprintf(info, sizeof(info), "%s: %u CH / %.1fs RECORDED / %.1fs WRITTEN / BUFFER %zu/%zu ( MAX %zu ) CHUNKS / OVERRUNS %u ( %llu FRAMES ) / WRITE ERRORS %u",
+             name,
+             recorder->get_channels(),
+             recorder->get_recorded_seconds(),
+             static_cast<float>(recorder->get_frames_written()) / recorder->get_sample_rate(),
+             recorder->get_buffered_chunks(),
+             recorder->get_number_of_chunks(),
+             recorder->get_max_buffered_chunks(),
+             recorder->get_overruns(),
+             static_cast<unsigned long long>(recorder->get_dropped_frames()),
+             recorder->get_write_errors());
+    debug_text(info, 10, y);
+}
+
+void draw() {
+    background(0.85f);
+
+    const bool recording = output_recorder->is_recording();
+    if (recording) {
+        noStroke();
+        fill(1.0f, 0.25f, 0.35f);
+    } else {
+        noFill();
+        stroke(1.0f, 0.25f, 0.35f);
+    }
+    circle(width / 2.0f, height / 2.0f, 100);
+
+    fill(0);
+    debug_text(recording ? "RECORDING ( press `r` to stop )" : "STOPPED ( press `r` to record )", 10, 10);
+    draw_recorder("INPUT ", input_recorder, 25);
+    draw_recorder("OUTPUT", output_recorder, 40);
+    debug_text("MEMORY PER RECORDER: " + to_string(output_recorder->get_memory_budget() / 1024) + "KB ( " +
+                   nf(output_recorder->get_buffer_seconds(), 1) + "s of audio )",
+               10, 55);
+}
+
+void keyPressed() {
+    if (key == 'r') {
+        if (output_recorder->is_recording()) {
+            if (input_recorder != nullptr) {
+                input_recorder->stop();
+            }
+            output_recorder->stop();
+            console("recorded ", output_recorder->get_recorded_seconds(), "s");
+        } else {
+            if (input_recorder != nullptr && !input_recorder->start(sketchPath() + "input.wav")) {
+                error("could not write to: " + sketchPath() + "input.wav");
+            }
+            if (!output_recorder->start(sketchPath() + "output.wav")) {
+                error("could not write to: " + sketchPath() + "output.wav");
+            }
+        }
+    }
+    if (key == 'c') {
+        if (input_recorder != nullptr) {
+            input_recorder->reset_statistics();
+        }
+        output_recorder->reset_statistics();
+    }
+}
+
+void audioEvent(const PAudio& audio) {
+    /* NOTE `write()` only copies the block, the files are written by the recorders’ threads */
+    if (input_recorder != nullptr) {
+        input_recorder->write(audio.input_buffer, audio.buffer_size);
+    }
+    for (int i = 0; i < audio.buffer_size; i++) {
+        const float sample = oscillator->process();
+        for (int j = 0; j < audio.output_channels; j++) {
+            const float input = audio.input_channels > 0 ? audio.input_buffer[i * audio.input_channels + j % audio.input_channels] : 0.0f;
+            audio.output_buffer[i * audio.output_channels + j] = input + sample;
+        }
+    }
+    output_recorder->write(audio.output_buffer, audio.buffer_size);
+}
+
+void shutdown() {
+    delete input_recorder;
+    delete output_recorder;
+    delete oscillator;
+}
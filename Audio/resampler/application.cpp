@@ -0,0 +1,201 @@
+/*
+ * this example demonstrates how to change the playback rate of a sample on the fly with a
+ * polyphase windowed-sinc resampler. the resampler also compensates a mismatch between the
+ * sample rate of the file and the sample rate of the audio device. move the mouse
+ * horizontally to change the playback rate, press `1`, `2` or `3` to select the low, medium
+ * or high quality tier and `b` to run a benchmark that reports SNR and throughput per tier.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#include "Umfeld.h"
+#include "audio/AudioUtilities.h"
+#include "audio/Sampler.h"
+
+#include "Resampler.h"
+
+using namespace umfeld;
+
+Sampler*                 sample_source;
+Resampler*               resamplers[3];
+std::atomic<int>         quality{Resampler::MEDIUM};
+std::atomic<float>       playback_rate{1.0f};
+int                      current_quality = Resampler::MEDIUM;
+size_t                   read_position   = 0;
+std::atomic<float>       playback_position{0.0f};
+std::vector<std::string> benchmark_results;
+
+void settings() {
+    size(1024, 768);
+    audio();
+}
+
+/* signal-to-noise ratio in dB of a sine wave resampled from `input_rate` to `output_rate` */
+template<typename Resample>
+float measure_snr(const Resample& resample, const float frequency, const double input_rate, const double output_rate) {
+    std::vector<float> input(static_cast<size_t>(input_rate));
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = 0.5f * std::sin(TWO_PI * frequency * i / input_rate);
+    }
+    const std::vector<float> output = resample(input, input_rate, output_rate);
+    double                   signal = 0.0;
+    double                   noise  = 0.0;
+    /* skip the edges where the filter sees silence */
+    for (size_t i = 256; i + 256 < output.size(); ++i) {
+        const double reference = 0.5 * std::sin(TWO_PI * frequency * i / output_rate);
+        signal += reference * reference;
+        noise += (output[i] - reference) * (output[i] - reference);
+    }
+    return static_cast<float>(10.0 * std::log10(signal / noise));
+}
+
+/* reference: linear interpolation between neighboring samples */
+std::vector<float> resample_linear(const std::vector<float>& input, const double input_rate, const double output_rate) {
+    std::vector<float> output(static_cast<size_t>(input.size() * output_rate / input_rate));
+    const double       step = input_rate / output_rate;
+    for (size_t i = 0; i < output.size(); ++i) {
+        const double position = i * step;
+        const auto   index    = static_cast<size_t>(position);
+        const auto   fraction = static_cast<float>(position - index);
+        const float  a        = input[std::min(index, input.size() - 1)];
+        const float  b        = input[std::min(index + 1, input.size() - 1)];
+        output[i]             = a + (b - a) * fraction;
+    }
+    return output;
+}
+
+void run_benchmark() {
+    static constexpr const char* NAMES[]      = {"LOW   ", "MEDIUM", "HIGH  "};
+    static constexpr size_t      BLOCK_SIZE   = 256;
+    static constexpr size_t      FRAMES_TOTAL = 48000 * 10;
+    static constexpr double      UP[]         = {44100.0, 48000.0};
+    static constexpr double      DOWN[]       = {48000.0, 44100.0};
+
+    benchmark_results.clear();
+    benchmark_results.emplace_back("SNR 1kHz / 10kHz ( 44.1kHz → 48kHz ), THROUGHPUT up / down in frames per second");
+
+    char result[160];
+    snprintf(result, sizeof(result), "LINEAR : SNR %6.1fdB / %6.1fdB",
+             measure_snr(resample_linear, 1000.0f, UP[0], UP[1]),
+             measure_snr(resample_linear, 10000.0f, UP[0], UP[1]));
+    benchmark_results.emplace_back(result);
+    console(benchmark_results.back());
+
+    std::vector<float> input(Resampler::INPUT_BLOCK);
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = std::sin(TWO_PI * 440.0f * i / UP[0]);
+    }
+    std::vector<float> output(BLOCK_SIZE);
+
+    for (int q = Resampler::LOW; q <= Resampler::HIGH; ++q) {
+        const auto tier     = static_cast<Resampler::Quality>(q);
+        const auto resample = [tier](const std::vector<float>& in, const double from, const double to) {
+            return Resampler::resample(in.data(), in.size(), from, to, tier);
+        };
+        const float snr_low  = measure_snr(resample, 1000.0f, UP[0], UP[1]);
+        const float snr_high = measure_snr(resample, 10000.0f, UP[0], UP[1]);
+
+        float throughput[2];
+        for (int direction = 0; direction < 2; ++direction) {
+            Resampler resampler(tier);
+            resampler.set_rates(direction == 0 ? UP[0] : DOWN[0], direction == 0 ? UP[1] : DOWN[1]);
+            const auto start = std::chrono::high_resolution_clock::now();
+            for (size_t i = 0; i < FRAMES_TOTAL; i += BLOCK_SIZE) {
+                resampler.process(output.data(), BLOCK_SIZE, [&](float* buffer, const size_t frames) {
+                    std::copy_n(input.data(), frames, buffer);
+                });
+            }
+            const float seconds   = std::chrono::duration<float>(std::chrono::high_resolution_clock::now() - start).count();
+            throughput[direction] = FRAMES_TOTAL / seconds;
+        }
+        snprintf(result, sizeof(result), "%s : SNR %6.1fdB / %6.1fdB   %5.1fM / %5.1fM frames/s ( %zu taps )",
+                 NAMES[q], snr_low, snr_high, throughput[0] / 1000000.0f, throughput[1] / 1000000.0f, resamplers[q]->get_taps());
+        benchmark_results.emplace_back(result);
+        console(benchmark_results.back());
+    }
+}
+
+void setup() {
+    if (get_audio_output_channels() != 2) {
+        error("this example requires a stereo output");
+        exit(1);
+    }
+
+    sample_source = loadSample("teilchen.wav");
+    resamplers[0] = new Resampler(Resampler::LOW);
+    resamplers[1] = new Resampler(Resampler::MEDIUM);
+    resamplers[2] = new Resampler(Resampler::HIGH);
+
+    run_benchmark();
+}
+
+void draw() {
+    background(0.85f);
+
+    playback_rate = map(mouseX, 0, width, 0.5f, 2.0f);
+
+    noFill();
+    stroke(1.0f, 0.25f, 0.35f);
+    strokeWeight(16.0f);
+    arc(width / 2.0f, height / 2.0f, height / 2.0f, height / 2.0f, -HALF_PI, TWO_PI * playback_position - HALF_PI);
+
+    static constexpr const char* NAMES[] = {"LOW", "MEDIUM", "HIGH"};
+    fill(0);
+    debug_text("PLAYBACK RATE : " + nf(playback_rate, 2), 10, 10);
+    debug_text("SAMPLE RATE   : " + to_string(static_cast<int>(sample_source->get_sample_rate())) + "Hz → " + to_string(get_audio_sample_rate()) + "Hz", 10, 25);
+    debug_text("QUALITY       : " + std::string(NAMES[quality]), 10, 40);
+    for (size_t i = 0; i < benchmark_results.size(); ++i) {
+        debug_text(benchmark_results[i], 10, 70 + i * 15);
+    }
+}
+
+void keyPressed() {
+    if (key == '1') {
+        quality = Resampler::LOW;
+    }
+    if (key == '2') {
+        quality = Resampler::MEDIUM;
+    }
+    if (key == '3') {
+        quality = Resampler::HIGH;
+    }
+    if (key == 'b') {
+        run_benchmark();
+    }
+}
+
+void audioEvent(const PAudio& audio) {
+    if (quality != current_quality) {
+        current_quality = quality;
+        resamplers[current_quality]->reset();
+    }
+    Resampler* resampler = resamplers[current_quality];
+    /* playing a sample faster is the same as pretending it has a higher sample rate */
+    resampler->set_rates(sample_source->get_sample_rate() * playback_rate, get_audio_sample_rate());
+
+    const float* buffer = sample_source->get_buffer();
+    const size_t length = sample_source->get_buffer_length();
+
+    float sample_buffer[audio.buffer_size];
+    resampler->process(sample_buffer, audio.buffer_size, [&](float* input, const size_t frames) {
+        /* loop the sample */
+        for (size_t i = 0; i < frames; ++i) {
+            input[i]      = buffer[read_position];
+            read_position = (read_position + 1) % length;
+        }
+    });
+    playback_position = static_cast<float>(read_position) / length;
+    if (audio.output_channels == 2) {
+        merge_interleaved_stereo(sample_buffer, sample_buffer, audio.output_buffer, audio.buffer_size);
+    }
+}
+
+void shutdown() {
+    delete sample_source;
+    for (const auto* resampler: resamplers) {
+        delete resampler;
+    }
+}
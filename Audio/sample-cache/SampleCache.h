@@ -0,0 +1,485 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "WAVReader.h"
+
+/**
+ * decoded sample data shared by all users of the same content. the samples are interleaved
+ * float and either memory-mapped from the disk cache ( read-only, i.e. shared with the page
+ * cache ) or held in memory. instances are only created by `SampleCache`.
+ */
+class SampleData {
+public:
+    ~SampleData() {
+#if !defined(_WIN32)
+        if (fMapping != nullptr) {
+            munmap(fMapping, fMappingSize);
+        }
+#endif
+    }
+
+    SampleData(const SampleData&)            = delete;
+    SampleData& operator=(const SampleData&) = delete;
+
+    const float* get_samples() const { return fSamples; }
+    uint32_t     get_channels() const { return fChannels; }
+    uint32_t     get_sample_rate() const { return fSampleRate; }
+    uint64_t     get_frames() const { return fFrames; }
+    uint64_t     get_hash() const { return fHash; }
+    bool         is_memory_mapped() const { return fMapping != nullptr; }
+
+private:
+    friend class SampleCache;
+
+    SampleData() = default;
+
+    const float*       fSamples{nullptr};
+    uint32_t           fChannels{0};
+    uint32_t           fSampleRate{0};
+    uint64_t           fFrames{0};
+    uint64_t           fHash{0};
+    void*              fMapping{nullptr};
+    size_t             fMappingSize{0};
+    std::vector<float> fStorage;
+};
+
+using SharedSampleData = std::shared_ptr<const SampleData>;
+
+/**
+ * loads samples once and shares them. samples are identified by a hash of their content, so
+ * the same sample loaded from different paths ( or by many samplers ) is decoded and held in
+ * memory only once. the data is reference-counted with `std::shared_ptr` and released when
+ * the last user lets go of it.
+ *
+ * decoded samples are stored in `cache_directory` as raw float PCM behind a small header
+ * ( one file per content hash ). later loads, also in later runs of the application, map
+ * these files into memory instead of decoding again. `load_all()` hashes and decodes files in
+ * parallel on `threads` threads ( default: one per core ).
+ *
+ * a file is only read to compute its content hash the first time it is seen. the hash is
+ * stored in an index in `cache_directory` under the path, size and modification time of the
+ * file, so that later loads of an unchanged file only need to query its size and time.
+ *
+ *     file → path, size, time in index? → content hash → in memory?      → shared data
+ *          → hash content, add to index →              → in disk cache?  → map file
+ *                                                      → decode WAV → write cache file → map file
+ *
+ * loading may be called from several threads. NOTE if two threads load the same new content
+ * at the same time it is decoded twice, but only one copy is kept.
+ */
+class SampleCache {
+public:
+    struct Statistics {
+        uint32_t requests{0};
+        uint32_t memory_hits{0};
+        uint32_t disk_hits{0};
+        uint32_t decoded{0};
+        uint32_t failed{0};
+        uint32_t hashed{0}; // files that were not in the index and had to be read to compute their hash
+    };
+
+    explicit SampleCache(const std::string& cache_directory) : fDirectory(cache_directory) {
+        std::error_code error;
+        std::filesystem::create_directories(fDirectory, error);
+        read_index();
+    }
+
+    /* returns the data of `path` or `nullptr` if the file can not be loaded */
+    SharedSampleData load(const std::string& path) { return load_all({path}, 1).front(); }
+
+    /* loads all `paths` in parallel. the result has one entry per path ( `nullptr` if the file can not be loaded ) */
+    std::vector<SharedSampleData> load_all(const std::vector<std::string>& paths, unsigned threads = 0) {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        /* look up the content hash of every distinct path once */
+        std::vector<std::string>                unique_paths;
+        std::unordered_map<std::string, size_t> path_index;
+        for (const auto& path: paths) {
+            if (path_index.emplace(path, unique_paths.size()).second) {
+                unique_paths.push_back(path);
+            }
+        }
+        std::vector<uint64_t>    hashes(unique_paths.size());
+        std::vector<char>        readable(unique_paths.size());
+        std::vector<char>        indexed(unique_paths.size());
+        std::vector<std::string> keys(unique_paths.size());
+        {
+            std::lock_guard<std::mutex> lock(fMutex);
+            for (size_t i = 0; i < unique_paths.size(); ++i) {
+                if (!file_key(unique_paths[i], keys[i])) {
+                    continue;
+                }
+                const auto entry = fIndex.find(keys[i]);
+                if (entry != fIndex.end()) {
+                    hashes[i]   = entry->second;
+                    readable[i] = true;
+                    indexed[i]  = true;
+                }
+            }
+        }
+        /* only files that are new or changed are read */
+        parallel_for(unique_paths.size(), threads, [&](const size_t i) {
+            if (!indexed[i] && !keys[i].empty()) {
+                readable[i] = hash_file(unique_paths[i], hashes[i]);
+            }
+        });
+
+        /* collect content that is not in memory yet */
+        std::unordered_map<uint64_t, SharedSampleData> resolved;
+        std::vector<size_t>                            missing; // index into `unique_paths`
+        {
+            std::lock_guard<std::mutex> lock(fMutex);
+            fStatistics.requests += static_cast<uint32_t>(paths.size());
+            std::ofstream index_file;
+            for (size_t i = 0; i < unique_paths.size(); ++i) {
+                if (readable[i] && !indexed[i]) {
+                    fIndex[keys[i]] = hashes[i];
+                    fStatistics.hashed++;
+                    if (!index_file.is_open()) {
+                        index_file.open(index_path(), std::ios::app);
+                    }
+                    index_file << to_hex(hashes[i]) << ' ' << keys[i] << '\n';
+                }
+            }
+            for (size_t i = 0; i < unique_paths.size(); ++i) {
+                if (!readable[i] || resolved.count(hashes[i]) > 0) {
+                    continue;
+                }
+                const auto entry = fEntries.find(hashes[i]);
+                if (entry != fEntries.end()) {
+                    if (SharedSampleData data = entry->second.lock()) {
+                        resolved.emplace(hashes[i], std::move(data));
+                        continue;
+                    }
+                }
+                resolved.emplace(hashes[i], nullptr);
+                missing.push_back(i);
+            }
+        }
+
+        /* map from the disk cache or decode */
+        std::vector<SharedSampleData> loaded(missing.size());
+        std::vector<char>             from_disk(missing.size());
+        parallel_for(missing.size(), threads, [&](const size_t i) {
+            const uint64_t hash = hashes[missing[i]];
+            loaded[i]           = map_cache_file(hash);
+            from_disk[i]        = loaded[i] != nullptr;
+            if (loaded[i] == nullptr) {
+                loaded[i] = decode(unique_paths[missing[i]], hash);
+            }
+        });
+
+        {
+            std::lock_guard<std::mutex> lock(fMutex);
+            uint32_t                    loaded_from_file = 0;
+            for (size_t i = 0; i < missing.size(); ++i) {
+                const uint64_t hash = hashes[missing[i]];
+                if (loaded[i] == nullptr) {
+                    continue;
+                }
+                /* keep the copy of a concurrent `load_all()` if there is one */
+                SharedSampleData& entry = resolved[hash];
+                if (SharedSampleData existing = fEntries[hash].lock()) {
+                    entry = std::move(existing);
+                } else {
+                    entry          = loaded[i];
+                    fEntries[hash] = loaded[i];
+                }
+                if (from_disk[i]) {
+                    fStatistics.disk_hits++;
+                } else {
+                    fStatistics.decoded++;
+                }
+                ++loaded_from_file;
+            }
+            /* every other request is served from memory */
+            std::vector<SharedSampleData> result(paths.size());
+            uint32_t                      served = 0;
+            for (size_t i = 0; i < paths.size(); ++i) {
+                const size_t index = path_index[paths[i]];
+                if (readable[index]) {
+                    result[i] = resolved[hashes[index]];
+                }
+                if (result[i] == nullptr) {
+                    fStatistics.failed++;
+                } else {
+                    ++served;
+                }
+            }
+            fStatistics.memory_hits += served - loaded_from_file;
+            return result;
+        }
+    }
+
+    /* number of distinct samples that are currently in use */
+    size_t get_resident_samples() {
+        std::lock_guard<std::mutex> lock(fMutex);
+        size_t                      count = 0;
+        for (auto it = fEntries.begin(); it != fEntries.end();) {
+            if (it->second.expired()) {
+                it = fEntries.erase(it);
+            } else {
+                ++count;
+                ++it;
+            }
+        }
+        return count;
+    }
+
+    Statistics get_statistics() {
+        std::lock_guard<std::mutex> lock(fMutex);
+        return fStatistics;
+    }
+
+    void reset_statistics() {
+        std::lock_guard<std::mutex> lock(fMutex);
+        fStatistics = {};
+    }
+
+    /* deletes all cache files. samples in use stay valid */
+    void clear_disk_cache() {
+        std::error_code error;
+        for (const auto& file: std::filesystem::directory_iterator(fDirectory, error)) {
+            if (file.path().extension() == EXTENSION) {
+                std::filesystem::remove(file.path(), error);
+            }
+        }
+    }
+
+    const std::string& get_directory() const { return fDirectory; }
+
+    /* index key of a file: its size, modification time and path. NOTE the path is last because it may contain spaces */
+    static bool file_key(const std::string& path, std::string& key) {
+        std::error_code error;
+        const uint64_t  size = std::filesystem::file_size(path, error);
+        if (error) {
+            return false;
+        }
+        const auto modified = std::filesystem::last_write_time(path, error);
+        if (error) {
+            return false;
+        }
+        key = std::to_string(size) + ' ' + std::to_string(modified.time_since_epoch().count()) + ' ' + path;
+        return true;
+    }
+
+    /* 64 bit FNV-1a hash of the file content */
+    static bool hash_file(const std::string& path, uint64_t& hash) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.good()) {
+            return false;
+        }
+        hash = 0xcbf29ce484222325ull;
+        char buffer[65536];
+        while (file) {
+            file.read(buffer, sizeof(buffer));
+            const std::streamsize n = file.gcount();
+            for (std::streamsize i = 0; i < n; ++i) {
+                hash = (hash ^ static_cast<uint8_t>(buffer[i])) * 0x100000001b3ull;
+            }
+        }
+        return true;
+    }
+
+private:
+    static constexpr char     MAGIC[8]    = {'U', 'M', 'F', 'P', 'C', 'M', '0', '1'};
+    static constexpr size_t   HEADER_SIZE = 64; // keeps the samples aligned for SIMD loads
+    static constexpr char     EXTENSION[] = ".pcm";
+    static constexpr char     INDEX[]     = "index.txt";
+    static constexpr uint32_t READ_FRAMES = 65536;
+
+    struct Header {
+        char     magic[8];
+        uint64_t hash;
+        uint64_t frames;
+        uint32_t channels;
+        uint32_t sample_rate;
+    };
+
+    const std::string                                             fDirectory;
+    std::mutex                                                    fMutex;
+    std::unordered_map<uint64_t, std::weak_ptr<const SampleData>> fEntries;
+    std::unordered_map<std::string, uint64_t>                     fIndex; // file key ( see `file_key()` ) → content hash
+    Statistics                                                    fStatistics;
+
+    template<typename F>
+    static void parallel_for(const size_t count, const unsigned threads, F&& function) {
+        const size_t        workers = std::min<size_t>(threads, count);
+        std::atomic<size_t> next{0};
+        auto                run = [&]() {
+            for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+                function(i);
+            }
+        };
+        std::vector<std::thread> pool;
+        for (size_t i = 1; i < workers; ++i) {
+            pool.emplace_back(run);
+        }
+        run();
+        for (auto& thread: pool) {
+            thread.join();
+        }
+    }
+
+    static std::string to_hex(const uint64_t hash) {
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash));
+        return name;
+    }
+
+    std::string cache_path(const uint64_t hash) const {
+        return (std::filesystem::path(fDirectory) / (to_hex(hash) + EXTENSION)).string();
+    }
+
+    std::string index_path() const { return (std::filesystem::path(fDirectory) / INDEX).string(); }
+
+    /* one line per file: `<content hash> <size> <modification time> <path>`. later lines replace earlier ones */
+    void read_index() {
+        std::ifstream file(index_path());
+        std::string   line;
+        while (std::getline(file, line)) {
+            if (line.size() < 18 || line[16] != ' ') {
+                continue;
+            }
+            char*          end  = nullptr;
+            const uint64_t hash = std::strtoull(line.c_str(), &end, 16);
+            if (end != line.c_str() + 16) {
+                continue;
+            }
+            fIndex[line.substr(17)] = hash;
+        }
+    }
+
+    std::shared_ptr<SampleData> decode(const std::string& path, const uint64_t hash) const {
+        WAVReader reader;
+        if (!reader.open(path)) {
+            return nullptr;
+        }
+        auto data         = std::shared_ptr<SampleData>(new SampleData());
+        data->fChannels   = reader.get_channels();
+        data->fSampleRate = reader.get_sample_rate();
+        data->fFrames     = reader.get_total_frames();
+        data->fHash       = hash;
+        data->fStorage.resize(data->fFrames * data->fChannels);
+        uint64_t position = 0;
+        while (position < data->fFrames) {
+            const size_t n = reader.read(data->fStorage.data() + position * data->fChannels, READ_FRAMES);
+            if (n == 0) {
+                break;
+            }
+            position += n;
+        }
+        data->fFrames  = position;
+        data->fSamples = data->fStorage.data();
+
+        if (write_cache_file(*data)) {
+            /* prefer the mapped file, the decoded copy is released here */
+            if (auto mapped = map_cache_file(hash)) {
+                return mapped;
+            }
+        }
+        return data;
+    }
+
+    /* writes to a temporary file first so that no other process ever sees a partial file */
+    bool write_cache_file(const SampleData& data) const {
+        const std::string path      = cache_path(data.fHash);
+        const std::string temporary = path + ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+        FILE*             file      = std::fopen(temporary.c_str(), "wb");
+        if (file == nullptr) {
+            return false;
+        }
+        char   header[HEADER_SIZE] = {};
+        Header h{};
+        std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+        h.hash        = data.fHash;
+        h.frames      = data.fFrames;
+        h.channels    = data.fChannels;
+        h.sample_rate = data.fSampleRate;
+        std::memcpy(header, &h, sizeof(h));
+        const size_t samples = data.fFrames * data.fChannels;
+        bool         success = std::fwrite(header, 1, HEADER_SIZE, file) == HEADER_SIZE;
+        success              = success && std::fwrite(data.fSamples, sizeof(float), samples, file) == samples;
+        success              = std::fclose(file) == 0 && success;
+        std::error_code error;
+        if (success) {
+            std::filesystem::rename(temporary, path, error);
+        }
+        if (!success || error) {
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+        return true;
+    }
+
+    /* returns `nullptr` if there is no valid cache file for `hash` */
+    std::shared_ptr<SampleData> map_cache_file(const uint64_t hash) const {
+        const std::string path = cache_path(hash);
+        std::error_code   error;
+        const uint64_t    size = std::filesystem::file_size(path, error);
+        if (error || size < HEADER_SIZE) {
+            return nullptr;
+        }
+        Header h{};
+        {
+            std::ifstream file(path, std::ios::binary);
+            file.read(reinterpret_cast<char*>(&h), sizeof(h));
+            if (!file || std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0 || h.hash != hash || h.channels == 0 ||
+                size != HEADER_SIZE + h.frames * h.channels * sizeof(float)) {
+                return nullptr;
+            }
+        }
+
+        auto data         = std::shared_ptr<SampleData>(new SampleData());
+        data->fChannels   = h.channels;
+        data->fSampleRate = h.sample_rate;
+        data->fFrames     = h.frames;
+        data->fHash       = hash;
+#if !defined(_WIN32)
+        const int descriptor = open(path.c_str(), O_RDONLY);
+        if (descriptor < 0) {
+            return nullptr;
+        }
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        close(descriptor);
+        if (mapping == MAP_FAILED) {
+            return nullptr;
+        }
+        data->fMapping     = mapping;
+        data->fMappingSize = size;
+        data->fSamples     = reinterpret_cast<const float*>(static_cast<const char*>(mapping) + HEADER_SIZE);
+#else
+        /* NOTE no memory mapping on windows, the file is read instead */
+        std::ifstream file(path, std::ios::binary);
+        file.seekg(HEADER_SIZE);
+        data->fStorage.resize(h.frames * h.channels);
+        if (!file.read(reinterpret_cast<char*>(data->fStorage.data()), static_cast<std::streamsize>(data->fStorage.size() * sizeof(float)))) {
+            return nullptr;
+        }
+        data->fSamples = data->fStorage.data();
+#endif
+        return data;
+    }
+};
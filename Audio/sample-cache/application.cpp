@@ -0,0 +1,161 @@
+/*
+ * this example demonstrates how to load many samples quickly with a `SampleCache`. 256
+ * sample players are created from 3 files. the cache hashes the files ( only once, unchanged
+ * files are found in its index by path, size and modification time ), decodes each distinct
+ * file only once ( in parallel on all cores ) and shares the decoded data between all
+ * players via reference counting. the decoded data is also written to `cache/` in the
+ * sketch folder. on the next start the files are memory-mapped from there instead of being
+ * decoded again.
+ *
+ * click to play the sample of the player under the mouse. press `r` to release and reload
+ * all samples ( from the disk cache ), press `c` to clear the disk cache and reload ( i.e.
+ * decode again ).
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "Umfeld.h"
+
+#include "SampleCache.h"
+
+using namespace umfeld;
+
+static constexpr size_t NUMBER_OF_PLAYERS = 256;
+
+struct SamplePlayer {
+    SharedSampleData sample;
+    uint64_t         position{0};
+    bool             playing{false};
+};
+
+SampleCache*              cache;
+std::vector<SamplePlayer> players(NUMBER_OF_PLAYERS);
+float                     load_duration_ms = 0.0f;
+
+void load_samples() {
+    static const char* FILES[] = {"teilchen.wav", "teilchen-stereo.wav", "impulse-response.wav"};
+
+    /* release the old data first so that the cache can not serve it from memory */
+    for (auto& player: players) {
+        player = SamplePlayer{};
+    }
+
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < NUMBER_OF_PLAYERS; ++i) {
+        paths.push_back(sketchPath() + "data/" + FILES[i % 3]);
+    }
+    cache->reset_statistics();
+    const auto                    start   = std::chrono::high_resolution_clock::now();
+    std::vector<SharedSampleData> samples = cache->load_all(paths);
+    const auto                    end     = std::chrono::high_resolution_clock::now();
+    load_duration_ms                      = std::chrono::duration<float, std::milli>(end - start).count();
+
+    for (size_t i = 0; i < NUMBER_OF_PLAYERS; ++i) {
+        if (samples[i] == nullptr) {
+            error("could not load: " + paths[i]);
+        }
+        players[i].sample = samples[i];
+    }
+    console("loaded ", NUMBER_OF_PLAYERS, " samples in ", load_duration_ms, "ms");
+}
+
+void settings() {
+    size(1024, 768);
+    audio();
+}
+
+void setup() {
+    cache = new SampleCache(sketchPath() + "cache");
+    load_samples();
+}
+
+void draw() {
+    background(0.85f);
+
+    /* one cell per player. filled while playing */
+    const size_t columns = 32;
+    const float  cell    = static_cast<float>(width) / columns;
+    for (size_t i = 0; i < NUMBER_OF_PLAYERS; ++i) {
+        const float x = (i % columns) * cell;
+        const float y = 100.0f + (i / columns) * cell;
+        if (players[i].playing) {
+            noStroke();
+            fill(1.0f, 0.25f, 0.35f);
+        } else {
+            noFill();
+            stroke(1.0f, 0.25f, 0.35f);
+        }
+        rect(x + 2, y + 2, cell - 4, cell - 4);
+    }
+
+    const SampleCache::Statistics statistics = cache->get_statistics();
+    fill(0);
+    char info[256];
+    snprintf(info, sizeof(info), "%zu PLAYERS / %zu SAMPLES IN MEMORY / LOADED IN %.2fms", NUMBER_OF_PLAYERS, cache->get_resident_samples(), load_duration_ms);
+    debug_text(info, 10, 10);
+    snprintf(info, sizeof(info), "MEMORY HITS %u / DISK CACHE HITS %u / DECODED %u / FAILED %u / HASHED %u",
+             statistics.memory_hits, statistics.disk_hits, statistics.decoded, statistics.failed, statistics.hashed);
+    debug_text(info, 10, 25);
+    if (players[0].sample != nullptr) {
+        snprintf(info, sizeof(info), "PLAYER 0: %llu FRAMES x %u CH / %s / SHARED BY %ld PLAYERS",
+                 static_cast<unsigned long long>(players[0].sample->get_frames()),
+                 players[0].sample->get_channels(),
+                 players[0].sample->is_memory_mapped() ? "MEMORY-MAPPED" : "IN MEMORY",
+                 players[0].sample.use_count());
+        debug_text(info, 10, 40);
+    }
+}
+
+void mousePressed() {
+    const size_t columns = 32;
+    const float  cell    = static_cast<float>(width) / columns;
+    const int    column  = static_cast<int>(mouseX / cell);
+    const int    row     = static_cast<int>((mouseY - 100.0f) / cell);
+    const size_t index   = row * columns + column;
+    if (mouseY >= 100.0f && index < NUMBER_OF_PLAYERS) {
+        players[index].position = 0;
+        players[index].playing  = true;
+    }
+}
+
+void keyPressed() {
+    // NOTE reloading replaces the data of the players. this is fine as long as `run_audio_in_thread` is not set
+    if (key == 'r') {
+        load_samples();
+    }
+    if (key == 'c') {
+        cache->clear_disk_cache();
+        load_samples();
+    }
+}
+
+void audioEvent(const PAudio& audio) {
+    float sample_buffer[audio.buffer_size];
+    std::fill_n(sample_buffer, audio.buffer_size, 0.0f);
+    for (auto& player: players) {
+        if (!player.playing || player.sample == nullptr) {
+            continue;
+        }
+        /* the first channel of each sample */
+        const float*   samples  = player.sample->get_samples();
+        const uint32_t channels = player.sample->get_channels();
+        const uint64_t frames   = player.sample->get_frames();
+        for (int i = 0; i < audio.buffer_size && player.position < frames; i++) {
+            sample_buffer[i] += samples[player.position * channels] * 0.5f;
+            ++player.position;
+        }
+        player.playing = player.position < frames;
+    }
+    for (int i = 0; i < audio.buffer_size; i++) {
+        for (int j = 0; j < audio.output_channels; j++) {
+            audio.output_buffer[i * audio.output_channels + j] = sample_buffer[i];
+        }
+    }
+}
+
+void shutdown() {
+    players.clear();
+    delete cache;
+}
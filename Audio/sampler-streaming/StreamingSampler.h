@@ -0,0 +1,263 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SPSCQueue.h"
+#include "WAVReader.h"
+
+/**
+ * plays back WAV files of any length without loading them into memory. the first
+ * `head_frames` frames are preloaded so that playback can start ( and restart ) immediately.
+ * the rest of the file is read by a background thread in chunks of `chunk_frames` frames and
+ * passed to the audio thread through a pool of `number_of_chunks` preallocated chunks:
+ *
+ *     reader thread → filled queue → audio thread → free queue → reader thread
+ *
+ * both queues are lock-free, so the audio thread never blocks on I/O. memory use is bounded
+ * by `( head_frames + number_of_chunks * chunk_frames ) * channels * sizeof(float)`. the
+ * reader stays up to `number_of_chunks * chunk_frames` frames ahead of playback; if it falls
+ * behind ( e.g. slow disk ) the sampler outputs silence and counts an underrun.
+ *
+ * `seek()` may be called from any thread. it increments a generation counter; the reader
+ * restarts at the new position and the audio thread discards chunks of older generations.
+ *
+ * output is interleaved with `get_channels()` channels.
+ */
+class StreamingSampler {
+public:
+    static constexpr size_t MAX_CHUNKS = 256;
+
+    struct Settings {
+        size_t head_frames      = 48000;
+        size_t chunk_frames     = 4096;
+        size_t number_of_chunks = 16;
+    };
+
+    StreamingSampler() : StreamingSampler(Settings{}) {}
+
+    explicit StreamingSampler(const Settings& settings) : fSettings(settings) {
+        fSettings.number_of_chunks = std::clamp<size_t>(fSettings.number_of_chunks, 2, MAX_CHUNKS - 1);
+        fSettings.chunk_frames     = std::max<size_t>(fSettings.chunk_frames, 1);
+    }
+
+    ~StreamingSampler() { close(); }
+
+    StreamingSampler(const StreamingSampler&)            = delete;
+    StreamingSampler& operator=(const StreamingSampler&) = delete;
+
+    /* opens `path`, preloads the head and starts the reader thread. blocks while the head is read */
+    bool load(const std::string& path) {
+        close();
+        if (!fReader.open(path)) {
+            return false;
+        }
+        fChannels    = fReader.get_channels();
+        fTotalFrames = fReader.get_total_frames();
+        fHeadFrames  = static_cast<size_t>(std::min<uint64_t>(fSettings.head_frames, fTotalFrames));
+
+        fHead.assign(fHeadFrames * fChannels, 0.0f);
+        fReader.read(fHead.data(), fHeadFrames);
+
+        fChunks.resize(fSettings.number_of_chunks);
+        for (auto& chunk: fChunks) {
+            chunk.data.assign(fSettings.chunk_frames * fChannels, 0.0f);
+            fFreeChunks.push(&chunk);
+        }
+
+        fRunning.store(true);
+        fReaderThread = std::thread(&StreamingSampler::reader_loop, this);
+        return true;
+    }
+
+    /* NOTE do not call this while `process()` is running */
+    void close() {
+        fRunning.store(false);
+        if (fReaderThread.joinable()) {
+            fReaderThread.join();
+        }
+        Chunk* chunk;
+        while (fFilledChunks.pop(chunk)) {}
+        while (fFreeChunks.pop(chunk)) {}
+        fCurrentChunk = nullptr;
+        fChunks.clear();
+        fHead.clear();
+        fReader.close();
+        fTotalFrames = 0;
+        fHeadFrames  = 0;
+        fGeneration  = 0;
+        fPosition    = 0;
+        fSeekGeneration.store(0);
+        fSeekTarget.store(0);
+        fDisplayPosition.store(0);
+    }
+
+    /* any thread */
+    void play() { fPlaying.store(true); }
+    void stop() { fPlaying.store(false); }
+    void rewind() { seek(0); }
+    void set_looping(const bool looping = true) { fLooping.store(looping); }
+    bool is_playing() const { return fPlaying.load(); }
+
+    /* any thread. jumps to `frame` at the beginning of the next block */
+    void seek(const uint64_t frame) {
+        fSeekTarget.store(std::min(frame, fTotalFrames));
+        fSeekGeneration.fetch_add(1, std::memory_order_release);
+    }
+
+    void seek_normalized(const float position) { seek(static_cast<uint64_t>(std::clamp(position, 0.0f, 1.0f) * static_cast<float>(fTotalFrames))); }
+
+    float get_position_normalized() const {
+        return fTotalFrames > 0 ? static_cast<float>(fDisplayPosition.load(std::memory_order_relaxed)) / static_cast<float>(fTotalFrames) : 0.0f;
+    }
+
+    uint32_t get_channels() const { return fChannels; }
+    uint32_t get_sample_rate() const { return fReader.get_sample_rate(); }
+    uint64_t get_total_frames() const { return fTotalFrames; }
+    uint32_t get_underruns() const { return fUnderruns.load(std::memory_order_relaxed); }
+    size_t   get_buffered_chunks() const { return fFilledChunks.size(); }
+    size_t   get_number_of_chunks() const { return fSettings.number_of_chunks; }
+
+    size_t get_memory_budget() const {
+        return (fHeadFrames + fSettings.number_of_chunks * fSettings.chunk_frames) * fChannels * sizeof(float);
+    }
+
+    /* audio thread. writes `frames` interleaved frames into `output` */
+    void process(float* output, const size_t frames) {
+        const uint32_t generation = fSeekGeneration.load(std::memory_order_acquire);
+        if (generation != fGeneration) {
+            fGeneration = generation;
+            fPosition   = fSeekTarget.load();
+            release_current_chunk();
+        }
+        size_t written = 0;
+        if (fPlaying.load(std::memory_order_relaxed) && fTotalFrames > 0) {
+            while (written < frames) {
+                if (fPosition >= fTotalFrames) {
+                    if (!fLooping.load(std::memory_order_relaxed)) {
+                        fPlaying.store(false);
+                        break;
+                    }
+                    fPosition = 0;
+                }
+                const size_t n = fPosition < fHeadFrames ? read_head(output + written * fChannels, frames - written)
+                                                         : read_stream(output + written * fChannels, frames - written);
+                if (n == 0) {
+                    fUnderruns.fetch_add(1, std::memory_order_relaxed);
+                    break;
+                }
+                written += n;
+            }
+        }
+        std::fill(output + written * fChannels, output + frames * fChannels, 0.0f);
+        fDisplayPosition.store(fPosition, std::memory_order_relaxed);
+    }
+
+private:
+    struct Chunk {
+        std::vector<float> data;
+        uint64_t           start{0};
+        size_t             frames{0};
+        uint32_t           generation{0};
+    };
+
+    Settings                           fSettings;
+    WAVReader                          fReader;
+    uint32_t                           fChannels{1};
+    uint64_t                           fTotalFrames{0};
+    size_t                             fHeadFrames{0};
+    std::vector<float>                 fHead;
+    std::vector<Chunk>                 fChunks;
+    SPSCQueue<Chunk*, MAX_CHUNKS>      fFilledChunks;
+    SPSCQueue<Chunk*, MAX_CHUNKS>      fFreeChunks;
+    std::thread                        fReaderThread;
+    std::atomic<bool>                  fRunning{false};
+    std::atomic<bool>                  fPlaying{false};
+    std::atomic<bool>                  fLooping{false};
+    std::atomic<uint64_t>              fSeekTarget{0};
+    std::atomic<uint32_t>              fSeekGeneration{0};
+    std::atomic<uint64_t>              fDisplayPosition{0};
+    std::atomic<uint32_t>              fUnderruns{0};
+    /* audio thread only */
+    uint32_t                           fGeneration{0};
+    uint64_t                           fPosition{0};
+    Chunk*                             fCurrentChunk{nullptr};
+
+    size_t read_head(float* output, const size_t frames) {
+        const size_t n = std::min<size_t>(frames, fHeadFrames - fPosition);
+        std::copy_n(fHead.data() + fPosition * fChannels, n * fChannels, output);
+        fPosition += n;
+        return n;
+    }
+
+    size_t read_stream(float* output, const size_t frames) {
+        /* skip chunks from older generations or chunks that do not contain the current position */
+        while (fCurrentChunk == nullptr ||
+               fCurrentChunk->generation != fGeneration ||
+               fPosition < fCurrentChunk->start ||
+               fPosition >= fCurrentChunk->start + fCurrentChunk->frames) {
+            release_current_chunk();
+            if (!fFilledChunks.pop(fCurrentChunk)) {
+                fCurrentChunk = nullptr;
+                return 0;
+            }
+        }
+        const size_t offset = static_cast<size_t>(fPosition - fCurrentChunk->start);
+        const size_t n      = std::min(frames, fCurrentChunk->frames - offset);
+        std::copy_n(fCurrentChunk->data.data() + offset * fChannels, n * fChannels, output);
+        fPosition += n;
+        return n;
+    }
+
+    void release_current_chunk() {
+        if (fCurrentChunk != nullptr) {
+            fFreeChunks.push(fCurrentChunk);
+            fCurrentChunk = nullptr;
+        }
+    }
+
+    void reader_loop() {
+        const auto chunk_period  = std::chrono::microseconds(1000000 * fSettings.chunk_frames / std::max(1u, get_sample_rate()));
+        uint32_t   generation    = fSeekGeneration.load(std::memory_order_acquire);
+        uint64_t   read_position = fHeadFrames;
+        bool       reached_end   = false;
+        fReader.seek(read_position);
+        while (fRunning.load()) {
+            const uint32_t current_generation = fSeekGeneration.load(std::memory_order_acquire);
+            if (current_generation != generation) {
+                /* restart behind the head if the new position is inside the head */
+                generation    = current_generation;
+                read_position = std::max<uint64_t>(fSeekTarget.load(), fHeadFrames);
+                reached_end   = false;
+                fReader.seek(read_position);
+            }
+            if (reached_end) {
+                if (!fLooping.load() || fHeadFrames >= fTotalFrames) {
+                    std::this_thread::sleep_for(chunk_period / 4);
+                    continue;
+                }
+                /* the audio thread plays the head from memory after a loop, so continue right after it */
+                read_position = fHeadFrames;
+                reached_end   = false;
+                fReader.seek(read_position);
+            }
+            Chunk* chunk;
+            if (!fFreeChunks.pop(chunk)) {
+                std::this_thread::sleep_for(chunk_period / 4);
+                continue;
+            }
+            chunk->start      = read_position;
+            chunk->frames     = fReader.read(chunk->data.data(), fSettings.chunk_frames);
+            chunk->generation = generation;
+            read_position += chunk->frames;
+            reached_end = chunk->frames == 0 || read_position >= fTotalFrames;
+            /* NOTE empty chunks are passed on as well, the audio thread is the only one to return chunks to the free queue */
+            fFilledChunks.push(chunk);
+        }
+    }
+};
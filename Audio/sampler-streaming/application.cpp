@@ -0,0 +1,98 @@
+/*
+ * this example demonstrates how to play back long samples without loading them into memory.
+ * `StreamingSampler` preloads the beginning of a WAV file and reads the rest from disk in a
+ * background thread. only a small, fixed amount of memory is used regardless of the length
+ * of the file. click into the window to jump to a position, press `1` to restart playback
+ * and `2` to stop it.
+ */
+
+#include <vector>
+
+#include "Umfeld.h"
+
+#include "StreamingSampler.h"
+
+using namespace umfeld;
+
+StreamingSampler*  sampler;
+std::vector<float> sampler_buffer;
+
+void settings() {
+    size(1024, 768);
+    audio();
+}
+
+void setup() {
+    if (get_audio_output_channels() != 2) {
+        error("this example requires a stereo output");
+        exit(1);
+    }
+
+    StreamingSampler::Settings streaming_settings;
+    streaming_settings.head_frames      = get_audio_sample_rate() / 2; // preload 0.5 seconds
+    streaming_settings.chunk_frames     = 4096;
+    streaming_settings.number_of_chunks = 16;
+
+    sampler = new StreamingSampler(streaming_settings);
+    if (!sampler->load(sketchPath() + "data/teilchen-stereo.wav")) {
+        error("could not open: " + sketchPath() + "data/teilchen-stereo.wav");
+        exit(1);
+    }
+    if (sampler->get_sample_rate() != static_cast<uint32_t>(get_audio_sample_rate())) {
+        console("sample rate of file ( ", sampler->get_sample_rate(), " ) differs from audio sample rate ( ", get_audio_sample_rate(), " )");
+    }
+    sampler->set_looping();
+    sampler->play();
+}
+
+void draw() {
+    background(0.85f);
+
+    const float size = height / 2.0f;
+    const float x    = width / 2.0f;
+    const float y    = height / 2.0f;
+
+    strokeWeight(16.0f);
+    noFill();
+    stroke(1.0f, 0.25f, 0.35f);
+    arc(x, y, size, size, -HALF_PI, TWO_PI * sampler->get_position_normalized() - HALF_PI);
+
+    fill(0);
+    debug_text("CHANNELS       : " + to_string(sampler->get_channels()), 10, 10);
+    debug_text("FRAMES         : " + to_string(sampler->get_total_frames()), 10, 25);
+    debug_text("BUFFERED CHUNKS: " + to_string(sampler->get_buffered_chunks()) + " / " + to_string(sampler->get_number_of_chunks()), 10, 40);
+    debug_text("MEMORY BUDGET  : " + nf(sampler->get_memory_budget() / 1024.0f, 1) + "KB", 10, 55);
+    debug_text("UNDERRUNS      : " + to_string(sampler->get_underruns()), 10, 70);
+}
+
+void mousePressed() {
+    sampler->seek_normalized(static_cast<float>(mouseX) / width);
+}
+
+void keyPressed() {
+    if (key == '1') {
+        sampler->rewind();
+        sampler->play();
+    }
+    if (key == '2') {
+        sampler->stop();
+    }
+}
+
+void audioEvent(const PAudio& audio) {
+    const uint32_t channels = sampler->get_channels();
+    sampler_buffer.resize(audio.buffer_size * channels); // NOTE only allocates on first call or if buffer size changes
+    sampler->process(sampler_buffer.data(), audio.buffer_size);
+    if (audio.output_channels == 2) {
+        for (int i = 0; i < audio.buffer_size; i++) {
+            const float left               = sampler_buffer[i * channels];
+            const float right              = sampler_buffer[i * channels + (channels > 1 ? 1 : 0)];
+            audio.output_buffer[i * 2 + 0] = left;
+            audio.output_buffer[i * 2 + 1] = right;
+        }
+    }
+}
+
+void shutdown() {
+    delete sampler;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "BlockADSR.h"
+
+/**
+ * a voice for `VoicePool` that plays back a shared sample buffer transposed to the note
+ * ( relative to `root_note` ) with linear interpolation and applies an ADSR envelope. the
+ * voice becomes idle once the envelope has finished or the end of the sample is reached.
+ *
+ * NOTE the voice does not own the buffer. it must stay valid while the voice is used.
+ */
+class SamplerVoice {
+public:
+    SamplerVoice(const float* buffer, const size_t length, const float sample_rate, const int root_note = 60)
+        : fBuffer(buffer),
+          fLength(length),
+          fRootNote(root_note),
+          fADSR(sample_rate) {}
+
+    BlockADSR& get_adsr() { return fADSR; }
+
+    void start(const int note, const float velocity) {
+        fSpeed     = std::pow(2.0f, static_cast<float>(note - fRootNote) / 12.0f);
+        fPosition  = 0.0;
+        fAmplitude = velocity;
+        fADSR.start();
+    }
+
+    void stop() { fADSR.stop(); }
+
+    bool is_idle() const { return fADSR.is_idle(); }
+
+    float get_level() const { return fADSR.get_level() * fAmplitude; }
+
+    void process(float* output, const size_t frames) {
+        /* playback stops one sample early so that `index + 1` is always valid */
+        const double end       = static_cast<double>(fLength > 0 ? fLength - 1 : 0);
+        const double speed     = fSpeed;
+        const float  amplitude = fAmplitude;
+        double       position  = fPosition;
+        size_t       i         = 0;
+        for (; i < frames && position < end; ++i) {
+            const auto   index    = static_cast<size_t>(position);
+            const float  fraction = static_cast<float>(position - static_cast<double>(index));
+            const float  a        = fBuffer[index];
+            const float  b        = fBuffer[index + 1];
+            output[i]             = (a + (b - a) * fraction) * amplitude;
+            position += speed;
+        }
+        fPosition = position;
+        std::fill(output + i, output + frames, 0.0f);
+        fADSR.process(output, frames);
+        if (position >= end) {
+            fADSR.reset();
+        }
+    }
+
+private:
+    const float* fBuffer;
+    size_t       fLength;
+    int          fRootNote;
+    double       fPosition{0.0};
+    double       fSpeed{1.0};
+    float        fAmplitude{1.0f};
+    BlockADSR    fADSR;
+};
@@ -0,0 +1,258 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "SPSCQueue.h"
+
+/**
+ * preallocates a fixed number of voices and assigns them to notes. all memory is allocated in
+ * the constructor; `note_on`, `note_off` and `process` never allocate.
+ *
+ * `VoiceT` must provide:
+ *
+ *     void  start(int note, float velocity);
+ *     void  stop();                                  // start release phase
+ *     bool  is_idle() const;                         // voice is silent and may be reused
+ *     float get_level() const;                       // current output level ( for stealing )
+ *     void  process(float* output, size_t frames);   // writes ( not adds ) `frames` samples
+ *
+ * if all voices are in use a voice is stolen. voices that are already released are preferred,
+ * among those ( or among all voices ) either the oldest or the quietest voice is taken. a
+ * stolen voice is faded out over `STEAL_FADE_FRAMES` frames before it starts the new note, so
+ * that cutting it off does not click.
+ *
+ * `note_on` and `note_off` must be called from the audio thread ( e.g. from a `Trigger`
+ * callback ). other threads ( e.g. MIDI callbacks ) must use `post_note_on` and
+ * `post_note_off` which pass the event through a lock-free queue that is drained at the
+ * beginning of the next `process` call. only one thread may post events.
+ *
+ * `process` renders only active voices, block by block, into a scratch buffer and sums them
+ * into the output. voices that became idle are returned to the pool afterwards.
+ */
+template<typename VoiceT>
+class VoicePool {
+public:
+    enum StealingMode {
+        STEAL_OLDEST,
+        STEAL_QUIETEST
+    };
+
+    static constexpr size_t MAX_BLOCK_SIZE    = 256;
+    static constexpr size_t STEAL_FADE_FRAMES = 64;
+
+    template<typename... Args>
+    explicit VoicePool(const size_t number_of_voices, const Args&... args) {
+        fSlots.reserve(number_of_voices);
+        for (size_t i = 0; i < number_of_voices; ++i) {
+            fSlots.push_back({VoiceT(args...), -1, 0.0f, 0, false, 0});
+        }
+        fActive.reserve(number_of_voices);
+        fFree.reserve(number_of_voices);
+        for (size_t i = number_of_voices; i > 0; --i) {
+            fFree.push_back(i - 1);
+        }
+    }
+
+    /* any thread */
+    void         set_stealing_mode(const StealingMode mode) { fStealingMode.store(mode, std::memory_order_relaxed); }
+    StealingMode get_stealing_mode() const { return fStealingMode.load(std::memory_order_relaxed); }
+
+    size_t get_number_of_voices() const { return fSlots.size(); }
+
+    /* NOTE only access voices from the audio thread or while audio is not running */
+    VoiceT& get_voice(const size_t index) { return fSlots[index].voice; }
+
+    /* any thread */
+    size_t   get_active_voices() const { return fActiveVoices.load(std::memory_order_relaxed); }
+    uint32_t get_stolen_voices() const { return fStolenVoices.load(std::memory_order_relaxed); }
+    uint32_t get_dropped_events() const { return fDroppedEvents.load(std::memory_order_relaxed); }
+
+    /* producer thread */
+    bool post_note_on(const int note, const float velocity) {
+        return post({Event::NOTE_ON, note, velocity});
+    }
+
+    /* producer thread */
+    bool post_note_off(const int note) {
+        return post({Event::NOTE_OFF, note, 0.0f});
+    }
+
+    /* audio thread */
+    void note_on(const int note, const float velocity) {
+        size_t index;
+        if (!fFree.empty()) {
+            index = fFree.back();
+            fFree.pop_back();
+            fActive.push_back(index);
+        } else if (!fActive.empty()) {
+            index = fActive[find_voice_to_steal()];
+            fStolenVoices.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            return;
+        }
+        Slot&      slot   = fSlots[index];
+        const bool stolen = !slot.voice.is_idle() || slot.fade > 0;
+        slot.note         = note;
+        slot.velocity     = velocity;
+        slot.age          = fCounter++;
+        slot.released     = false;
+        if (stolen) {
+            /* the new note starts when the fade out is complete ( see `process` ) */
+            if (slot.fade == 0) {
+                slot.fade = STEAL_FADE_FRAMES;
+            }
+        } else {
+            slot.voice.start(note, velocity);
+        }
+    }
+
+    /* audio thread. releases all voices playing `note` */
+    void note_off(const int note) {
+        for (const size_t index: fActive) {
+            Slot& slot = fSlots[index];
+            if (slot.note == note && !slot.released) {
+                slot.released = true;
+                if (slot.fade == 0) {
+                    slot.voice.stop();
+                }
+            }
+        }
+    }
+
+    /* audio thread */
+    void all_notes_off() {
+        for (const size_t index: fActive) {
+            fSlots[index].released = true;
+            if (fSlots[index].fade == 0) {
+                fSlots[index].voice.stop();
+            }
+        }
+    }
+
+    /* audio thread. writes `frames` samples of all active voices into `output` */
+    void process(float* output, size_t frames) {
+        Event event;
+        while (fEvents.pop(event)) {
+            if (event.type == Event::NOTE_ON) {
+                note_on(event.note, event.velocity);
+            } else {
+                note_off(event.note);
+            }
+        }
+
+        std::fill(output, output + frames, 0.0f);
+        while (frames > 0) {
+            const size_t block = std::min(frames, MAX_BLOCK_SIZE);
+            for (const size_t index: fActive) {
+                Slot&  slot  = fSlots[index];
+                size_t start = 0;
+                if (slot.fade > 0) {
+                    start = std::min(block, slot.fade);
+                    slot.voice.process(fScratch, start);
+                    for (size_t i = 0; i < start; ++i) {
+                        output[i] += fScratch[i] * static_cast<float>(slot.fade - i) / static_cast<float>(STEAL_FADE_FRAMES);
+                    }
+                    slot.fade -= start;
+                    if (slot.fade > 0) {
+                        continue;
+                    }
+                    start_pending_note(slot);
+                }
+                if (start < block) {
+                    slot.voice.process(fScratch, block - start);
+                    for (size_t i = start; i < block; ++i) {
+                        output[i] += fScratch[i - start];
+                    }
+                }
+            }
+            output += block;
+            frames -= block;
+        }
+
+        /* return idle voices to the pool */
+        for (size_t i = 0; i < fActive.size();) {
+            const Slot& slot = fSlots[fActive[i]];
+            if (slot.fade == 0 && slot.voice.is_idle()) {
+                fFree.push_back(fActive[i]);
+                fActive[i] = fActive.back();
+                fActive.pop_back();
+            } else {
+                ++i;
+            }
+        }
+        fActiveVoices.store(fActive.size(), std::memory_order_relaxed);
+    }
+
+private:
+    struct Slot {
+        VoiceT   voice;
+        int      note;
+        float    velocity;
+        uint64_t age;
+        bool     released;
+        size_t   fade; // frames left to fade out before `note` starts, 0 if the voice plays `note`
+    };
+
+    struct Event {
+        enum Type : uint8_t {
+            NOTE_ON,
+            NOTE_OFF
+        };
+        Type  type;
+        int   note;
+        float velocity;
+    };
+
+    std::vector<Slot>         fSlots;
+    std::vector<size_t>       fActive;
+    std::vector<size_t>       fFree;
+    SPSCQueue<Event, 256>     fEvents;
+    std::atomic<StealingMode> fStealingMode{STEAL_OLDEST};
+    uint64_t                  fCounter{0};
+    std::atomic<size_t>       fActiveVoices{0};
+    std::atomic<uint32_t>     fStolenVoices{0};
+    std::atomic<uint32_t>     fDroppedEvents{0};
+    alignas(64) float         fScratch[MAX_BLOCK_SIZE]{};
+
+    bool post(const Event& event) {
+        if (!fEvents.push(event)) {
+            fDroppedEvents.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    /* starts the note of a stolen voice after the fade out */
+    static void start_pending_note(Slot& slot) {
+        slot.voice.start(slot.note, slot.velocity);
+        if (slot.released) {
+            /* the note was released while the old note faded out */
+            slot.voice.stop();
+        }
+    }
+
+    /* returns the position in `fActive` of the voice to steal */
+    size_t find_voice_to_steal() const {
+        size_t best          = 0;
+        bool   best_released = false;
+        for (size_t i = 0; i < fActive.size(); ++i) {
+            const Slot& slot = fSlots[fActive[i]];
+            if (i == 0 || (slot.released && !best_released) ||
+                (slot.released == best_released && is_better_candidate(slot, fSlots[fActive[best]]))) {
+                best          = i;
+                best_released = slot.released;
+            }
+        }
+        return best;
+    }
+
+    bool is_better_candidate(const Slot& a, const Slot& b) const {
+        if (get_stealing_mode() == STEAL_QUIETEST) {
+            return a.voice.get_level() < b.voice.get_level();
+        }
+        return a.age < b.age;
+    }
+};
@@ -0,0 +1,146 @@
+/*
+ * this example demonstrates how to play many notes without allocating DSP objects at runtime.
+ * a `VoicePool` preallocates 16 sampler voices ( sample + ADSR ) and assigns them to notes
+ * from a MIDI keyboard and from an arpeggiator driven by a `Trigger`. if more notes are
+ * played than voices are available, voices are stolen. press `1` to toggle the arpeggiator
+ * and `2` to switch between stealing the oldest and the quietest voice.
+ */
+
+#include <atomic>
+
+#include "Umfeld.h"
+#include "MIDI.h"
+#include "audio/Sampler.h"
+#include "audio/Trigger.h"
+#include "audio/Wavetable.h"
+
+#include "VoicePool.h"
+#include "SamplerVoice.h"
+
+using namespace umfeld;
+
+static constexpr int NUMBER_OF_VOICES = 16;
+
+Sampler*                 sample_source;
+VoicePool<SamplerVoice>* voices;
+Wavetable*               lfo;
+Trigger*                 trigger;
+std::atomic<bool>        arpeggiator_enabled{true};
+int                      arpeggiator_step = 0;
+int                      arpeggiator_note = -1;
+MIDI                     midi;
+
+/* called from the MIDI thread. events are passed to the audio thread through the voice pool's queue */
+class VoiceMIDI final : public MIDIListener {
+    void note_off(int channel, int note) override { voices->post_note_off(note); }
+    void note_on(int channel, int note, int velocity) override {
+        if (velocity == 0) {
+            voices->post_note_off(note);
+        } else {
+            voices->post_note_on(note, velocity / 127.0f);
+        }
+    }
+    void midi_message(const std::vector<unsigned char>& message) override {}
+    void control_change(int channel, int control, int value) override {}
+    void program_change(int channel, int program) override {}
+    void pitch_bend(int channel, int value) override {}
+    void sys_ex(const std::vector<unsigned char>& message) override {}
+};
+
+VoiceMIDI midi_listener;
+
+void settings() {
+    size(1024, 768);
+    audio();
+}
+
+/* called from the audio thread by `trigger->process()` */
+void arpeggiator(const int event) {
+    static constexpr int NOTES[] = {48, 55, 60, 63, 67, 70, 72, 75};
+    if (event == EVENT_RISING_EDGE && arpeggiator_enabled) {
+        arpeggiator_note = NOTES[arpeggiator_step++ % 8];
+        voices->note_on(arpeggiator_note, 0.6f);
+    } else if (arpeggiator_note >= 0) {
+        voices->note_off(arpeggiator_note);
+        arpeggiator_note = -1;
+    }
+}
+
+void setup() {
+    if (get_audio_output_channels() != 2) {
+        error("this example requires a stereo output");
+        exit(1);
+    }
+
+    sample_source = loadSample("teilchen.wav");
+    voices        = new VoicePool<SamplerVoice>(NUMBER_OF_VOICES,
+                                                sample_source->get_buffer(),
+                                                sample_source->get_buffer_length(),
+                                                static_cast<float>(get_audio_sample_rate()));
+    for (size_t i = 0; i < voices->get_number_of_voices(); ++i) {
+        BlockADSR& adsr = voices->get_voice(i).get_adsr();
+        adsr.set_attack(0.005f);
+        adsr.set_decay(0.2f);
+        adsr.set_sustain(0.6f);
+        adsr.set_release(0.5f);
+    }
+
+    lfo = new Wavetable(2048, get_audio_sample_rate());
+    lfo->set_waveform(WAVEFORM_TRIANGLE);
+    lfo->set_frequency(6.0f);
+    trigger = new Trigger();
+    trigger->set_callback(arpeggiator);
+
+    midi.print_available_ports();
+    midi.open_input_port(0);
+    midi.callback(&midi_listener);
+}
+
+void draw() {
+    background(0.85f);
+
+    const float active = static_cast<float>(voices->get_active_voices()) / voices->get_number_of_voices();
+    noFill();
+    stroke(1.0f, 0.25f, 0.35f);
+    strokeWeight(16.0f);
+    arc(width / 2.0f, height / 2.0f, height / 2.0f, height / 2.0f, -HALF_PI, TWO_PI * active - HALF_PI);
+
+    fill(0);
+    debug_text("ACTIVE VOICES : " + to_string(voices->get_active_voices()) + " / " + to_string(voices->get_number_of_voices()), 10, 10);
+    debug_text("STOLEN VOICES : " + to_string(voices->get_stolen_voices()), 10, 25);
+    debug_text("DROPPED EVENTS: " + to_string(voices->get_dropped_events()), 10, 40);
+    debug_text("STEALING MODE : " + std::string(voices->get_stealing_mode() == VoicePool<SamplerVoice>::STEAL_OLDEST ? "OLDEST" : "QUIETEST"), 10, 55);
+    debug_text("ARPEGGIATOR   : " + std::string(arpeggiator_enabled ? "ON" : "OFF"), 10, 70);
+
+    lfo->set_frequency(map(mouseX, 0, width, 1.0f, 20.0f));
+}
+
+void keyPressed() {
+    if (key == '1') {
+        arpeggiator_enabled = !arpeggiator_enabled;
+    }
+    if (key == '2') {
+        voices->set_stealing_mode(voices->get_stealing_mode() == VoicePool<SamplerVoice>::STEAL_OLDEST
+                                      ? VoicePool<SamplerVoice>::STEAL_QUIETEST
+                                      : VoicePool<SamplerVoice>::STEAL_OLDEST);
+    }
+}
+
+void audioEvent(const PAudio& audio) {
+    float sample_buffer[audio.buffer_size];
+    /* NOTE arpeggiator events take effect at the beginning of the block */
+    for (int i = 0; i < audio.buffer_size; i++) {
+        trigger->process(lfo->process());
+    }
+    voices->process(sample_buffer, audio.buffer_size);
+    if (audio.output_channels == 2) {
+        merge_interleaved_stereo(sample_buffer, sample_buffer, audio.output_buffer, audio.buffer_size);
+    }
+}
+
+void shutdown() {
+    delete voices;
+    delete sample_source;
+    delete lfo;
+    delete trigger;
+}
@@ -0,0 +1,295 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define WAVETABLE_BANK_AVX2
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define WAVETABLE_BANK_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define WAVETABLE_BANK_NEON
+#endif
+
+/**
+ * renders N oscillator voices that share one wavetable and mixes them down into a single
+ * output block. voice state is stored as structure-of-arrays and processed in SIMD lanes
+ * ( 8 lanes with AVX2, 4 lanes with SSE2 or NEON, 4 scalar lanes otherwise ). table lookup
+ * is linearly interpolated. frequency and amplitude changes are smoothed per sample with a
+ * one-pole filter so that parameter changes from `draw()` do not click.
+ *
+ * NOTE AVX2 is only used if the compiler targets it ( e.g. `-mavx2` or `-march=native` ).
+ */
+class WavetableBank {
+public:
+    enum Waveform {
+        SINE,
+        TRIANGLE,
+        SAWTOOTH,
+        SQUARE
+    };
+
+#if defined(WAVETABLE_BANK_AVX2)
+    static constexpr size_t LANES = 8;
+#else
+    static constexpr size_t LANES = 4;
+#endif
+    static constexpr size_t MAX_BLOCK_SIZE = 1024;
+
+    WavetableBank(const size_t number_of_voices, const size_t table_size, const float sample_rate)
+        : fNumberOfVoices(number_of_voices),
+          fNumberOfGroups((number_of_voices + LANES - 1) / LANES),
+          fTableSize(table_size),
+          fSampleRate(sample_rate),
+          fTable(table_size + 1, 0.0f),
+          fPhase(fNumberOfGroups * LANES, 0.0f),
+          fIncrement(fNumberOfGroups * LANES, 0.0f),
+          fIncrementTarget(fNumberOfGroups * LANES, 0.0f),
+          fAmplitude(fNumberOfGroups * LANES, 0.0f),
+          fAmplitudeTarget(fNumberOfGroups * LANES, 0.0f),
+          fMix(MAX_BLOCK_SIZE * LANES, 0.0f) {
+        set_waveform(SINE);
+        set_smoothing(0.005f);
+    }
+
+    size_t get_number_of_voices() const { return fNumberOfVoices; }
+
+    void set_waveform(const Waveform waveform) {
+        for (size_t i = 0; i < fTableSize; ++i) {
+            const float r = static_cast<float>(i) / static_cast<float>(fTableSize);
+            switch (waveform) {
+                case SINE:
+                    fTable[i] = std::sin(r * 2.0f * static_cast<float>(M_PI));
+                    break;
+                case TRIANGLE:
+                    fTable[i] = r < 0.25f ? r * 4.0f : (r < 0.75f ? 2.0f - r * 4.0f : r * 4.0f - 4.0f);
+                    break;
+                case SAWTOOTH:
+                    fTable[i] = r * 2.0f - 1.0f;
+                    break;
+                case SQUARE:
+                    fTable[i] = r < 0.5f ? 1.0f : -1.0f;
+                    break;
+            }
+        }
+        fTable[fTableSize] = fTable[0];
+    }
+
+    /* direct access to the shared table. call `update_table()` after writing to it */
+    float* get_table() { return fTable.data(); }
+
+    void update_table() { fTable[fTableSize] = fTable[0]; }
+
+    /* time in seconds after which a parameter change has reached ~63% of its target */
+    void set_smoothing(const float seconds) {
+        fSmoothing = seconds > 0.0f ? 1.0f - std::exp(-1.0f / (seconds * fSampleRate)) : 1.0f;
+    }
+
+    /* NOTE frequency is clamped to [0, sample_rate / 2] */
+    void set_frequency(const size_t voice, const float frequency) {
+        if (voice < fNumberOfVoices) {
+            fIncrementTarget[voice] = std::clamp(frequency, 0.0f, fSampleRate * 0.5f) * static_cast<float>(fTableSize) / fSampleRate;
+        }
+    }
+
+    float get_frequency(const size_t voice) const {
+        return voice < fNumberOfVoices ? fIncrementTarget[voice] * fSampleRate / static_cast<float>(fTableSize) : 0.0f;
+    }
+
+    void set_amplitude(const size_t voice, const float amplitude) {
+        if (voice < fNumberOfVoices) {
+            fAmplitudeTarget[voice] = amplitude;
+        }
+    }
+
+    float get_amplitude(const size_t voice) const {
+        return voice < fNumberOfVoices ? fAmplitudeTarget[voice] : 0.0f;
+    }
+
+    /* jumps to the target values without smoothing e.g after initializing all voices */
+    void reset_smoothing() {
+        fIncrement = fIncrementTarget;
+        fAmplitude = fAmplitudeTarget;
+    }
+
+    /* renders all voices and writes their sum into `output` */
+    void process(float* output, size_t frames) {
+        while (frames > 0) {
+            const size_t block = std::min(frames, MAX_BLOCK_SIZE);
+            process_block(output, block);
+            output += block;
+            frames -= block;
+        }
+    }
+
+private:
+    const size_t       fNumberOfVoices;
+    const size_t       fNumberOfGroups;
+    const size_t       fTableSize;
+    const float        fSampleRate;
+    std::vector<float> fTable;
+    std::vector<float> fPhase;
+    std::vector<float> fIncrement;
+    std::vector<float> fIncrementTarget;
+    std::vector<float> fAmplitude;
+    std::vector<float> fAmplitudeTarget;
+    std::vector<float> fMix;
+    float              fSmoothing{1.0f};
+
+#if defined(WAVETABLE_BANK_AVX2)
+    using lane_t = __m256;
+
+    static lane_t lane_load(const float* p) { return _mm256_loadu_ps(p); }
+    static void   lane_store(float* p, const lane_t v) { _mm256_storeu_ps(p, v); }
+    static lane_t lane_set(const float v) { return _mm256_set1_ps(v); }
+    static lane_t lane_add(const lane_t a, const lane_t b) { return _mm256_add_ps(a, b); }
+    static lane_t lane_sub(const lane_t a, const lane_t b) { return _mm256_sub_ps(a, b); }
+    static lane_t lane_mul(const lane_t a, const lane_t b) { return _mm256_mul_ps(a, b); }
+    /* subtracts `size` from every lane that is greater than or equal to `size` */
+    static lane_t lane_wrap(const lane_t a, const lane_t size) {
+        return _mm256_sub_ps(a, _mm256_and_ps(_mm256_cmp_ps(a, size, _CMP_GE_OQ), size));
+    }
+    /* returns interpolated table values at the positions in `phase` */
+    static lane_t lane_lookup(const float* table, const lane_t phase) {
+        const __m256i index    = _mm256_cvttps_epi32(phase);
+        const lane_t  fraction = _mm256_sub_ps(phase, _mm256_cvtepi32_ps(index));
+        const lane_t  a        = _mm256_i32gather_ps(table, index, 4);
+        const lane_t  b        = _mm256_i32gather_ps(table + 1, index, 4);
+        return _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), fraction));
+    }
+#elif defined(WAVETABLE_BANK_SSE2)
+    using lane_t = __m128;
+
+    static lane_t lane_load(const float* p) { return _mm_loadu_ps(p); }
+    static void   lane_store(float* p, const lane_t v) { _mm_storeu_ps(p, v); }
+    static lane_t lane_set(const float v) { return _mm_set1_ps(v); }
+    static lane_t lane_add(const lane_t a, const lane_t b) { return _mm_add_ps(a, b); }
+    static lane_t lane_sub(const lane_t a, const lane_t b) { return _mm_sub_ps(a, b); }
+    static lane_t lane_mul(const lane_t a, const lane_t b) { return _mm_mul_ps(a, b); }
+    static lane_t lane_wrap(const lane_t a, const lane_t size) {
+        return _mm_sub_ps(a, _mm_and_ps(_mm_cmpge_ps(a, size), size));
+    }
+    static lane_t lane_lookup(const float* table, const lane_t phase) {
+        const __m128i index = _mm_cvttps_epi32(phase);
+        alignas(16) int32_t i[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(i), index);
+        const lane_t fraction = _mm_sub_ps(phase, _mm_cvtepi32_ps(index));
+        const lane_t a        = _mm_setr_ps(table[i[0]], table[i[1]], table[i[2]], table[i[3]]);
+        const lane_t b        = _mm_setr_ps(table[i[0] + 1], table[i[1] + 1], table[i[2] + 1], table[i[3] + 1]);
+        return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), fraction));
+    }
+#elif defined(WAVETABLE_BANK_NEON)
+    using lane_t = float32x4_t;
+
+    static lane_t lane_load(const float* p) { return vld1q_f32(p); }
+    static void   lane_store(float* p, const lane_t v) { vst1q_f32(p, v); }
+    static lane_t lane_set(const float v) { return vdupq_n_f32(v); }
+    static lane_t lane_add(const lane_t a, const lane_t b) { return vaddq_f32(a, b); }
+    static lane_t lane_sub(const lane_t a, const lane_t b) { return vsubq_f32(a, b); }
+    static lane_t lane_mul(const lane_t a, const lane_t b) { return vmulq_f32(a, b); }
+    static lane_t lane_wrap(const lane_t a, const lane_t size) {
+        const uint32x4_t mask = vcgeq_f32(a, size);
+        return vsubq_f32(a, vreinterpretq_f32_u32(vandq_u32(mask, vreinterpretq_u32_f32(size))));
+    }
+    static lane_t lane_lookup(const float* table, const lane_t phase) {
+        const int32x4_t index = vcvtq_s32_f32(phase);
+        int32_t         i[4];
+        vst1q_s32(i, index);
+        const lane_t fraction = vsubq_f32(phase, vcvtq_f32_s32(index));
+        const float  a_[4]    = {table[i[0]], table[i[1]], table[i[2]], table[i[3]]};
+        const float  b_[4]    = {table[i[0] + 1], table[i[1] + 1], table[i[2] + 1], table[i[3] + 1]};
+        const lane_t a        = vld1q_f32(a_);
+        const lane_t b        = vld1q_f32(b_);
+        return vaddq_f32(a, vmulq_f32(vsubq_f32(b, a), fraction));
+    }
+#else
+    struct lane_t {
+        float v[LANES];
+    };
+
+    static lane_t lane_load(const float* p) {
+        lane_t r;
+        std::copy(p, p + LANES, r.v);
+        return r;
+    }
+    static void   lane_store(float* p, const lane_t& a) { std::copy(a.v, a.v + LANES, p); }
+    static lane_t lane_set(const float v) {
+        lane_t r;
+        std::fill(r.v, r.v + LANES, v);
+        return r;
+    }
+    static lane_t lane_add(const lane_t& a, const lane_t& b) {
+        lane_t r;
+        for (size_t i = 0; i < LANES; ++i) { r.v[i] = a.v[i] + b.v[i]; }
+        return r;
+    }
+    static lane_t lane_sub(const lane_t& a, const lane_t& b) {
+        lane_t r;
+        for (size_t i = 0; i < LANES; ++i) { r.v[i] = a.v[i] - b.v[i]; }
+        return r;
+    }
+    static lane_t lane_mul(const lane_t& a, const lane_t& b) {
+        lane_t r;
+        for (size_t i = 0; i < LANES; ++i) { r.v[i] = a.v[i] * b.v[i]; }
+        return r;
+    }
+    static lane_t lane_wrap(const lane_t& a, const lane_t& size) {
+        lane_t r;
+        for (size_t i = 0; i < LANES; ++i) { r.v[i] = a.v[i] >= size.v[i] ? a.v[i] - size.v[i] : a.v[i]; }
+        return r;
+    }
+    static lane_t lane_lookup(const float* table, const lane_t& phase) {
+        lane_t r;
+        for (size_t i = 0; i < LANES; ++i) {
+            const auto  index    = static_cast<size_t>(phase.v[i]);
+            const float fraction = phase.v[i] - static_cast<float>(index);
+            r.v[i]               = table[index] + (table[index + 1] - table[index]) * fraction;
+        }
+        return r;
+    }
+#endif
+
+    void process_block(float* output, const size_t frames) {
+        std::fill(fMix.begin(), fMix.begin() + frames * LANES, 0.0f);
+
+        const float* table     = fTable.data();
+        float*       mix       = fMix.data();
+        const lane_t size      = lane_set(static_cast<float>(fTableSize));
+        const lane_t smoothing = lane_set(fSmoothing);
+
+        /* every group of voices keeps its state in registers for the whole block */
+        for (size_t g = 0; g < fNumberOfGroups; ++g) {
+            const size_t offset           = g * LANES;
+            lane_t       phase            = lane_load(&fPhase[offset]);
+            lane_t       increment        = lane_load(&fIncrement[offset]);
+            lane_t       amplitude        = lane_load(&fAmplitude[offset]);
+            const lane_t increment_target = lane_load(&fIncrementTarget[offset]);
+            const lane_t amplitude_target = lane_load(&fAmplitudeTarget[offset]);
+            for (size_t i = 0; i < frames; ++i) {
+                const lane_t sample = lane_mul(lane_lookup(table, phase), amplitude);
+                lane_store(mix + i * LANES, lane_add(lane_load(mix + i * LANES), sample));
+                increment = lane_add(increment, lane_mul(lane_sub(increment_target, increment), smoothing));
+                amplitude = lane_add(amplitude, lane_mul(lane_sub(amplitude_target, amplitude), smoothing));
+                phase     = lane_wrap(lane_add(phase, increment), size);
+            }
+            lane_store(&fPhase[offset], phase);
+            lane_store(&fIncrement[offset], increment);
+            lane_store(&fAmplitude[offset], amplitude);
+        }
+
+        /* sum lanes into mono output */
+        for (size_t i = 0; i < frames; ++i) {
+            float sum = 0.0f;
+            for (size_t l = 0; l < LANES; ++l) {
+                sum += mix[i * LANES + l];
+            }
+            output[i] = sum;
+        }
+    }
+};
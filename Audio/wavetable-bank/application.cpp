@@ -0,0 +1,154 @@
+/*
+ * this example demonstrates how to render a large number of oscillators with `WavetableBank`.
+ * all voices share one wavetable and are rendered in SIMD lanes. the mouse controls the
+ * fundamental frequency ( x ) and the spectral slope ( y ) of 256 harmonic partials. press
+ * `b` to run a benchmark that compares the bank with separate `Wavetable` instances.
+ */
+
+#include <chrono>
+#include <cstdio>
+
+#include "Umfeld.h"
+#include "audio/AudioUtilities.h"
+#include "audio/Wavetable.h"
+
+#include "WavetableBank.h"
+
+using namespace umfeld;
+
+static constexpr size_t NUMBER_OF_PARTIALS = 256;
+
+WavetableBank*           bank;
+std::vector<std::string> benchmark_results;
+
+void settings() {
+    size(1024, 768);
+    audio();
+}
+
+void update_partials(const float fundamental, const float slope) {
+    const float nyquist = get_audio_sample_rate() * 0.5f;
+    float       sum     = 0.0f;
+    for (size_t i = 0; i < bank->get_number_of_voices(); ++i) {
+        const float harmonic = static_cast<float>(i + 1);
+        sum += fundamental * harmonic < nyquist ? 1.0f / std::pow(harmonic, slope) : 0.0f;
+    }
+    for (size_t i = 0; i < bank->get_number_of_voices(); ++i) {
+        const float harmonic  = static_cast<float>(i + 1);
+        const float frequency = fundamental * harmonic;
+        /* mute partials above nyquist and normalize the sum of all amplitudes */
+        bank->set_frequency(i, frequency);
+        bank->set_amplitude(i, frequency < nyquist ? 0.5f / (std::pow(harmonic, slope) * sum) : 0.0f);
+    }
+}
+
+void run_benchmark() {
+    static constexpr size_t NUMBER_OF_VOICES[] = {16, 64, 256, 512};
+    static constexpr size_t BLOCK_SIZE         = 512;
+    static constexpr size_t BLOCKS             = 200;
+
+    const float sample_rate = get_audio_sample_rate();
+    float       buffer[BLOCK_SIZE];
+
+    benchmark_results.clear();
+    for (const size_t voices: NUMBER_OF_VOICES) {
+        std::vector<Wavetable*> wavetables;
+        for (size_t i = 0; i < voices; ++i) {
+            auto* w = new Wavetable(1024, sample_rate);
+            w->set_waveform(WAVEFORM_SINE);
+            w->set_frequency(55.0f * (i + 1));
+            w->set_amplitude(1.0f / voices);
+            wavetables.push_back(w);
+        }
+        WavetableBank wavetable_bank(voices, 1024, sample_rate);
+        for (size_t i = 0; i < voices; ++i) {
+            wavetable_bank.set_frequency(i, 55.0f * (i + 1));
+            wavetable_bank.set_amplitude(i, 1.0f / voices);
+        }
+        wavetable_bank.reset_smoothing();
+
+        const auto wavetable_start = std::chrono::high_resolution_clock::now();
+        for (size_t b = 0; b < BLOCKS; ++b) {
+            for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+                float sample = 0.0f;
+                for (auto* w: wavetables) {
+                    sample += w->process();
+                }
+                buffer[i] = sample;
+            }
+        }
+        const auto wavetable_end = std::chrono::high_resolution_clock::now();
+
+        const auto bank_start = std::chrono::high_resolution_clock::now();
+        for (size_t b = 0; b < BLOCKS; ++b) {
+            wavetable_bank.process(buffer, BLOCK_SIZE);
+        }
+        const auto bank_end = std::chrono::high_resolution_clock::now();
+
+        const double wavetable_us = std::chrono::duration<double, std::micro>(wavetable_end - wavetable_start).count() / BLOCKS;
+        const double bank_us      = std::chrono::duration<double, std::micro>(bank_end - bank_start).count() / BLOCKS;
+        char         result[160];
+        snprintf(result, sizeof(result), "VOICES %3zu : WAVETABLE %9.2fus / BANK %9.2fus per %zu frames ( x%.2f, %zu lanes )",
+                 voices, wavetable_us, bank_us, BLOCK_SIZE, wavetable_us / bank_us, WavetableBank::LANES);
+        benchmark_results.emplace_back(result);
+        console(benchmark_results.back());
+
+        for (const auto* w: wavetables) {
+            delete w;
+        }
+    }
+}
+
+void setup() {
+    if (get_audio_output_channels() != 2) {
+        error("this example requires a stereo output");
+        exit(1);
+    }
+
+    bank = new WavetableBank(NUMBER_OF_PARTIALS, 2048, get_audio_sample_rate());
+    bank->set_waveform(WavetableBank::SINE);
+    update_partials(55.0f, 1.0f);
+    bank->reset_smoothing();
+
+    run_benchmark();
+}
+
+void draw() {
+    background(0.85f);
+
+    // NOTE setters are not thread-safe. this is fine as long as `run_audio_in_thread` is not set
+    const float fundamental = map(mouseX, 0, width, 27.5f, 220.0f);
+    const float slope       = map(mouseY, 0, height, 0.5f, 2.0f);
+    update_partials(fundamental, slope);
+
+    noStroke();
+    fill(1.0f, 0.25f, 0.35f);
+    const float bar_width = static_cast<float>(width) / NUMBER_OF_PARTIALS;
+    for (size_t i = 0; i < NUMBER_OF_PARTIALS; ++i) {
+        const float h = bank->get_amplitude(i) * 2.0f * height;
+        rect(i * bar_width, height - h, bar_width, h);
+    }
+
+    fill(0);
+    for (size_t i = 0; i < benchmark_results.size(); ++i) {
+        debug_text(benchmark_results[i], 10, 10 + i * 15);
+    }
+}
+
+void keyPressed() {
+    if (key == 'b') {
+        run_benchmark();
+    }
+}
+
+void audioEvent(const PAudio& audio) {
+    float sample_buffer[audio.buffer_size];
+    bank->process(sample_buffer, audio.buffer_size);
+    if (audio.output_channels == 2) {
+        merge_interleaved_stereo(sample_buffer, sample_buffer, audio.output_buffer, audio.buffer_size);
+    }
+}
+
+void shutdown() {
+    delete bank;
+}
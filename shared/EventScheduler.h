@@ -0,0 +1,182 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "SPSCQueue.h"
+
+/**
+ * schedules events of type `T` at exact sample positions inside the audio blocks.
+ *
+ * events are posted from other threads ( e.g. keyboard, `draw()` or MIDI callbacks ) through
+ * a `Producer`. every producer owns a lock-free single-producer/single-consumer queue, i.e.
+ * each thread that posts events needs its own producer ( created in `setup()` ). events are
+ * either
+ *
+ * - *timestamped* ( `post()` ): the current time is recorded and the event is placed at the
+ *   same relative position in the next block. this delays events by one block but keeps
+ *   their timing free of block size jitter.
+ * - *scheduled* ( `post_at_frame()` ): the event is placed at an absolute frame position of
+ *   the audio clock ( see `get_frame_position()` ), e.g. for sequencers. events that arrive
+ *   too late are placed at the start of the next block and counted as late.
+ *
+ * the audio thread calls `begin_block()`, then `next_event()` until it returns false, and
+ * renders the samples between the returned offsets:
+ *
+ *     scheduler.begin_block(frames);
+ *     size_t position = 0, offset;
+ *     T      event;
+ *     while (scheduler.next_event(event, offset)) {
+ *         render(position, offset);
+ *         handle(event);
+ *         position = offset;
+ *     }
+ *     render(position, frames);
+ *
+ * all memory is allocated in the constructor and `add_producer()`.
+ */
+template<typename T, size_t CAPACITY = 256>
+class EventScheduler {
+    struct TimedEvent {
+        T        event{};
+        int64_t  time_ns{0};  // timestamped events
+        uint64_t frame{0};    // scheduled events
+        bool     scheduled{false};
+    };
+
+public:
+    class Producer {
+    public:
+        /* places `event` at the current time, i.e. in the next block */
+        bool post(const T& event) {
+            TimedEvent timed;
+            timed.event   = event;
+            timed.time_ns = now_ns();
+            return push(timed);
+        }
+
+        /* places `event` at the absolute frame position `frame` */
+        bool post_at_frame(const T& event, const uint64_t frame) {
+            TimedEvent timed;
+            timed.event     = event;
+            timed.frame     = frame;
+            timed.scheduled = true;
+            return push(timed);
+        }
+
+    private:
+        friend class EventScheduler;
+        SPSCQueue<TimedEvent, CAPACITY> fQueue;
+        std::atomic<uint64_t>*          fDropped{nullptr};
+
+        bool push(const TimedEvent& timed) {
+            if (!fQueue.push(timed)) {
+                fDropped->fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            return true;
+        }
+    };
+
+    explicit EventScheduler(const float sample_rate) : fSampleRate(sample_rate) {
+        fPending.reserve(CAPACITY);
+        fBlock.reserve(CAPACITY);
+    }
+
+    EventScheduler(const EventScheduler&)            = delete;
+    EventScheduler& operator=(const EventScheduler&) = delete;
+
+    /* NOTE create all producers before the audio thread calls `begin_block()` for the first time */
+    Producer& add_producer() {
+        fProducers.push_back(std::make_unique<Producer>());
+        fProducers.back()->fDropped = &fDropped;
+        return *fProducers.back();
+    }
+
+    /* any thread. frame position of the start of the current block */
+    uint64_t get_frame_position() const { return fFramePosition.load(std::memory_order_relaxed); }
+
+    float get_sample_rate() const { return fSampleRate; }
+
+    uint64_t get_dropped_events() const { return fDropped.load(std::memory_order_relaxed); }
+
+    uint64_t get_late_events() const { return fLate.load(std::memory_order_relaxed); }
+
+    /* audio thread. collects all events that fall into the next `frames` frames */
+    void begin_block(const size_t frames) {
+        /* advance the clock by the previous block */
+        const uint64_t block_start = fFramePosition.load(std::memory_order_relaxed) + fPreviousFrames;
+        fFramePosition.store(block_start, std::memory_order_relaxed);
+        fPreviousFrames = frames;
+
+        const int64_t block_time    = now_ns();
+        const int64_t interval      = fPreviousBlockTime > 0 ? block_time - fPreviousBlockTime : 0;
+        const double  frames_per_ns = fSampleRate * 1.0e-9;
+        fPreviousBlockTime          = block_time;
+
+        TimedEvent timed;
+        for (auto& producer: fProducers) {
+            while (producer->fQueue.pop(timed)) {
+                if (!timed.scheduled) {
+                    /* events that arrived during the last interval keep their relative position */
+                    const int64_t age    = std::clamp<int64_t>(block_time - timed.time_ns, 0, interval);
+                    const auto    offset = static_cast<uint64_t>(static_cast<double>(interval - age) * frames_per_ns);
+                    timed.frame          = block_start + std::min<uint64_t>(offset, frames > 0 ? frames - 1 : 0);
+                } else if (timed.frame < block_start) {
+                    timed.frame = block_start;
+                    fLate.fetch_add(1, std::memory_order_relaxed);
+                }
+                if (fPending.size() == CAPACITY) {
+                    fDropped.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+                /* keep pending events sorted by frame, events at the same frame in order of arrival */
+                const auto position = std::upper_bound(fPending.begin(), fPending.end(), timed,
+                                                       [](const TimedEvent& a, const TimedEvent& b) { return a.frame < b.frame; });
+                fPending.insert(position, timed);
+            }
+        }
+
+        /* move the events of this block to the front */
+        fBlock.clear();
+        size_t count = 0;
+        while (count < fPending.size() && fPending[count].frame < block_start + frames) {
+            fBlock.push_back(fPending[count]);
+            ++count;
+        }
+        fPending.erase(fPending.begin(), fPending.begin() + static_cast<std::ptrdiff_t>(count));
+        fBlockIndex = 0;
+    }
+
+    /* audio thread. returns the next event of the current block and its frame offset inside the block */
+    bool next_event(T& event, size_t& offset) {
+        if (fBlockIndex >= fBlock.size()) {
+            return false;
+        }
+        const TimedEvent& timed = fBlock[fBlockIndex++];
+        event                   = timed.event;
+        offset                  = static_cast<size_t>(timed.frame - fFramePosition.load(std::memory_order_relaxed));
+        return true;
+    }
+
+private:
+    const float                            fSampleRate;
+    std::vector<std::unique_ptr<Producer>> fProducers;
+    std::vector<TimedEvent>                fPending; // sorted by frame, capacity reserved
+    std::vector<TimedEvent>                fBlock;
+    size_t                                 fBlockIndex{0};
+    size_t                                 fPreviousFrames{0};
+    int64_t                                fPreviousBlockTime{0};
+    std::atomic<uint64_t>                  fFramePosition{0};
+    std::atomic<uint64_t>                  fDropped{0};
+    std::atomic<uint64_t>                  fLate{0};
+
+    static int64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+};
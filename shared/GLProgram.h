@@ -0,0 +1,144 @@
+#pragma once
+
+#include <string>
+#include <utility>
+
+#include "Umfeld.h"
+#include "PGraphics.h"
+
+/**
+ * shader program for classes that draw their own vertex arrays with `glDraw*()` and
+ * therefore need the raw program handle instead of a `PShader`.
+ *
+ * the program is compiled and linked with the first call to `init()`. if this fails the
+ * error is reported once and the program is not compiled again, every later `init()` just
+ * returns false. `bind()` uses the program and sets the `mat4` uniform `u_view_projection`
+ * to the current transformation of the sketch ( projection * view * model ).
+ *
+ * `VERTEX_COLOR_FRAGMENT_SHADER` outputs the color `v_color` of the vertex shader unchanged.
+ *
+ * NOTE all functions must be called with the OpenGL context of the sketch.
+ */
+class GLProgram {
+public:
+    static constexpr const char* VERTEX_COLOR_FRAGMENT_SHADER = R"(#version 330 core
+in vec4 v_color;
+out vec4 frag_color;
+void main() {
+    frag_color = v_color;
+})";
+
+    /* `name` is used in error messages */
+    GLProgram(std::string name, std::string vertex_shader, std::string fragment_shader = VERTEX_COLOR_FRAGMENT_SHADER)
+        : fName(std::move(name)),
+          fVertexShader(std::move(vertex_shader)),
+          fFragmentShader(std::move(fragment_shader)) {}
+
+    ~GLProgram() {
+        if (fProgram != 0) {
+            glDeleteProgram(fProgram);
+        }
+    }
+
+    GLProgram(const GLProgram&)            = delete;
+    GLProgram& operator=(const GLProgram&) = delete;
+
+    /* compiles and links the program once. returns false if this failed, now or in an earlier call */
+    bool init() {
+        if (fProgram != 0) {
+            return true;
+        }
+        if (fFailed) {
+            return false;
+        }
+        const GLuint vertex_shader   = compile_shader(GL_VERTEX_SHADER, fVertexShader);
+        const GLuint fragment_shader = compile_shader(GL_FRAGMENT_SHADER, fFragmentShader);
+        if (vertex_shader != 0 && fragment_shader != 0) {
+            fProgram = glCreateProgram();
+            glAttachShader(fProgram, vertex_shader);
+            glAttachShader(fProgram, fragment_shader);
+            glLinkProgram(fProgram);
+            GLint linked = 0;
+            glGetProgramiv(fProgram, GL_LINK_STATUS, &linked);
+            if (!linked) {
+                char log[512];
+                glGetProgramInfoLog(fProgram, sizeof(log), nullptr, log);
+                umfeld::error("could not link " + fName + " shader: " + std::string(log));
+                glDeleteProgram(fProgram);
+                fProgram = 0;
+            }
+        }
+        glDeleteShader(vertex_shader);
+        glDeleteShader(fragment_shader);
+        if (fProgram == 0) {
+            fFailed = true;
+            return false;
+        }
+        fViewProjectionLocation = glGetUniformLocation(fProgram, "u_view_projection");
+        return true;
+    }
+
+    /* uses the program and sets `u_view_projection`. NOTE `init()` must have succeeded */
+    void bind() const {
+        const glm::mat4 view_projection = umfeld::g->projection_matrix * umfeld::g->view_matrix * umfeld::g->model_matrix;
+        glUseProgram(fProgram);
+        glUniformMatrix4fv(fViewProjectionLocation, 1, GL_FALSE, &view_projection[0][0]);
+    }
+
+    GLuint id() const { return fProgram; }
+
+    bool has_failed() const { return fFailed; }
+
+private:
+    const std::string fName;
+    const std::string fVertexShader;
+    const std::string fFragmentShader;
+    GLuint            fProgram{0};
+    GLint             fViewProjectionLocation{-1};
+    bool              fFailed{false};
+
+    GLuint compile_shader(const GLenum type, const std::string& source) const {
+        const GLuint shader = glCreateShader(type);
+        const char*  text   = source.c_str();
+        glShaderSource(shader, 1, &text, nullptr);
+        glCompileShader(shader);
+        GLint compiled = 0;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+        if (!compiled) {
+            char log[512];
+            glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+            umfeld::error("could not compile " + fName + " shader: " + std::string(log));
+            glDeleteShader(shader);
+            return 0;
+        }
+        return shader;
+    }
+};
+
+/**
+ * saves the current program, vertex array and array buffer binding and restores them when it
+ * goes out of scope, so that drawing with an own program does not change the state the
+ * renderer of the sketch relies on.
+ */
+class GLStateGuard {
+public:
+    GLStateGuard() {
+        glGetIntegerv(GL_CURRENT_PROGRAM, &fProgram);
+        glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &fVertexArray);
+        glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &fArrayBuffer);
+    }
+
+    ~GLStateGuard() {
+        glBindVertexArray(static_cast<GLuint>(fVertexArray));
+        glBindBuffer(GL_ARRAY_BUFFER, static_cast<GLuint>(fArrayBuffer));
+        glUseProgram(static_cast<GLuint>(fProgram));
+    }
+
+    GLStateGuard(const GLStateGuard&)            = delete;
+    GLStateGuard& operator=(const GLStateGuard&) = delete;
+
+private:
+    GLint fProgram{0};
+    GLint fVertexArray{0};
+    GLint fArrayBuffer{0};
+};
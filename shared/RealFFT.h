@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/**
+ * FFT for real signals. a signal of `size` samples is transformed with a complex FFT of half
+ * the size and a post-processing step. spectra are stored split into real and imaginary parts
+ * with `size / 2 + 1` bins from DC to nyquist.
+ *
+ * `inverse(forward(x))` returns `x` scaled by `size / 2`, i.e. callers that multiply spectra
+ * ( e.g. a convolution ) can fold the normalization into one of the operands.
+ *
+ * all tables and work buffers are allocated in the constructor.
+ *
+ * NOTE `size` must be a power of two and at least 4.
+ */
+class RealFFT {
+public:
+    explicit RealFFT(const size_t size)
+        : fSize(size),
+          fHalf(size / 2),
+          fCos(size / 2),
+          fSin(size / 2),
+          fBitReversed(size / 2),
+          fReal(size / 2),
+          fImag(size / 2) {
+        /* twiddle factors of the full size transform. the half size transform uses every second one */
+        for (size_t i = 0; i < fHalf; ++i) {
+            const double phase = -2.0 * M_PI * static_cast<double>(i) / static_cast<double>(fSize);
+            fCos[i]            = static_cast<float>(std::cos(phase));
+            fSin[i]            = static_cast<float>(std::sin(phase));
+        }
+
+        size_t bits = 0;
+        while ((size_t{1} << bits) < fHalf) {
+            ++bits;
+        }
+        for (size_t i = 0; i < fHalf; ++i) {
+            size_t r = 0;
+            for (size_t b = 0; b < bits; ++b) {
+                r |= ((i >> b) & 1) << (bits - 1 - b);
+            }
+            fBitReversed[i] = r;
+        }
+    }
+
+    size_t get_size() const { return fSize; }
+
+    size_t get_number_of_bins() const { return fHalf + 1; }
+
+    /* transforms `size` samples into `size / 2 + 1` bins */
+    void forward(const float* input, float* real, float* imag) {
+        /* pack even samples into the real and odd samples into the imaginary part */
+        for (size_t i = 0; i < fHalf; ++i) {
+            const size_t j = fBitReversed[i];
+            fReal[j]       = input[2 * i];
+            fImag[j]       = input[2 * i + 1];
+        }
+        transform(false);
+
+        real[0]     = fReal[0] + fImag[0];
+        imag[0]     = 0.0f;
+        real[fHalf] = fReal[0] - fImag[0];
+        imag[fHalf] = 0.0f;
+        for (size_t k = 1; k < fHalf; ++k) {
+            const float ar = fReal[k];
+            const float ai = fImag[k];
+            const float br = fReal[fHalf - k];
+            const float bi = -fImag[fHalf - k];
+            /* even part ( a + b ) / 2, odd part ( a - b ) / 2i rotated by the twiddle factor */
+            const float even_re = 0.5f * (ar + br);
+            const float even_im = 0.5f * (ai + bi);
+            const float odd_re  = 0.5f * (ai - bi);
+            const float odd_im  = -0.5f * (ar - br);
+            real[k]             = even_re + odd_re * fCos[k] - odd_im * fSin[k];
+            imag[k]             = even_im + odd_re * fSin[k] + odd_im * fCos[k];
+        }
+    }
+
+    /* transforms `size / 2 + 1` bins into `size` samples scaled by `size / 2` */
+    void inverse(const float* real, const float* imag, float* output) {
+        for (size_t k = 0; k < fHalf; ++k) {
+            const float ar = real[k];
+            const float ai = imag[k];
+            const float br = real[fHalf - k];
+            const float bi = -imag[fHalf - k];
+            const float even_re = ar + br;
+            const float even_im = ai + bi;
+            /* odd part rotated back by the conjugate twiddle factor */
+            const float  dr     = ar - br;
+            const float  di     = ai - bi;
+            const float  odd_re = dr * fCos[k] + di * fSin[k];
+            const float  odd_im = di * fCos[k] - dr * fSin[k];
+            const size_t j      = fBitReversed[k];
+            fReal[j]            = 0.5f * (even_re - odd_im);
+            fImag[j]            = 0.5f * (even_im + odd_re);
+        }
+        transform(true);
+
+        for (size_t i = 0; i < fHalf; ++i) {
+            output[2 * i]     = fReal[i];
+            output[2 * i + 1] = fImag[i];
+        }
+    }
+
+private:
+    const size_t        fSize;
+    const size_t        fHalf;
+    std::vector<float>  fCos;
+    std::vector<float>  fSin;
+    std::vector<size_t> fBitReversed;
+    std::vector<float>  fReal;
+    std::vector<float>  fImag;
+
+    /* in-place iterative radix-2 FFT of size `size / 2` on bit reversed input */
+    void transform(const bool inverse) {
+        float*      re   = fReal.data();
+        float*      im   = fImag.data();
+        const float sign = inverse ? -1.0f : 1.0f;
+        for (size_t length = 2; length <= fHalf; length <<= 1) {
+            const size_t half   = length / 2;
+            const size_t stride = fSize / length;
+            for (size_t start = 0; start < fHalf; start += length) {
+                for (size_t k = 0; k < half; ++k) {
+                    const float  wr = fCos[k * stride];
+                    const float  wi = sign * fSin[k * stride];
+                    const size_t a  = start + k;
+                    const size_t b  = a + half;
+                    const float  tr = re[b] * wr - im[b] * wi;
+                    const float  ti = re[b] * wi + im[b] * wr;
+                    re[b]           = re[a] - tr;
+                    im[b]           = im[a] - ti;
+                    re[a] += tr;
+                    im[a] += ti;
+                }
+            }
+        }
+    }
+};
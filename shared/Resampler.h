@@ -0,0 +1,253 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/**
+ * polyphase windowed-sinc resampler for arbitrary, time-varying ratios. the filter is a
+ * kaiser windowed sinc that is tabulated at `phases` fractional positions between two input
+ * samples. for positions in between two tabulated phases the coefficients are linearly
+ * interpolated.
+ *
+ * quality tiers trade filter length ( taps ), table resolution and stopband attenuation for
+ * speed:
+ *
+ *     LOW    :  8 taps,   64 phases
+ *     MEDIUM : 16 taps,  256 phases
+ *     HIGH   : 32 taps, 1024 phases
+ *
+ * when upsampling ( ratio >= 1 ) each output sample is a dot product of `taps` contiguous
+ * input samples and one interpolated table row. the dot product uses 8 independent
+ * accumulators so that the compiler can vectorize it. when downsampling the kernel is
+ * stretched by `1 / ratio` to lower its cutoff below the output nyquist frequency, which
+ * needs proportionally more taps and a per tap table lookup.
+ *
+ * `process()` is streaming: it pulls as much input as it needs from a callback and can be
+ * called per block with a different ratio each time. all memory is allocated in the
+ * constructor, `process()` never allocates.
+ */
+class Resampler {
+public:
+    enum Quality {
+        LOW,
+        MEDIUM,
+        HIGH
+    };
+
+    /* lowest supported ratio ( 4x downsampling ) */
+    static constexpr double MIN_RATIO   = 0.25;
+    static constexpr size_t INPUT_BLOCK = 1024;
+
+    explicit Resampler(const Quality quality = MEDIUM) {
+        float beta;
+        float cutoff;
+        switch (quality) {
+            case LOW:
+                fTaps   = 8;
+                fPhases = 64;
+                beta    = 5.0f;
+                cutoff  = 0.8f;
+                break;
+            case MEDIUM:
+                fTaps   = 16;
+                fPhases = 256;
+                beta    = 7.0f;
+                cutoff  = 0.88f;
+                break;
+            case HIGH:
+            default:
+                fTaps   = 32;
+                fPhases = 1024;
+                beta    = 9.0f;
+                cutoff  = 0.93f;
+                break;
+        }
+        fHalf = fTaps / 2;
+        build_table(cutoff, beta);
+
+        /* enough history for the widest ( most stretched ) kernel plus one input block */
+        fMaxHalfSpan = static_cast<size_t>(std::ceil(fHalf / MIN_RATIO)) + 1;
+        fBuffer.resize(2 * fMaxHalfSpan + INPUT_BLOCK);
+        reset();
+    }
+
+    /* ratio of output rate to input rate, e.g. 2.0 doubles the number of samples */
+    void set_ratio(const double ratio) {
+        fRatio = std::max(ratio, MIN_RATIO);
+        fStep  = 1.0 / fRatio;
+    }
+
+    void set_rates(const double input_rate, const double output_rate) { set_ratio(output_rate / input_rate); }
+
+    double get_ratio() const { return fRatio; }
+
+    size_t get_taps() const { return fTaps; }
+
+    size_t get_phases() const { return fPhases; }
+
+    /* number of input frames the resampler reads ahead of the current output position */
+    size_t get_latency() const { return fRatio >= 1.0 ? fHalf : static_cast<size_t>(std::ceil(fHalf / fRatio)); }
+
+    /* clears the history. the next output sample is aligned with the next input sample */
+    void reset() {
+        std::fill(fBuffer.begin(), fBuffer.end(), 0.0f);
+        fFill = fMaxHalfSpan;
+        fTime = static_cast<double>(fMaxHalfSpan);
+    }
+
+    /**
+     * writes `frames` output samples. `read_input(float* buffer, size_t frames)` is called
+     * whenever more input is needed and must write exactly `frames` samples ( e.g. silence at
+     * the end of a sample ).
+     */
+    template<typename ReadInput>
+    void process(float* output, const size_t frames, ReadInput&& read_input) {
+        if (fRatio >= 1.0) {
+            for (size_t i = 0; i < frames; ++i) {
+                const auto base = prepare(fHalf, read_input);
+                output[i]       = interpolate(base);
+                fTime += fStep;
+            }
+        } else {
+            const auto half_span = static_cast<size_t>(std::ceil(fHalf / fRatio));
+            for (size_t i = 0; i < frames; ++i) {
+                const auto base = prepare(half_span, read_input);
+                output[i]       = interpolate_stretched(base, half_span);
+                fTime += fStep;
+            }
+        }
+    }
+
+    /* resamples a complete buffer from `input_rate` to `output_rate`. NOTE allocates */
+    static std::vector<float> resample(const float* input, const size_t length, const double input_rate, const double output_rate, const Quality quality = HIGH) {
+        Resampler resampler(quality);
+        resampler.set_rates(input_rate, output_rate);
+        std::vector<float> output(static_cast<size_t>(std::ceil(length * resampler.get_ratio())));
+        size_t             read = 0;
+        resampler.process(output.data(), output.size(), [&](float* buffer, const size_t frames) {
+            const size_t n = std::min(frames, length - read);
+            std::copy_n(input + read, n, buffer);
+            std::fill(buffer + n, buffer + frames, 0.0f);
+            read += n;
+        });
+        return output;
+    }
+
+private:
+    static constexpr size_t LANES = 8;
+
+    size_t             fTaps{0};
+    size_t             fHalf{0};
+    size_t             fPhases{0};
+    size_t             fMaxHalfSpan{0};
+    std::vector<float> fTable;
+    std::vector<float> fBuffer;
+    size_t             fFill{0};
+    double             fTime{0.0};
+    double             fRatio{1.0};
+    double             fStep{1.0};
+
+    static double bessel_i0(const double x) {
+        double sum  = 1.0;
+        double term = 1.0;
+        for (int k = 1; k < 32; ++k) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    }
+
+    /*
+     * row `p` holds the coefficients for an output position `p / phases` after an input
+     * sample; tap `j` is the input sample at distance `j - ( half - 1 ) - p / phases`. there
+     * are `phases + 1` rows so that row `p + 1` can always be used for interpolation.
+     */
+    void build_table(const float cutoff, const float beta) {
+        fTable.resize((fPhases + 1) * fTaps);
+        const double i0_beta = bessel_i0(beta);
+        for (size_t p = 0; p <= fPhases; ++p) {
+            float* row = fTable.data() + p * fTaps;
+            double sum = 0.0;
+            for (size_t j = 0; j < fTaps; ++j) {
+                const double x      = static_cast<double>(j) - static_cast<double>(fHalf - 1) - static_cast<double>(p) / fPhases;
+                const double u      = x / fHalf;
+                const double window = std::abs(u) < 1.0 ? bessel_i0(beta * std::sqrt(1.0 - u * u)) / i0_beta : 0.0;
+                const double t      = M_PI * cutoff * x;
+                const double sinc   = std::abs(t) < 1e-9 ? 1.0 : std::sin(t) / t;
+                row[j]              = static_cast<float>(cutoff * sinc * window);
+                sum += row[j];
+            }
+            /* normalize every phase to unity gain at DC */
+            for (size_t j = 0; j < fTaps; ++j) {
+                row[j] = static_cast<float>(row[j] / sum);
+            }
+        }
+    }
+
+    /* makes sure the input samples up to `floor(time) + half_span` are buffered and returns `floor(time)` */
+    template<typename ReadInput>
+    size_t prepare(const size_t half_span, ReadInput& read_input) {
+        auto base = static_cast<size_t>(fTime);
+        while (base + half_span >= fFill) {
+            if (fFill + INPUT_BLOCK > fBuffer.size()) {
+                /* discard input that is no longer needed */
+                const size_t discard = base - fMaxHalfSpan;
+                std::copy(fBuffer.begin() + static_cast<std::ptrdiff_t>(discard), fBuffer.begin() + static_cast<std::ptrdiff_t>(fFill), fBuffer.begin());
+                fFill -= discard;
+                fTime -= static_cast<double>(discard);
+                base -= discard;
+            }
+            read_input(fBuffer.data() + fFill, INPUT_BLOCK);
+            fFill += INPUT_BLOCK;
+        }
+        return base;
+    }
+
+    float interpolate(const size_t base) const {
+        const double fraction = (fTime - static_cast<double>(base)) * static_cast<double>(fPhases);
+        const auto   phase    = static_cast<size_t>(fraction);
+        const auto   weight   = static_cast<float>(fraction - static_cast<double>(phase));
+        const float* c0       = fTable.data() + phase * fTaps;
+        const float* c1       = c0 + fTaps;
+        const float* x        = fBuffer.data() + base - (fHalf - 1);
+
+        float accumulator[LANES]{};
+        for (size_t j = 0; j < fTaps; j += LANES) {
+            for (size_t l = 0; l < LANES; ++l) {
+                const float c = c0[j + l] + weight * (c1[j + l] - c0[j + l]);
+                accumulator[l] += x[j + l] * c;
+            }
+        }
+        float sum = 0.0f;
+        for (const float a: accumulator) {
+            sum += a;
+        }
+        return sum;
+    }
+
+    float interpolate_stretched(const size_t base, const size_t half_span) const {
+        /* position of the first input sample in the unstretched kernel, advancing by `ratio` per input sample */
+        const size_t first = base + 1 - half_span;
+        const double ratio = fRatio;
+        const double last  = static_cast<double>(fTaps - 1);
+        const auto   P     = static_cast<double>(fPhases);
+        double       z     = (static_cast<double>(first) - fTime) * ratio + static_cast<double>(fHalf - 1);
+        float        sum   = 0.0f;
+        for (size_t i = first; i <= base + half_span; ++i, z += ratio) {
+            if (z <= -1.0 || z > last) {
+                continue;
+            }
+            /* table column `j = ceil( z )` and row `( j - z ) * phases`. `z + 1 > 0` so truncation equals floor */
+            const auto j        = static_cast<size_t>(z + 1.0);
+            const auto column   = static_cast<double>(j) - z >= 1.0 ? j - 1 : j;
+            const auto fraction = (static_cast<double>(column) - z) * P;
+            const auto phase    = std::min(static_cast<size_t>(fraction), fPhases - 1);
+            const auto weight   = static_cast<float>(fraction - static_cast<double>(phase));
+            const float* c      = fTable.data() + phase * fTaps + column;
+            sum += fBuffer[i] * (c[0] + weight * (c[fTaps] - c[0]));
+        }
+        return sum * static_cast<float>(ratio);
+    }
+};
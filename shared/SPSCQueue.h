@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * bounded single-producer/single-consumer queue. `push` and `pop` never block and never
+ * allocate, which makes the queue safe to use on the audio thread. exactly one thread may
+ * push and exactly one ( other ) thread may pop.
+ *
+ * NOTE `CAPACITY` must be a power of two. one slot is kept free to tell full from empty.
+ */
+template<typename T, size_t CAPACITY>
+class SPSCQueue {
+    static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+
+public:
+    /* producer side. returns false if the queue is full */
+    bool push(const T& value) {
+        const size_t head = fHead.load(std::memory_order_relaxed);
+        const size_t next = (head + 1) & MASK;
+        if (next == fTail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        fBuffer[head] = value;
+        fHead.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /* consumer side. returns false if the queue is empty */
+    bool pop(T& value) {
+        const size_t tail = fTail.load(std::memory_order_relaxed);
+        if (tail == fHead.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = fBuffer[tail];
+        fTail.store((tail + 1) & MASK, std::memory_order_release);
+        return true;
+    }
+
+    /* consumer side. returns a pointer to the next element without removing it or nullptr if the queue is empty */
+    const T* peek() const {
+        const size_t tail = fTail.load(std::memory_order_relaxed);
+        if (tail == fHead.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &fBuffer[tail];
+    }
+
+    /* approximate number of elements. exact only when called from producer or consumer while the other side is idle */
+    size_t size() const {
+        return (fHead.load(std::memory_order_acquire) - fTail.load(std::memory_order_acquire)) & MASK;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    static constexpr size_t capacity() { return CAPACITY - 1; }
+
+private:
+    static constexpr size_t MASK = CAPACITY - 1;
+
+    alignas(64) std::atomic<size_t> fHead{0};
+    alignas(64) std::atomic<size_t> fTail{0};
+    alignas(64) T fBuffer[CAPACITY]{};
+};
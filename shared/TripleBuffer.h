@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * lock-free triple buffer for passing the latest block of data from one writer thread to one
+ * reader thread. the writer fills the back buffer and publishes it, the reader acquires the
+ * most recently published buffer. neither side ever waits and the reader never sees a
+ * partially written buffer. intermediate buffers are dropped if the writer is faster than the
+ * reader, which is what a display wants.
+ */
+template<typename T>
+class TripleBuffer {
+public:
+    explicit TripleBuffer(const size_t size, const T& initial_value = T{}) {
+        for (auto& b: fBuffers) {
+            b.assign(size, initial_value);
+        }
+    }
+
+    size_t size() const { return fBuffers[0].size(); }
+
+    /* writer side. buffer to fill before calling `publish()` */
+    T* write_buffer() { return fBuffers[fBack].data(); }
+
+    /* writer side. makes the write buffer available to the reader */
+    void publish() {
+        const uint32_t previous = fMiddle.exchange(fBack | FRESH_BIT, std::memory_order_acq_rel);
+        fBack                   = previous & INDEX_MASK;
+    }
+
+    /* reader side. switches to the latest published buffer if there is one. returns true if the data changed */
+    bool acquire() {
+        if ((fMiddle.load(std::memory_order_relaxed) & FRESH_BIT) == 0) {
+            return false;
+        }
+        const uint32_t previous = fMiddle.exchange(fFront, std::memory_order_acq_rel);
+        fFront                  = previous & INDEX_MASK;
+        return true;
+    }
+
+    /* reader side. buffer returned by the last `acquire()`. valid until the next `acquire()` */
+    const T* read_buffer() const { return fBuffers[fFront].data(); }
+
+private:
+    static constexpr uint32_t FRESH_BIT  = 0x4;
+    static constexpr uint32_t INDEX_MASK = 0x3;
+
+    std::vector<T>        fBuffers[3];
+    uint32_t              fBack{0};
+    std::atomic<uint32_t> fMiddle{1};
+    uint32_t              fFront{2};
+};
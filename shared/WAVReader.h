@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * minimal WAV file reader that decodes frames on demand instead of loading the whole file.
+ * supports 16, 24 and 32 bit integer PCM as well as 32 bit float ( including
+ * WAVE_FORMAT_EXTENSIBLE ). samples are converted to interleaved float.
+ */
+class WAVReader {
+public:
+    /* opens `path` and reads its header. a file that is still open is closed first */
+    bool open(const std::string& path) {
+        close();
+        fFile.open(path, std::ios::binary);
+        if (!fFile.good()) {
+            return false;
+        }
+        char riff[12];
+        if (!read_bytes(riff, 12) || std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0) {
+            return false;
+        }
+        bool has_format = false;
+        char chunk_header[8];
+        while (read_bytes(chunk_header, 8)) {
+            const uint32_t chunk_size = read_u32(chunk_header + 4);
+            if (std::memcmp(chunk_header, "fmt ", 4) == 0) {
+                std::vector<char> format(chunk_size);
+                if (chunk_size < 16 || !read_bytes(format.data(), chunk_size)) {
+                    return false;
+                }
+                uint16_t format_tag = read_u16(&format[0]);
+                fChannels           = read_u16(&format[2]);
+                fSampleRate         = read_u32(&format[4]);
+                fBitsPerSample      = read_u16(&format[14]);
+                if (format_tag == FORMAT_EXTENSIBLE && chunk_size >= 26) {
+                    format_tag = read_u16(&format[24]);
+                }
+                fIsFloat   = format_tag == FORMAT_FLOAT;
+                has_format = format_tag == FORMAT_PCM || fIsFloat;
+                if (chunk_size & 1) {
+                    fFile.seekg(1, std::ios::cur);
+                }
+            } else if (std::memcmp(chunk_header, "data", 4) == 0) {
+                if (!has_format || fChannels == 0 || (fBitsPerSample != 16 && fBitsPerSample != 24 && fBitsPerSample != 32)) {
+                    return false;
+                }
+                fDataOffset  = static_cast<uint64_t>(fFile.tellg());
+                fFrameSize   = fChannels * (fBitsPerSample / 8);
+                fTotalFrames = chunk_size / fFrameSize;
+                fPosition    = 0;
+                return true;
+            } else {
+                fFile.seekg(chunk_size + (chunk_size & 1), std::ios::cur);
+            }
+        }
+        return false;
+    }
+
+    void close() {
+        if (fFile.is_open()) {
+            fFile.close();
+        }
+        fFile.clear();
+        fChannels      = 0;
+        fSampleRate    = 0;
+        fBitsPerSample = 0;
+        fFrameSize     = 0;
+        fIsFloat       = false;
+        fDataOffset    = 0;
+        fTotalFrames   = 0;
+        fPosition      = 0;
+    }
+
+    bool is_open() const { return fFrameSize > 0; }
+
+    uint32_t get_channels() const { return fChannels; }
+
+    uint32_t get_sample_rate() const { return fSampleRate; }
+
+    uint64_t get_total_frames() const { return fTotalFrames; }
+
+    uint64_t get_position() const { return fPosition; }
+
+    void seek(const uint64_t frame) {
+        fPosition = frame < fTotalFrames ? frame : fTotalFrames;
+        fFile.clear();
+        fFile.seekg(static_cast<std::streamoff>(fDataOffset + fPosition * fFrameSize));
+    }
+
+    /* reads up to `frames` frames as interleaved float into `output` and returns the number of frames read */
+    size_t read(float* output, size_t frames) {
+        if (!is_open()) {
+            return 0;
+        }
+        if (fPosition + frames > fTotalFrames) {
+            frames = static_cast<size_t>(fTotalFrames - fPosition);
+        }
+        fRaw.resize(frames * fFrameSize);
+        if (frames == 0 || !read_bytes(fRaw.data(), fRaw.size())) {
+            return 0;
+        }
+        const size_t samples = frames * fChannels;
+        const char*  raw     = fRaw.data();
+        for (size_t i = 0; i < samples; ++i) {
+            switch (fBitsPerSample) {
+                case 16:
+                    output[i] = static_cast<float>(static_cast<int16_t>(read_u16(raw + i * 2))) / 32768.0f;
+                    break;
+                case 24: {
+                    const auto* b = reinterpret_cast<const uint8_t*>(raw + i * 3);
+                    const auto  v = static_cast<int32_t>(static_cast<uint32_t>(b[0]) << 8 | static_cast<uint32_t>(b[1]) << 16 | static_cast<uint32_t>(b[2]) << 24);
+                    output[i]     = static_cast<float>(v >> 8) / 8388608.0f;
+                    break;
+                }
+                case 32:
+                    if (fIsFloat) {
+                        std::memcpy(&output[i], raw + i * 4, 4);
+                    } else {
+                        output[i] = static_cast<float>(static_cast<int32_t>(read_u32(raw + i * 4))) / 2147483648.0f;
+                    }
+                    break;
+                default:
+                    output[i] = 0.0f;
+            }
+        }
+        fPosition += frames;
+        return frames;
+    }
+
+private:
+    static constexpr uint16_t FORMAT_PCM        = 0x0001;
+    static constexpr uint16_t FORMAT_FLOAT      = 0x0003;
+    static constexpr uint16_t FORMAT_EXTENSIBLE = 0xFFFE;
+
+    std::ifstream     fFile;
+    std::vector<char> fRaw;
+    uint32_t          fChannels{0};
+    uint32_t          fSampleRate{0};
+    uint32_t          fBitsPerSample{0};
+    uint32_t          fFrameSize{0};
+    bool              fIsFloat{false};
+    uint64_t          fDataOffset{0};
+    uint64_t          fTotalFrames{0};
+    uint64_t          fPosition{0};
+
+    bool read_bytes(char* buffer, const size_t size) {
+        fFile.read(buffer, static_cast<std::streamsize>(size));
+        return static_cast<size_t>(fFile.gcount()) == size;
+    }
+
+    static uint16_t read_u16(const char* p) {
+        const auto* b = reinterpret_cast<const uint8_t*>(p);
+        return static_cast<uint16_t>(b[0] | b[1] << 8);
+    }
+
+    static uint32_t read_u32(const char* p) {
+        const auto* b = reinterpret_cast<const uint8_t*>(p);
+        return static_cast<uint32_t>(b[0]) | static_cast<uint32_t>(b[1]) << 8 | static_cast<uint32_t>(b[2]) << 16 | static_cast<uint32_t>(b[3]) << 24;
+    }
+};
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * WAV file writer for interleaved float samples that is suitable for very long recordings.
+ * samples are stored as 32 bit float or as 24 or 16 bit integer PCM.
+ *
+ * a standard RIFF/WAVE file can not hold more than 4GB of audio ( e.g. ~3.1 hours of 8
+ * channels at 48kHz and 24 bit ). the header therefore reserves space for a `ds64` chunk in
+ * a `JUNK` chunk. if the data grows beyond 4GB the file is turned into an RF64 file ( EBU
+ * Tech 3306 ) when the header is updated, otherwise it stays a plain WAV file.
+ *
+ * files with more than 2 channels or more than 16 bit use a `WAVE_FORMAT_EXTENSIBLE` format
+ * chunk with the default speaker layout for 1 to 8 channels ( e.g. 5.1 for 6 channels ) as
+ * channel mask, so that other applications do not guess the layout.
+ *
+ * the sizes in the header are written by `update_header()` and `close()`. calling
+ * `update_header()` every now and then keeps the file readable if the application crashes.
+ */
+class WAVWriter {
+public:
+    enum Format {
+        FLOAT32,
+        INT24,
+        INT16
+    };
+
+    ~WAVWriter() { close(); }
+
+    bool open(const std::string& path, const uint32_t channels, const uint32_t sample_rate, const Format format = FLOAT32) {
+        close();
+        fFile = std::fopen(path.c_str(), "wb");
+        if (fFile == nullptr) {
+            return false;
+        }
+        fChannels      = channels;
+        fFormat        = format;
+        fFrames        = 0;
+        fBytesPerFrame = channels * bytes_per_sample(format);
+
+        const uint16_t bits_per_sample = static_cast<uint16_t>(bytes_per_sample(format) * 8);
+        const bool     extensible      = channels > 2 || bits_per_sample > 16;
+        const uint16_t format_tag      = format == FLOAT32 ? FORMAT_FLOAT : FORMAT_PCM;
+        /* PCM without extension: 16 bytes, other formats add `cbSize` and the extension */
+        const uint32_t format_size = extensible ? 40 : (format == FLOAT32 ? 18 : 16);
+        fHeaderSize                = 12 + 8 + DS64_SIZE + 8 + format_size + 8;
+        write_bytes("RIFF", 4);
+        write_u32(0); // patched in `update_header()`
+        write_bytes("WAVE", 4);
+        write_bytes("JUNK", 4); // replaced by `ds64` if the file becomes an RF64 file
+        write_u32(DS64_SIZE);
+        for (uint32_t i = 0; i < DS64_SIZE; ++i) {
+            std::fputc(0, fFile);
+        }
+        write_bytes("fmt ", 4);
+        write_u32(format_size);
+        write_u16(extensible ? FORMAT_EXTENSIBLE : format_tag);
+        write_u16(static_cast<uint16_t>(channels));
+        write_u32(sample_rate);
+        write_u32(sample_rate * fBytesPerFrame);
+        write_u16(static_cast<uint16_t>(fBytesPerFrame));
+        write_u16(bits_per_sample);
+        if (extensible) {
+            write_u16(22); // cbSize
+            write_u16(bits_per_sample); // valid bits per sample
+            write_u32(channel_mask(channels));
+            /* sub format GUID: format tag followed by the fixed part 00000000-0010-8000-00AA00389B71 */
+            static constexpr uint8_t GUID[14] = {0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71};
+            write_u16(format_tag);
+            std::fwrite(GUID, 1, sizeof(GUID), fFile);
+        } else if (format == FLOAT32) {
+            write_u16(0); // cbSize
+        }
+        write_bytes("data", 4);
+        write_u32(0); // patched in `update_header()`
+        return std::ferror(fFile) == 0;
+    }
+
+    bool is_open() const { return fFile != nullptr; }
+
+    uint64_t get_frames_written() const { return fFrames; }
+
+    uint64_t get_bytes_written() const { return fHeaderSize + fFrames * fBytesPerFrame; }
+
+    /* writes `frames` interleaved frames */
+    bool write(const float* samples, const size_t frames) {
+        if (fFile == nullptr) {
+            return false;
+        }
+        const size_t count = frames * fChannels;
+        size_t       written;
+        if (fFormat == FLOAT32) {
+            written = std::fwrite(samples, sizeof(float), count, fFile);
+        } else if (fFormat == INT24) {
+            fConversion.resize(count * 3);
+            for (size_t i = 0; i < count; ++i) {
+                const auto value       = static_cast<int32_t>(clamp(samples[i]) * 8388607.0f);
+                fConversion[i * 3 + 0] = static_cast<uint8_t>(value);
+                fConversion[i * 3 + 1] = static_cast<uint8_t>(value >> 8);
+                fConversion[i * 3 + 2] = static_cast<uint8_t>(value >> 16);
+            }
+            written = std::fwrite(fConversion.data(), 3, count, fFile);
+        } else {
+            fConversion.resize(count * 2);
+            for (size_t i = 0; i < count; ++i) {
+                const auto value       = static_cast<int16_t>(clamp(samples[i]) * 32767.0f);
+                fConversion[i * 2 + 0] = static_cast<uint8_t>(value);
+                fConversion[i * 2 + 1] = static_cast<uint8_t>(value >> 8);
+            }
+            written = std::fwrite(fConversion.data(), 2, count, fFile);
+        }
+        fFrames += written / fChannels;
+        return written == count;
+    }
+
+    /* writes the current sizes into the header and flushes the file */
+    bool update_header() {
+        if (fFile == nullptr) {
+            return false;
+        }
+        const uint64_t data_size = fFrames * fBytesPerFrame;
+        const uint64_t riff_size = fHeaderSize - 8 + data_size;
+        if (riff_size > UINT32_MAX) {
+            std::fseek(fFile, 0, SEEK_SET);
+            write_bytes("RF64", 4);
+            write_u32(UINT32_MAX);
+            std::fseek(fFile, 12, SEEK_SET);
+            write_bytes("ds64", 4);
+            write_u32(DS64_SIZE);
+            write_u64(riff_size);
+            write_u64(data_size);
+            write_u64(fFrames);
+            write_u32(0); // no table entries
+            std::fseek(fFile, static_cast<long>(fHeaderSize - 4), SEEK_SET);
+            write_u32(UINT32_MAX);
+        } else {
+            std::fseek(fFile, 4, SEEK_SET);
+            write_u32(static_cast<uint32_t>(riff_size));
+            std::fseek(fFile, static_cast<long>(fHeaderSize - 4), SEEK_SET);
+            write_u32(static_cast<uint32_t>(data_size));
+        }
+        std::fseek(fFile, 0, SEEK_END);
+        return std::fflush(fFile) == 0;
+    }
+
+    void close() {
+        if (fFile == nullptr) {
+            return;
+        }
+        update_header();
+        std::fclose(fFile);
+        fFile = nullptr;
+    }
+
+private:
+    static constexpr uint16_t FORMAT_PCM        = 0x0001;
+    static constexpr uint16_t FORMAT_FLOAT      = 0x0003;
+    static constexpr uint16_t FORMAT_EXTENSIBLE = 0xFFFE;
+    static constexpr uint32_t DS64_SIZE         = 28;
+
+    FILE*                fFile{nullptr};
+    uint64_t             fHeaderSize{0};
+    uint32_t             fChannels{0};
+    uint32_t             fBytesPerFrame{0};
+    Format               fFormat{FLOAT32};
+    uint64_t             fFrames{0};
+    std::vector<uint8_t> fConversion;
+
+    /* default speaker layouts: mono, stereo, 3.0, quad, 5.0, 5.1, 6.1 and 7.1. other channel counts are not assigned to speakers */
+    static uint32_t channel_mask(const uint32_t channels) {
+        static constexpr uint32_t MASKS[] = {0x4, 0x3, 0x7, 0x33, 0x37, 0x3F, 0x70F, 0x63F};
+        return channels >= 1 && channels <= 8 ? MASKS[channels - 1] : 0;
+    }
+
+    static uint32_t bytes_per_sample(const Format format) { return format == FLOAT32 ? 4 : (format == INT24 ? 3 : 2); }
+
+    static float clamp(const float sample) { return sample < -1.0f ? -1.0f : (sample > 1.0f ? 1.0f : sample); }
+
+    void write_bytes(const char* bytes, const size_t size) { std::fwrite(bytes, 1, size, fFile); }
+
+    void write_u16(const uint16_t value) {
+        const uint8_t bytes[2] = {static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8)};
+        std::fwrite(bytes, 1, 2, fFile);
+    }
+
+    void write_u32(const uint32_t value) {
+        const uint8_t bytes[4] = {static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value >> 16), static_cast<uint8_t>(value >> 24)};
+        std::fwrite(bytes, 1, 4, fFile);
+    }
+
+    void write_u64(const uint64_t value) {
+        write_u32(static_cast<uint32_t>(value));
+        write_u32(static_cast<uint32_t>(value >> 32));
+    }
+};